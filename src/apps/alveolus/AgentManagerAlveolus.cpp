@@ -10,6 +10,7 @@
 #include "AgentManagerAlveolus.h"
 
 void AgentManagerAlveolus::removeFungalCellFromList(int id, double current_time) {
+    const auto lock = site->lockSharedStructures();
 
     for (size_t i = 0; i < activeFungalCells.size(); i++) {
         if (activeFungalCells.at(i)->getId() == id) {
@@ -25,6 +26,7 @@ void AgentManagerAlveolus::removeFungalCellFromList(int id, double current_time)
 }
 
 void AgentManagerAlveolus::addGerminatedFungalCellToList(Agent *fungus, double current_time) {
+    const auto lock = site->lockSharedStructures();
     activeFungalCells.emplace_back(fungus);
     for (size_t i=0; i<fungalCellRemoveIDs.size(); i++) {
         if (fungalCellRemoveIDs[i] == fungus->getId()){
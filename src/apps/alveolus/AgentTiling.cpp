@@ -0,0 +1,74 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#include <algorithm>
+#include <cmath>
+
+#include "AgentTiling.h"
+#include "core/simulation/Agent.h"
+#include "core/simulation/morphology/Morphology.h"
+#include "core/simulation/morphology/SphereRepresentation.h"
+
+AgentTiling::AgentTiling(double tile_size, Coordinate3D lower_limits, Coordinate3D upper_limits)
+        : tile_size_(tile_size), lower_limits_(lower_limits) {
+    const Coordinate3D extent = upper_limits - lower_limits;
+    number_of_tiles_ = {std::max(1, static_cast<int>(std::ceil(extent.x / tile_size_))),
+                        std::max(1, static_cast<int>(std::ceil(extent.y / tile_size_))),
+                        std::max(1, static_cast<int>(std::ceil(extent.z / tile_size_)))};
+    occupied_tile_of_tile_.assign(number_of_tiles_[0] * number_of_tiles_[1] * number_of_tiles_[2], -1);
+}
+
+std::array<int, 3> AgentTiling::getTileIndex(const Coordinate3D &position) const {
+    const std::array<double, 3> relative{position.x - lower_limits_.x, position.y - lower_limits_.y,
+                                         position.z - lower_limits_.z};
+    std::array<int, 3> index{};
+    for (int d = 0; d < 3; ++d) {
+        index[d] = std::clamp(static_cast<int>(std::floor(relative[d] / tile_size_)), 0, number_of_tiles_[d] - 1);
+    }
+    return index;
+}
+
+void AgentTiling::assignAgents(const std::vector<std::shared_ptr<Agent>> &agents,
+                               const std::vector<unsigned int> &order) {
+    for (auto tile: tile_of_occupied_tile_) {
+        occupied_tile_of_tile_[tile] = -1;
+    }
+    tile_of_occupied_tile_.clear();
+    occupied_tiles_.clear();
+    for (auto &tiles: tiles_of_colour_) {
+        tiles.clear();
+    }
+    spanning_agents_.clear();
+
+    for (auto agent_idx: order) {
+        const auto &agent = agents[agent_idx];
+        if (agent == nullptr || agent->isDeleted()) continue;
+
+        const auto &spheres = agent->getMorphology()->getAllSpheresOfThis();
+        const auto index = getTileIndex(spheres.empty() ? agent->getPosition() : spheres.front()->getPosition());
+        const bool is_spanning = std::any_of(spheres.begin(), spheres.end(), [&](const auto &sphere) {
+            return getTileIndex(sphere->getPosition()) != index;
+        });
+        if (is_spanning) {
+            spanning_agents_.push_back(agent_idx);
+            continue;
+        }
+
+        const auto tile = (index[0] * number_of_tiles_[1] + index[1]) * number_of_tiles_[2] + index[2];
+        if (occupied_tile_of_tile_[tile] < 0) {
+            occupied_tile_of_tile_[tile] = static_cast<int>(occupied_tiles_.size());
+            tile_of_occupied_tile_.push_back(tile);
+            occupied_tiles_.emplace_back();
+            const auto colour = (index[0] & 1) | (index[1] & 1) << 1 | (index[2] & 1) << 2;
+            tiles_of_colour_[colour].push_back(occupied_tiles_.size() - 1);
+        }
+        occupied_tiles_[occupied_tile_of_tile_[tile]].push_back(agent_idx);
+    }
+}
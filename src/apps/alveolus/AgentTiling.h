@@ -0,0 +1,59 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#ifndef COREABM_AGENTTILING_H
+#define COREABM_AGENTTILING_H
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "core/basic/Coordinate3D.h"
+
+class Agent;
+
+class AgentTiling {
+public:
+    // Class for the partition of a site into cubic tiles for parallel agent updates. Tiles are coloured by the parity
+    // of their indices (8 colours), tiles of one colour are at least one tile edge apart. Agents in tiles of one colour
+    // do not interact if the edge is at least twice the interaction range, i.e. they can be updated concurrently.
+    static constexpr unsigned int number_of_colours = 8;
+
+    AgentTiling(double tile_size, Coordinate3D lower_limits, Coordinate3D upper_limits);
+
+    /*!
+     * Assigns the agents to the tiles that contain all of their spheres, the agents of a tile keep the given order
+     * @param agents Vector of all agents of the site (deleted agents are skipped)
+     * @param order Vector of indices into agents that defines the order of the updates
+     */
+    void assignAgents(const std::vector<std::shared_ptr<Agent>> &agents, const std::vector<unsigned int> &order);
+
+    [[nodiscard]] double getTileSize() const { return tile_size_; };
+    /// Occupied tiles in order of their first agent, agents of a tile are given as indices into the agents
+    [[nodiscard]] const std::vector<std::vector<unsigned int>> &getOccupiedTiles() const { return occupied_tiles_; };
+    /// Indices of the occupied tiles of a colour
+    [[nodiscard]] const std::vector<unsigned int> &getTilesOfColour(unsigned int colour) const { return tiles_of_colour_[colour]; };
+    /// Agents with spheres in several tiles (e.g. hyphae), they are updated serially
+    [[nodiscard]] const std::vector<unsigned int> &getSpanningAgents() const { return spanning_agents_; };
+
+private:
+    [[nodiscard]] std::array<int, 3> getTileIndex(const Coordinate3D &position) const;
+
+    double tile_size_{};
+    Coordinate3D lower_limits_{};
+    std::array<int, 3> number_of_tiles_{};
+    std::vector<int> occupied_tile_of_tile_{};
+    std::vector<unsigned int> tile_of_occupied_tile_{};
+    std::vector<std::vector<unsigned int>> occupied_tiles_{};
+    std::array<std::vector<unsigned int>, number_of_colours> tiles_of_colour_{};
+    std::vector<unsigned int> spanning_agents_{};
+};
+
+#endif //COREABM_AGENTTILING_H
@@ -11,14 +11,17 @@
 #include "AlveoleSite.h"
 
 #include <utility>
+#include <omp.h>
 #include "core/simulation/neighbourhood/BalloonListNHLocator.h"
 #include "io_utils_alveolus.h"
 #include "CellFactoryAlveolus.h"
 #include "apps/alveolus/InSituMeasurementsAlveolus.h"
 #include "apps/alveolus/particles/ParticleManager.h"
 #include "apps/alveolus/AgentManagerAlveolus.h"
+#include "apps/alveolus/cells/ImmuneCellMacrophage.h"
 #include "core/simulation/Interactions.h"
 #include "core/simulation/boundary-condition/AbsorbingBoundaries.h"
+#include "core/utils/RunArena.h"
 #include "external/json.hpp"
 
 using json = nlohmann::json;
@@ -60,6 +63,9 @@ AlveoleSite::AlveoleSite(Randomizer* random_generator,
     setStoppingCondition(parameters_.stopping_criteria);
 
     auto* alveolus_parameters = static_cast<abm::utilAlveolus::AlveolusSiteParameter*>(parameters_.site_parameters.get());
+    if (alveolus_parameters->particle_manager_parameters.particle_mesh_cache_dir.empty()) {
+        alveolus_parameters->particle_manager_parameters.particle_mesh_cache_dir = output_path;
+    }
     setBoundaryCondition();
     identifier_ = alveolus_parameters->identifier;
     centerOfSite = alveolus_parameters->site_center;
@@ -99,6 +105,14 @@ AlveoleSite::AlveoleSite(Randomizer* random_generator,
     // Initialize particles and basic variables
     particle_manager_ = std::make_unique<ParticleManager>(alveolus_parameters->particle_manager_parameters, this);
     boundary_input_vector_ = Coordinate3D();
+
+    if (alveolus_parameters->parallel_agent_updates) {
+        // Agents interact up to two grid constants away (collisions are searched in the neighbouring grid points)
+        auto nhl = dynamic_cast<BalloonListNHLocator*>(neighbourhood_locator_.get());
+        const double tile_size = std::max(alveolus_parameters->parallel_tile_size, 4.0 * nhl->getGridConstant());
+        agent_tiling_ = std::make_unique<AgentTiling>(tile_size, getLowerLimits(), getUpperLimits());
+        DEBUG_STDOUT("Parallel agent updates with a tile size of " << tile_size);
+    }
 }
 
 void AlveoleSite::handleCmdInputArgs(std::unordered_map<std::string, std::string>cmd_input_args) {
@@ -109,7 +123,10 @@ void AlveoleSite::handleCmdInputArgs(std::unordered_map<std::string, std::string
             auto* alveolus_parameters = static_cast<abm::utilAlveolus::AlveolusSiteParameter*>(parameters_.site_parameters.get());
             alveolus_parameters->particle_manager_parameters.diffusion_constant = std::stod(value);
 //            SYSTEM_STDOUT("Set parameter: " << key << " = " << value);
-            updateTimestepForDC(alveolus_parameters->particle_manager_parameters.diffusion_constant);
+            // The spectral solver integrates diffusion exactly in time, it is stable for any timestep
+            if (alveolus_parameters->particle_manager_parameters.diffusion_solver != "spectral") {
+                updateTimestepForDC(alveolus_parameters->particle_manager_parameters.diffusion_constant);
+            }
         }
         if ("sAEC" == key) {
             auto* alveolus_parameters = static_cast<abm::utilAlveolus::AlveolusSiteParameter*>(parameters_.site_parameters.get());
@@ -120,6 +137,26 @@ void AlveoleSite::handleCmdInputArgs(std::unordered_map<std::string, std::string
             auto* alveolus_parameters = static_cast<abm::utilAlveolus::AlveolusSiteParameter*>(parameters_.site_parameters.get());
             alveolus_parameters->particle_manager_parameters.start_secrection = std::stod(value);
         }
+        if ("eventDriven" == key) {
+            parameters_.site_parameters->agent_manager_parameters.event_driven_transitions = std::stoi(value) != 0;
+        }
+        if ("quiescent" == key) {
+            parameters_.site_parameters->agent_manager_parameters.quiescent_agents = std::stoi(value) != 0;
+        }
+        if ("precheck" == key) {
+            parameters_.site_parameters->agent_manager_parameters.boundary_placement_precheck = std::stoi(value) != 0;
+        }
+        if ("demandDriven" == key) {
+            auto* alveolus_parameters = static_cast<abm::utilAlveolus::AlveolusSiteParameter*>(parameters_.site_parameters.get());
+            alveolus_parameters->particle_manager_parameters.demand_driven_diffusion = std::stoi(value) != 0;
+        }
+        if ("odeEngine" == key) {
+            parameters_.site_parameters->agent_manager_parameters.ode_engine.activated = std::stoi(value) != 0;
+        }
+        if ("parallel" == key) {
+            auto* alveolus_parameters = static_cast<abm::utilAlveolus::AlveolusSiteParameter*>(parameters_.site_parameters.get());
+            alveolus_parameters->parallel_agent_updates = std::stoi(value) != 0;
+        }
     }
     if (cmd_input_args.size() > 0) {
         for (const auto &agent: parameters_.site_parameters->agent_manager_parameters.agents) {
@@ -132,6 +169,11 @@ void AlveoleSite::handleCmdInputArgs(std::unordered_map<std::string, std::string
                     if ("vAM" == key) {
                         agent->movement_parameters.mean = std::stod(value);
                     }
+                    // AMs enter with this rate instead of the calibrated input distributions
+                    if ("icInput" == key) {
+                        agent->initial_distribution = 0;
+                        agent->input_lambda = std::stod(value);
+                    }
                 }
             }
             if (abm::util::isSubstring("FungalCell", agent->type)) {
@@ -175,6 +217,11 @@ void AlveoleSite::handleCmdInputArgs(std::unordered_map<std::string, std::string
                 if (key == "killam" && (input_rate->key == "KilledByAM")) {
                     input_rate->rate = std::stod(value);
                 }
+
+                //swelling rate
+                if (key == "swell" && (input_rate->key == "FungalSwelling")) {
+                    input_rate->rate = std::stod(value);
+                }
             }
         }
 
@@ -434,8 +481,8 @@ Coordinate3D AlveoleSite::generateRandomDirectionVector(Coordinate3D position, d
         case 2:
             radiusOrbit = currentPos.r;
             dtheta = length / radiusOrbit; //in rad
-            alpha = random_generator_->generateDouble(M_PI * 2.0); //direction of the vector
-            alpha2dTurningAngle = alpha;
+            alpha = getRandomGenerator()->generateDouble(M_PI * 2.0); //direction of the vector
+            setLatestAlpha2dTurningAngle(alpha);
 
             vix = radiusOrbit * sin(dtheta) * cos(alpha);
             viy = radiusOrbit * sin(dtheta) * sin(alpha);
@@ -450,8 +497,8 @@ Coordinate3D AlveoleSite::generateRandomDirectionVector(Coordinate3D position, d
             break;
 
         default:
-            u = random_generator_->generateDouble();//sampler->sample();
-            phi = random_generator_->generateDouble(M_PI * 2.0);
+            u = getRandomGenerator()->generateDouble();//sampler->sample();
+            phi = getRandomGenerator()->generateDouble(M_PI * 2.0);
             r = length;
             subst = 2 * r * sqrt(u * (1 - u));
             x = subst * cos(phi);
@@ -469,11 +516,13 @@ Coordinate3D AlveoleSite::generateBiasedRandomDirectionVector(Agent *agent, Coor
     Coordinate3D result{}, randomPart{}, directedPart{}, intermediatePositions{};
     intermediatePositions = position;
 
-    double p = agent->getFeatureValueByName("migration-bias-probability"); // probability to move up the gradient
-    double alpha = agent->getFeatureValueByName("gradient-direction"); // direction of the gradient as sensed by the
+    static const std::string migration_bias_probability = "migration-bias-probability";
+    static const std::string gradient_direction = "gradient-direction";
+    double p = agent->getFeatureValueByName(migration_bias_probability); // probability to move up the gradient
+    double alpha = agent->getFeatureValueByName(gradient_direction); // direction of the gradient as sensed by the
 
     // Biased Persistent Random Walk with mixed parts of random and directed walk
-    if (random_generator_->generateInt(1) > 0) {
+    if (getRandomGenerator()->generateInt(1) > 0) {
         randomPart = generateRandomDirectionVector(position, (1.0 - p) * length);
         intermediatePositions += randomPart;
         directedPart = generateDirectedVector(intermediatePositions, alpha, p * length);
@@ -535,7 +584,7 @@ Coordinate3D AlveoleSite::generateDirectedVector(Coordinate3D position, SphericC
             radiusOrbit = currentPos.r;
             dtheta = length / radiusOrbit; //in rad
             alpha = retrieveDirectionAngleAlpha(currentPos, posOfGoal); //direction of the vector
-            alpha2dTurningAngle = alpha;
+            setLatestAlpha2dTurningAngle(alpha);
 
             vix = radiusOrbit * sin(dtheta) * cos(alpha);
             viy = radiusOrbit * sin(dtheta) * sin(alpha);
@@ -568,7 +617,7 @@ Coordinate3D AlveoleSite::generateDirectedVector(Coordinate3D position, double a
         case 2:
             radiusOrbit = currentPos.r;
             dtheta = length / radiusOrbit; //in rad
-            alpha2dTurningAngle = alpha;
+            setLatestAlpha2dTurningAngle(alpha);
 
             vix = radiusOrbit * sin(dtheta) * cos(alpha);
             viy = radiusOrbit * sin(dtheta) * sin(alpha);
@@ -706,8 +755,8 @@ Coordinate3D AlveoleSite::getRandomPosition() {
         double u, subst;
         switch (dimensions) {
             case 2: //on/in the surface of the sphere site
-                u = random_generator_->generateDouble();
-                phi = random_generator_->generateDouble(M_PI * 2.0);
+                u = getRandomGenerator()->generateDouble();
+                phi = getRandomGenerator()->generateDouble(M_PI * 2.0);
 
                 subst = 2 * radius * sqrt(u * (1 - u));
                 x = subst * cos(phi);
@@ -716,16 +765,16 @@ Coordinate3D AlveoleSite::getRandomPosition() {
                 break;
             case 3:
                 do {
-                    x = random_generator_->generateDouble(-1.0 * radius, radius);
-                    y = random_generator_->generateDouble(-1.0 * radius, radius);
-                    z = random_generator_->generateDouble(-1.0 * radius, radius);
+                    x = getRandomGenerator()->generateDouble(-1.0 * radius, radius);
+                    y = getRandomGenerator()->generateDouble(-1.0 * radius, radius);
+                    z = getRandomGenerator()->generateDouble(-1.0 * radius, radius);
                 } while (x * x + y * y + z * z >= radius * radius);
                 break;
             default:
                 do {
-                    x = random_generator_->generateDouble(-1.0 * radius, radius);
-                    y = random_generator_->generateDouble(-1.0 * radius, radius);
-                    z = random_generator_->generateDouble(-1.0 * radius, radius);
+                    x = getRandomGenerator()->generateDouble(-1.0 * radius, radius);
+                    y = getRandomGenerator()->generateDouble(-1.0 * radius, radius);
+                    z = getRandomGenerator()->generateDouble(-1.0 * radius, radius);
                 } while (x * x + y * y + z * z >= radius * radius);
                 break;
         }
@@ -745,10 +794,10 @@ Coordinate3D AlveoleSite::getRandomBoundaryPoint() {
     double lengthOfPoKLineElements = 2 * M_PI * radiusPoresOfKohn * noOfPoK;
     double lengthOfAERLineElements = 2 * M_PI * radius * sin(thetaLowerBound);
     do {
-        double decisionRand = random_generator_->generateDouble(lengthOfPoKLineElements + lengthOfAERLineElements);
+        double decisionRand = getRandomGenerator()->generateDouble(lengthOfPoKLineElements + lengthOfAERLineElements);
         if (decisionRand < lengthOfPoKLineElements) {
             // Use a pore of Kohn as boundary point
-            unsigned int entrancePoKindex = random_generator_->generateInt(noOfPoK - 1);
+            unsigned int entrancePoKindex = getRandomGenerator()->generateInt(noOfPoK - 1);
             boundaryPoint = poresOfKohn[entrancePoKindex]->position;
             Coordinate3D shiftFromPoKCenter = generateRandomDirectionVector(
                     boundaryPoint, radiusPoresOfKohn * thetaLowerBound);
@@ -860,7 +909,7 @@ void AlveoleSite::adjustAgents(double time_delta, double current_time) {
 
 }
 
-double AlveoleSite::getFeatureValueByName(std::string name) {
+double AlveoleSite::getFeatureValueByName(const std::string &name) {
     double value = 0;
     if (name == "surfactantThickness") {
         value = surfactantThickness;
@@ -903,6 +952,13 @@ Coordinate3D AlveoleSite::generateBackShiftOnContacting(SphereRepresentation* ac
     return backShift;
 }
 
+bool AlveoleSite::hasMoleculeConsumers() {
+    const auto &all_agents = agent_manager_->getAllAgents();
+    return std::any_of(all_agents.begin(), all_agents.end(), [](const auto &agent) {
+        return agent != nullptr && !agent->isDeleted() && dynamic_cast<ImmuneCellMacrophage *>(agent.get()) != nullptr;
+    });
+}
+
 void AlveoleSite::updateTimeStepSize(SimulationTime &time) {
     if (particle_manager_->getDiffusionCoefficient() > 500) {
         if (particle_manager_->steadyStateReached(time.getCurrentTime()) &&
@@ -1053,39 +1109,72 @@ void AlveoleSite::doAgentDynamics(Randomizer *random_generator, SimulationTime &
 
     const auto &all_agents = agent_manager_->getAllAgents();
     if (!all_agents.empty()) {
-        // Loop over all agents (random order)
-        const auto current_order = abm::util::generateRandomPermutation(random_generator, all_agents.size());
-        for (auto agent_idx = current_order.begin(); agent_idx < current_order.end(); ++agent_idx) {
-            auto curr_agent = all_agents[*agent_idx];
-            if (nullptr != curr_agent) {
-                // Do all actions for one timestep for each agent (-> Cell.cpp)
-                curr_agent->doAllActionsForTimestep(dt, current_time);
-                // Remove spherical representations if the current agent got deleted
-                if (curr_agent->isDeleted()) {
-                    for (const auto &sphere: curr_agent->getMorphology()->getAllSpheresOfThis()) {
-                        neighbourhood_locator_->removeSphereRepresentation(sphere);
-                        agent_manager_->removeSphereRepresentation(sphere);
+        // The field is only advanced if agents read it, otherwise the steps are deferred until it is read
+        const bool field_consumed = hasMoleculeConsumers();
+        particle_manager_->setFieldConsumed(field_consumed);
+        // Agents are updated in parallel tiles if the run is not already parallelized over replicates
+        const bool parallel_agent_updates = agent_tiling_ != nullptr && !omp_in_parallel();
+        // Tiles only read the field, its lazy caches are filled before
+        if (parallel_agent_updates && field_consumed) particle_manager_->prepareConcurrentReads();
+        // Diffusion of the current field runs concurrently with the agents if the steady state is not reached before
+        // the agents act. Agents only read the field, their changes and the ones of diffusion are merged afterwards.
+        const bool concurrent_diffusion = particle_manager_->diffusesConcurrently() && !parallel_agent_updates &&
+                                          !particle_manager_->steadyStateReached(current_time);
+        // The agents may be updated on another thread than the one of the run, which has to use the arena of the run
+        auto *arena = abm::util::RunArena::current();
+#pragma omp parallel sections num_threads(2) if(concurrent_diffusion && !omp_in_parallel())
+        {
+#pragma omp section
+            {
+                const abm::util::RunArena::Scope arena_scope(arena);
+                // Loop over all agents (random order)
+                agent_order_.resize(all_agents.size());
+                abm::util::generateRandomPermutation(random_generator, agent_order_.data(), agent_order_.size());
+                const auto &current_order = agent_order_;
+                if (parallel_agent_updates) {
+                    updateAgentsInParallel(random_generator, current_order, dt, current_time);
+                } else {
+                    for (auto agent_idx = current_order.begin(); agent_idx < current_order.end(); ++agent_idx) {
+                        auto curr_agent = all_agents[*agent_idx];
+                        if (nullptr != curr_agent) {
+                            // Do all actions for one timestep for each agent (-> Cell.cpp)
+                            curr_agent->doAllActionsForTimestep(dt, current_time);
+                            // Remove spherical representations if the current agent got deleted
+                            if (curr_agent->isDeleted()) {
+                                for (const auto &sphere: curr_agent->getMorphology()->getAllSpheresOfThis()) {
+                                    neighbourhood_locator_->removeSphereRepresentation(sphere);
+                                    agent_manager_->removeSphereRepresentation(sphere);
+                                }
+                                curr_agent = nullptr;
+                            }
+                        }
                     }
-                    curr_agent = nullptr;
                 }
             }
+#pragma omp section
+            {
+                if (concurrent_diffusion) particle_manager_->doDiffusion(dt);
+            }
         }
 
+        // Intracellular models of all agents are integrated in one batch per model
+        if (auto *ode_engine = agent_manager_->getOdeEngine()) ode_engine->integrate(dt);
+
         // Loop over all particles if steady state is not reached
         if (!particle_manager_->steadyStateReached(current_time)) {
-            for (const auto &cur_particle: particle_manager_->getAllParticles()) {
-                // Do all actions for one timestep for each particle
-                cur_particle->doDiffusion(dt);
-            }
+            // Do all actions for one timestep for each particle
+            if (!concurrent_diffusion) particle_manager_->doDiffusion(dt);
+            if (particle_manager_->diffusesConcurrently()) particle_manager_->mergeDiffusionChanges();
             // Initialize Particles
             //TODO: this has to be done: after hyphae grew a certain amount of sphere, chemotaxis has to be activated for new aec cells
 //            agent_manager_->trackingOfFungalElements();
 
             particle_manager_->inputOfParticles(dt, current_time);
-            for (const auto &cur_particle: particle_manager_->getAllParticles()) {
-                // Apply actual concentration change to particles
-                cur_particle->applyConcentrationChange(dt);
-            }
+            // Apply actual concentration change to particles
+            particle_manager_->applyConcentrationChanges(dt);
+        } else if (concurrent_diffusion) {
+            // Agents changed the fungal cells such that the steady state is reached now
+            particle_manager_->discardDiffusionChanges();
         }
 
         // Clean up agents
@@ -1097,6 +1186,60 @@ void AlveoleSite::doAgentDynamics(Randomizer *random_generator, SimulationTime &
     updateTimeStepSize(time);
 }
 
+void AlveoleSite::updateAgentsInParallel(Randomizer *random_generator, const std::vector<unsigned int> &order,
+                                         double dt, double current_time) {
+    const auto &all_agents = agent_manager_->getAllAgents();
+    auto removeSpheres = [this](Agent *agent) {
+        for (const auto &sphere: agent->getMorphology()->getAllSpheresOfThis()) {
+            neighbourhood_locator_->removeSphereRepresentation(sphere);
+            agent_manager_->removeSphereRepresentation(sphere);
+        }
+    };
+    agent_tiling_->assignAgents(all_agents, order);
+
+    // Agents with spheres in several tiles are updated first, serially and with the generator of the run
+    for (auto agent_idx: agent_tiling_->getSpanningAgents()) {
+        const auto &agent = all_agents[agent_idx];
+        agent->doAllActionsForTimestep(dt, current_time);
+        if (agent->isDeleted()) removeSpheres(agent.get());
+    }
+
+    // Every tile draws from its own generator, seeds are drawn in the order of the tiles
+    const auto &tiles = agent_tiling_->getOccupiedTiles();
+    while (tile_generators_.size() < tiles.size()) tile_generators_.emplace_back(std::make_unique<Randomizer>(0));
+    tile_contexts_.resize(std::max(tile_contexts_.size(), tiles.size()));
+    for (size_t tile = 0; tile < tiles.size(); ++tile) {
+        tile_generators_[tile]->reseed(random_generator->generateInt(std::numeric_limits<int>::max()));
+        tile_contexts_[tile] = {tile_generators_[tile].get(), getLatestAlpha2dTurningAngle()};
+    }
+
+    // Tiles of one colour are updated concurrently, removals of deleted agents are deferred until the colour is done
+    // and applied in the order of the tiles
+    deleted_agents_.resize(std::max(deleted_agents_.size(), tiles.size()));
+    for (auto &deleted_agents: deleted_agents_) deleted_agents.clear();
+    auto *arena = abm::util::RunArena::current();
+    updating_agents_in_parallel_ = true;
+    for (unsigned int colour = 0; colour < AgentTiling::number_of_colours; ++colour) {
+        const auto &colour_tiles = agent_tiling_->getTilesOfColour(colour);
+#pragma omp parallel for schedule(dynamic) if(colour_tiles.size() > 1)
+        for (size_t i = 0; i < colour_tiles.size(); ++i) {
+            const auto tile = colour_tiles[i];
+            const abm::util::RunArena::Scope arena_scope(arena);
+            setThreadContext(&tile_contexts_[tile]);
+            for (auto agent_idx: tiles[tile]) {
+                const auto &agent = all_agents[agent_idx];
+                agent->doAllActionsForTimestep(dt, current_time);
+                if (agent->isDeleted()) deleted_agents_[tile].push_back(agent.get());
+            }
+            setThreadContext(nullptr);
+        }
+        for (auto tile: colour_tiles) {
+            for (auto agent: deleted_agents_[tile]) removeSpheres(agent);
+        }
+    }
+    updating_agents_in_parallel_ = false;
+}
+
 void AlveoleSite::receiveFrontendParameter(abm::util::SimulationParameters &sim_para, abm::util::InputParameters &inp_para,
                                     const std::string &config_path, const std::string &output_path, std::string sid) {
 
@@ -15,6 +15,7 @@
 #include <iostream>
 
 #include "core/simulation/Site.h"
+#include "apps/alveolus/AgentTiling.h"
 #include "apps/alveolus/particles/ParticleManager.h"
 #include "apps/alveolus/environment/Surface.h"
 
@@ -69,7 +70,7 @@ public:
     bool containsPosition(Coordinate3D position) final;
     std::pair<bool, int> overAECT1(SphericCoordinate3D posConida);
     void adjustPosition(Coordinate3D& position);
-    double getFeatureValueByName(std::string name) final;
+    double getFeatureValueByName(const std::string &name) final;
     double getThicknessOfBorder() { return thicknessOfBorder; }
     double getLowerThetaBound() { return thetaLowerBound; }
     double getDistanceFromBoundary(Coordinate3D position);
@@ -81,6 +82,7 @@ public:
     double getLengthAEC2() {return lengthAlvEpithTypeTwo;};
     double getRadiusPoK() {return radiusPoresOfKohn;};
     double getRadius() const override {return radius;};
+    int getOrganism() const {return organism;};
     Surface getEnvSurface(){return env_surface_;};
 
     [[nodiscard]] std::string getType() const final { return "AlveoleSite"; }
@@ -101,6 +103,8 @@ public:
     void doAgentDynamics(Randomizer *random_generator, SimulationTime &time);
 
     void updateTimeStepSize(SimulationTime &time);
+    /// True if agents read the molecule field in the current step (AMs interact with the molecules)
+    bool hasMoleculeConsumers();
     int getClosestAECID(Coordinate3D position, bool over_aec1);
     std::unique_ptr<ParticleManager> particle_manager_;
     static double retrieveDirectionAngleAlpha(SphericCoordinate3D ownPos, SphericCoordinate3D goalPos);
@@ -125,6 +129,9 @@ private:
     void calculateCrossPoints();
 
     void adjustAgents(double time_delta, double current_time);
+    /// Updates the agents of distant tiles concurrently (see AgentTiling), agents of one tile keep the given order
+    void updateAgentsInParallel(Randomizer *random_generator, const std::vector<unsigned int> &order, double dt,
+                                double current_time);
 
     double radius;
     Coordinate3D centerOfSite;
@@ -151,6 +158,11 @@ private:
     std::vector<std::shared_ptr<AECTypeTwo>> alvEpithTypeTwo{};
     std::vector<std::shared_ptr<PoreOfKohn>> poresOfKohn{};
     std::vector<Coordinate3D> crossAEC1Points{};
+    std::unique_ptr<AgentTiling> agent_tiling_{};
+    // Generators, thread contexts and deleted agents of the tiles, kept between timesteps (generators are reseeded)
+    std::vector<std::unique_ptr<Randomizer>> tile_generators_{};
+    std::vector<ThreadContext> tile_contexts_{};
+    std::vector<std::vector<Agent *>> deleted_agents_{};
     void updateTimestepForDC(double dc);
     void handleCmdInputArgs(std::unordered_map<std::string, std::string> cmd_input_args);
     void receiveFrontendParameter(abm::util::SimulationParameters &sim_para, abm::util::InputParameters &inp_para,
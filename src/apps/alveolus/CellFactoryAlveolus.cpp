@@ -14,6 +14,7 @@
 #include "apps/alveolus/cells/FungalCellAlveolus.h"
 #include "core/simulation/Site.h"
 #include "apps/alveolus/cells/ImmuneCellMacrophage.h"
+#include "core/utils/RunArena.h"
 
 
 CellFactoryAlveolus::CellFactoryAlveolus(const std::unique_ptr<abm::util::SimulationParameters::SiteParameters>
@@ -29,15 +30,15 @@ std::shared_ptr<Cell> CellFactoryAlveolus::createCell(const std::string &agentty
     std::shared_ptr<Cell> agent{};
     auto site_tag = site->getIdentifier();
     if (agenttype == "Cell") {
-        agent = std::make_shared<Cell>(std::move(c), id, site, time_delta, current_time);
+        agent = abm::util::makeShared<Cell>(std::move(c), id, site, time_delta, current_time);
     } else if (agenttype == "ImmuneCell") {
-        agent = std::make_shared<ImmuneCell>(std::move(c), id, site, time_delta, current_time);
+        agent = abm::util::makeShared<ImmuneCell>(std::move(c), id, site, time_delta, current_time);
     } else if (agenttype == "FungalCell") {
-        agent = std::make_shared<FungalCell>(std::move(c), id, site, time_delta, current_time);
+        agent = abm::util::makeShared<FungalCell>(std::move(c), id, site, time_delta, current_time);
     }else if (agenttype == "FungalCellAlveolus") {
-        agent = std::make_shared<FungalCellAlveolus>(std::move(c), id, site, time_delta, current_time);
+        agent = abm::util::makeShared<FungalCellAlveolus>(std::move(c), id, site, time_delta, current_time);
     }else if (agenttype == "ImmuneCellMacrophage") {
-        agent = std::make_shared<ImmuneCellMacrophage>(std::move(c), id, site, time_delta, current_time);
+        agent = abm::util::makeShared<ImmuneCellMacrophage>(std::move(c), id, site, time_delta, current_time);
     }
     agent->setup(time_delta, current_time, agent_configurations_[site_tag + agenttype].get());
 
@@ -96,10 +96,14 @@ void InSituMeasurementsAlveolus::observeMeasurements(const SimulationTime& time)
             time_last_measurement_["agent-statistics"] = current_time;
         } else if ("molecules" == active && do_measurement) {
             auto alveoleSite = dynamic_cast<AlveoleSite*>(site_);
-            for (auto part: alveoleSite->particle_manager_->getAllParticles()) {
+            alveoleSite->particle_manager_->synchronizeConcentrations();
+            const auto &particles = alveoleSite->particle_manager_->getAllParticles();
+            for (auto id: alveoleSite->particle_manager_->getParticlesInInputOrder()) {
+                const auto &part = particles[id];
                 Coordinate3D pos = part->getPosition();
                 double value = part->getConcentration();
-                pair_measurements_["molecules"]->addValuePairs("molecule", current_time, pos.x, pos.y, pos.z, value, part->getId());
+                pair_measurements_["molecules"]->addValuePairs("molecule", current_time, pos.x, pos.y, pos.z, value,
+                                                               alveoleSite->particle_manager_->getOriginalId(id));
             }
             time_last_measurement_["molecules"] = current_time;
         }
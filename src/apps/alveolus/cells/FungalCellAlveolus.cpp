@@ -14,15 +14,21 @@
 #include "core/simulation/morphology/SphericalMorphology.h"
 
 #include "core/utils/macros.h"
+#include "core/utils/Names.h"
 #include "apps/alveolus/AlveoleSite.h"
 #include "apps/alveolus/AgentManagerAlveolus.h"
+#include "apps/alveolus/cells/IntracellularModels.h"
 
 
 void FungalCellAlveolus::handleInteractionEvent(InteractionEvent *ievent, double current_time) {
-
-    if (ievent->getNextState() == "UptakenByAM") {
-        auto aspState = getCellStateByName("UptakenByAM");
-        if (aspState != 0 and abm::util::isSubstring(cellState->getStateName(), "Swelling")) {
+    static const int uptaken_by_am = abm::util::Names::intern("UptakenByAM");
+    static const int germination_inside_am = abm::util::Names::intern("GerminationInsideAM");
+    static const int killed_by_am = abm::util::Names::intern("KilledByAM");
+    static const int swelling = abm::util::Names::intern("Swelling");
+
+    if (ievent->getNextStateId() == uptaken_by_am) {
+        auto aspState = getCellStateById(uptaken_by_am);
+        if (aspState != 0 and abm::util::Names::related(cellState->getStateId(), swelling)) {
             setState(aspState);
             INFO_STDOUT("Phagocytose: AspergillusFumigatus was phagocytosed");
             getSite()->getAgentManager()->removeFungalCellFromList(this->getId(), current_time);
@@ -31,8 +37,8 @@ void FungalCellAlveolus::handleInteractionEvent(InteractionEvent *ievent, double
         }
     }
 
-    if (ievent->getNextState() == "GerminationInsideAM") {
-        auto aspState = getCellStateByName("GerminationInsideAM");
+    if (ievent->getNextStateId() == germination_inside_am) {
+        auto aspState = getCellStateById(germination_inside_am);
         if (aspState != 0) {
             setState(aspState);
             INFO_STDOUT("Lysis: GerminationInsideAM of AspergillusFumigatus");
@@ -41,8 +47,8 @@ void FungalCellAlveolus::handleInteractionEvent(InteractionEvent *ievent, double
 //        setDeleted();
     }
 
-    if (ievent->getNextState() == "KilledByAM") {
-        auto aspState = getCellStateByName("KilledByAM");
+    if (ievent->getNextStateId() == killed_by_am) {
+        auto aspState = getCellStateById(killed_by_am);
         if (aspState != 0) {
             setState(aspState);
             INFO_STDOUT("Lysis: Death of AspergillusFumigatus");
@@ -54,26 +60,49 @@ void FungalCellAlveolus::handleInteractionEvent(InteractionEvent *ievent, double
 
 
 void FungalCellAlveolus::doMorphologicalChanges(double timestep, double current_time) {
-
-    auto cs = cellState->getStateName();
-//    std::cout << "Current CellState of id=" << id << ": " << cs << "\n";
-    if (cs == "InitialCellState") {
+    static const int initial_cell_state = abm::util::Names::intern("InitialCellState");
+    static const int fungal_on_aec1 = abm::util::Names::intern("FungalOnAEC1");
+    static const int fungal_on_aec2 = abm::util::Names::intern("FungalOnAEC2");
+    static const int swelling = abm::util::Names::intern("Swelling");
+    static const int uptaken_by_aec = abm::util::Names::intern("UptakenByAEC");
+    static const int killed = abm::util::Names::intern("Killed");
+    static const int germination = abm::util::Names::intern("Germination");
+    static const int germination_inside_aec = abm::util::Names::intern("GerminationInsideAEC");
+
+    auto cs = cellState->getStateId();
+    if (swelling_.isValid() && !abm::util::Names::related(cs, swelling)) {
+        // Dormant instance, the growth rate and capacity of zero keep the diameter
+        swelling_.parameters()[0] = 0.0;
+        swelling_.parameters()[1] = 0.0;
+    }
+//    std::cout << "Current CellState of id=" << id << ": " << cellState->getStateName() << "\n";
+    if (cs == initial_cell_state) {
         is_active_ = true;
-        auto aspState = getCellStateByName("FungalOnAEC2");
+        auto aspState = getCellStateById(fungal_on_aec2);
         auto connected_aec = dynamic_cast<AlveoleSite*>(site)->overAECT1(abm::util::toSphericCoordinates(this->getPosition()));
         if (connected_aec.first) {
-            aspState = getCellStateByName("FungalOnAEC1");
+            aspState = getCellStateById(fungal_on_aec1);
         }
         if (aspState != 0) {
             setState(aspState);
         }
-    } else if (abm::util::isSubstring(cs, "Swelling")) {
+    } else if (abm::util::Names::related(cs, swelling)) {
         // Fungal swelling model
-        swell_diameter_ += timestep * (rswelling_rate_ * swell_diameter_ * (1 - swell_diameter_/swell_carrying_capacity_));
+        if (swelling_.isValid()) {
+            // Integrated by the engine at the end of every timestep
+            if (swelling_.parameters()[1] == 0.0) {
+                swelling_.state()[0] = swell_diameter_;
+                swelling_.parameters()[0] = rswelling_rate_;
+                swelling_.parameters()[1] = swell_carrying_capacity_;
+            }
+            swell_diameter_ = swelling_.state()[0];
+        } else {
+            swell_diameter_ += timestep * (rswelling_rate_ * swell_diameter_ * (1 - swell_diameter_/swell_carrying_capacity_));
+        }
         double new_radius = fc_parameters->morphology_parameters.radius + (swell_diameter_/2);
         this->surface->getBasicSphereOfThis()->setRadius(new_radius);
 
-    } else if (abm::util::isSubstring(cs, "UptakenByAEC")) {
+    } else if (abm::util::Names::related(cs, uptaken_by_aec)) {
         if (is_active_) {
             is_active_ = false;
             getSite()->getAgentManager()->removeFungalCellFromList(this->getId(), current_time);
@@ -92,15 +121,15 @@ void FungalCellAlveolus::doMorphologicalChanges(double timestep, double current_
             this->surface->getBasicSphereOfThis()->setRadius(radiusConidia - 0.01);
         }
 
-    } else if (abm::util::isSubstring(cs, "Killed")) {
+    } else if (abm::util::Names::related(cs, killed)) {
         double radiusConidia = this->surface->getBasicSphereOfThis()->getRadius();
         if (radiusConidia > 1.0){
             this->surface->getBasicSphereOfThis()->setRadius(radiusConidia - 0.01);
         }
-    } else if (abm::util::isSubstring(cs, "Germination")) {
+    } else if (abm::util::Names::related(cs, germination)) {
 
         if (!is_active_) {
-            if (abm::util::isSubstring(cs, "GerminationInsideAEC")) {
+            if (abm::util::Names::related(cs, germination_inside_aec)) {
                 auto connected_aec = dynamic_cast<AlveoleSite *>(site)->overAECT1(
                         abm::util::toSphericCoordinates(this->getPosition()));
                 if (connected_aec.first) {
@@ -139,9 +168,34 @@ void FungalCellAlveolus::doMorphologicalChanges(double timestep, double current_
     }
 }
 
+bool FungalCellAlveolus::hasPendingDynamics(double timestep, double current_time) {
+    static const int fungal_on_aec1 = abm::util::Names::intern("FungalOnAEC1");
+    static const int fungal_on_aec2 = abm::util::Names::intern("FungalOnAEC2");
+    static const int uptaken_by_aec = abm::util::Names::intern("UptakenByAEC");
+    static const int killed = abm::util::Names::intern("Killed");
+
+    // Resting conidia before swelling and conidia that finished shrinking inside an AEC or after being killed
+    auto cs = cellState->getStateId();
+    if (cs == fungal_on_aec1 || cs == fungal_on_aec2) {
+        return false;
+    }
+    double radiusConidia = this->surface->getBasicSphereOfThis()->getRadius();
+    if (abm::util::Names::related(cs, uptaken_by_aec)) {
+        auto posCon = abm::util::toSphericCoordinates(this->getPosition());
+        return is_active_ || radiusConidia > 1.0 || posCon.r < this->getSite()->getRadius() + 1.9;
+    }
+    if (abm::util::Names::related(cs, killed)) {
+        return radiusConidia > 1.0;
+    }
+    return true;
+}
+
 bool FungalCellAlveolus::isActive() {
-    auto cs = this->getCurrentCellState()->getStateName();
-    return cs == "InitialCellState" || cs == "FungalResting" || cs == "FungalSwelling" || is_active_;
+    static const int initial_cell_state = abm::util::Names::intern("InitialCellState");
+    static const int fungal_resting = abm::util::Names::intern("FungalResting");
+    static const int fungal_swelling = abm::util::Names::intern("FungalSwelling");
+    auto cs = this->getCurrentCellState()->getStateId();
+    return cs == initial_cell_state || cs == fungal_resting || cs == fungal_swelling || is_active_;
 }
 
 void FungalCellAlveolus::setup(double time_delta, double current_time, abm::util::SimulationParameters::AgentParameters * parameters) {
@@ -153,4 +207,8 @@ void FungalCellAlveolus::setup(double time_delta, double current_time, abm::util
     swell_diameter_ = 0.0053; // in µm
     swell_carrying_capacity_ = 1.84; // in µm
     this->surface->getBasicSphereOfThis()->setRadiusAtT0(fc_parameters->morphology_parameters.radius + swell_diameter_/2);
+    // The instance is added dormant here and not on first use, since the agents are updated concurrently
+    if (auto *ode_engine = getSite()->getAgentManager()->getOdeEngine()) {
+        swelling_ = ode_engine->model<LogisticSwelling>().addInstance({swell_diameter_}, {0.0, 0.0});
+    }
 }
@@ -15,6 +15,7 @@
 #include "core/simulation/cells/FungalCell.h"
 #include "apps/alveolus/io_utils_alveolus.h"
 #include "apps/alveolus/cellparts/HyphalBranch.h"
+#include "core/simulation/OdeEngine.h"
 
 
 class FungalCellAlveolus : public FungalCell {
@@ -28,6 +29,7 @@ public:
     void doMorphologicalChanges(double timestep, double current_time) final;
 
     bool isActive();
+    bool hasPendingDynamics(double timestep, double current_time) final;
 
     // To guarantee the same functionality for derived class "FungalCellAlveolus" as for "FungalCell":
     // Make sure the getTypeName returns a substring of "FungalCell"
@@ -44,6 +46,7 @@ private:
     double rswelling_rate_{};
     double swell_diameter_{};
     double swell_carrying_capacity_{};
+    OdeModel::Instance swelling_{};
     double rate_next_mothercell_hyphae_{};
     int number_of_branches_{};
     bool is_active_{};
@@ -12,10 +12,13 @@
 
 #include "core/analyser/Analyser.h"
 #include "core/simulation/Site.h"
+#include "core/utils/Names.h"
 
 void ImmuneCellAlveolus::handleInteractionEvent(InteractionEvent *ievent, double current_time) {
-    if (ievent->getNextState() == "Pierce") {
-        auto icState = getCellStateByName("Death");
+    static const int pierce = abm::util::Names::intern("Pierce");
+    static const int death = abm::util::Names::intern("Death");
+    if (ievent->getNextStateId() == pierce) {
+        auto icState = getCellStateById(death);
         if (icState != 0) {
             setState(icState);
             INFO_STDOUT("Pierce: ImmuneCellAlveolus died");
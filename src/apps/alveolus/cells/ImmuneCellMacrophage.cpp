@@ -14,13 +14,17 @@
 //#include "core/io/InputConfiguration.h"
 //#include "core/simulation/Particle.h"
 #include "core/simulation/Site.h"
+#include "core/utils/Names.h"
 #include "apps/alveolus/AlveoleSite.h"
 #include "apps/alveolus/movement/BiasedPersistentRandomWalk.h"
+#include "apps/alveolus/cells/IntracellularModels.h"
 
 
 void ImmuneCellMacrophage::handleInteractionEvent(InteractionEvent *ievent, double current_time) {
-    if (ievent->getNextState().compare("Pierce") == 0) {
-        auto macrState = getCellStateByName("Death");
+    static const int pierce = abm::util::Names::intern("Pierce");
+    static const int death = abm::util::Names::intern("Death");
+    if (ievent->getNextStateId() == pierce) {
+        auto macrState = getCellStateById(death);
         if (macrState != 0) {
             setState(macrState);
         }
@@ -44,26 +48,36 @@ void ImmuneCellMacrophage::interactWithMolecules(double timestep) {
 
     const auto &allParticles = alveolesite->particle_manager_->getAllParticles();
     if (allParticles.size() > 0) {
-        // Initialize variables
-        std::vector<unsigned int> interactionParticles;
-        alveolesite->particle_manager_->particle_balloon_list_->setThreshold(radius);
-        alveolesite->particle_manager_->particle_balloon_list_->getInteractions(getPosition(), interactionParticles);
-
-        double dReceptorsConc = 0, dReceptors = 0, dLRComplexes = 0, dRinternalized = 0;
+        // Initialize variables, the buffer of the thread can hold all particles and is never reallocated afterwards
+        thread_local std::vector<unsigned int> interactionParticles;
+        interactionParticles.reserve(allParticles.size());
+        interactionParticles.clear();
+        alveolesite->particle_manager_->particle_balloon_list_->getInteractions(getPosition(), interactionParticles, radius);
+
+        double dReceptorsConc = 0, dReceptors = 0, dLRComplexes = 0, dRinternalized = 0, bindingRate = 0;
+        if (receptor_ligand_.isValid()) {
+            receptors = receptor_ligand_.state()[0];
+            LRComplexes = receptor_ligand_.state()[1];
+            Rinternalized = receptor_ligand_.state()[2];
+        }
         Coordinate3D curGradient{0.0, 0.0, 0.0}, curAvgGradient{0.0, 0.0, 0.0};
         double radiusAM = radius;
         auto it = interactionParticles.begin();
         // Calculate current receptor-concentration over the cell surface and loop over particles
         double receptorsConc = receptors / (M_PI * radiusAM * radiusAM);
         while (it != interactionParticles.end()) {
-            auto currentParticle = allParticles[(*it)];
+            const auto &currentParticle = allParticles[(*it)];
 
             // Calculate receptor ligand dynamics
-            double ligandsConc = currentParticle->getConcentration();
+            double ligandsConc = alveolesite->particle_manager_->getConcentration(*it);
             dReceptorsConc -= k_blr * ligandsConc * receptorsConc;
 
             // Update receptor and complexes concentration changes
-            if (isinf(dReceptorsConc)) dReceptorsConc = 0;
+            if (isinf(dReceptorsConc)) {
+                dReceptorsConc = 0;
+            } else {
+                bindingRate += k_blr * ligandsConc * currentParticle->getArea();
+            }
             dReceptors += dReceptorsConc * currentParticle->getArea();
             dLRComplexes -= dReceptorsConc * currentParticle->getArea();
 
@@ -73,15 +87,28 @@ void ImmuneCellMacrophage::interactWithMolecules(double timestep) {
                 currentParticle->addConcentrationChange(dReceptorsConc * timestep);
             }
 
+            // Further molecule species are taken up with first order kinetics
+            for (unsigned int species = 1; species < alveolesite->particle_manager_->getNumberOfSpecies(); ++species) {
+                double uptake = alveolesite->particle_manager_->getUptakeRate(species) * alveolesite->particle_manager_->getConcentration(*it, species);
+                currentParticle->addConcentrationChange(-uptake * timestep, species);
+            }
+
 
             dReceptorsConc = 0;
-            curGradient = currentParticle->getGradient();
-            curAvgGradient += curGradient;
+            if (!alveolesite->particle_manager_->hasAnalyticGradient()) {
+                curGradient = alveolesite->particle_manager_->getGradient(*it);
+                curAvgGradient += curGradient;
+            }
 
             it++;
         }
 
-        curAvgGradient *= 1.0 / interactionParticles.size(); // 1/(µm²*µm) -> concentration change per micrometer
+        if (alveolesite->particle_manager_->hasAnalyticGradient()) {
+            // Spectral field, the gradient is evaluated at the position of the AM
+            curAvgGradient = alveolesite->particle_manager_->getAnalyticGradient(getPosition());
+        } else {
+            curAvgGradient *= 1.0 / interactionParticles.size(); // 1/(µm²*µm) -> concentration change per micrometer
+        }
 
         // Compute the current absolute difference in LR number at front and rear of the macrophage
         double dLRdiff =
@@ -92,17 +119,22 @@ void ImmuneCellMacrophage::interactWithMolecules(double timestep) {
         // Apply changes for Receptor-Ligand model corresponding to Guo et al. (2007) model
         cumulativePersistenceGradient += curAvgGradient;
         consumedLigandsPersistence += dLRComplexes;
-        dReceptors += k_r * Rinternalized;
-        dLRComplexes -= k_i * LRComplexes;
-        dRinternalized += k_i * LRComplexes - k_r * Rinternalized;
-        receptors += dReceptors * timestep;
-        if (receptors < 0) receptors = 0;
-        LRComplexes += dLRComplexes * timestep;
-        Rinternalized += dRinternalized * timestep;
+        if (receptor_ligand_.isValid()) {
+            // Binding per free receptor, the kinetics are integrated by the engine at the end of the timestep
+            receptor_ligand_.inputs()[0] = bindingRate / (M_PI * radiusAM * radiusAM);
+        } else {
+            dReceptors += k_r * Rinternalized;
+            dLRComplexes -= k_i * LRComplexes;
+            dRinternalized += k_i * LRComplexes - k_r * Rinternalized;
+            receptors += dReceptors * timestep;
+            if (receptors < 0) receptors = 0;
+            LRComplexes += dLRComplexes * timestep;
+            Rinternalized += dRinternalized * timestep;
+        }
     }
 }
 
-void ImmuneCellMacrophage::setVariableOnEvent(std::string variable, double value) {
+void ImmuneCellMacrophage::setVariableOnEvent(const std::string &variable, double value) {
     if (variable.compare("AMonAECT") == 0) {
         if (timeOfAECThit == -1) {
             //overwrite this variable only on the first event that occurs
@@ -115,7 +147,7 @@ void ImmuneCellMacrophage::setVariableOnEvent(std::string variable, double value
     }
 }
 
-double ImmuneCellMacrophage::getFeatureValueByName(std::string featureName) {
+double ImmuneCellMacrophage::getFeatureValueByName(const std::string &featureName) {
     double value = 0;
     if (featureName.compare("migration-bias-probability") == 0) {
         double LRdiff_front_rear = cumulativePersistenceGradient.getMagnitude();
@@ -176,4 +208,9 @@ void ImmuneCellMacrophage::setup(double time_delta,
         setMovement(movement);
     }
     radius = surface->getAllSpheresOfThis().front()->getRadius();
+    // The instance is added here and not on first use, since the agents are updated concurrently
+    if (auto *ode_engine = getSite()->getAgentManager()->getOdeEngine()) {
+        receptor_ligand_ = ode_engine->model<ReceptorLigandKinetics>().addInstance(
+                {receptors, LRComplexes, Rinternalized}, {k_r, k_i});
+    }
 }
\ No newline at end of file
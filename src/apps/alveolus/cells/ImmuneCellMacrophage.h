@@ -14,6 +14,7 @@
 #include "core/simulation/Cell.h"
 #include "ImmuneCellAlveolus.h"
 #include "apps/alveolus/AlveoleSite.h"
+#include "core/simulation/OdeEngine.h"
 
 class ImmuneCellMacrophage : public ImmuneCell {
 public:
@@ -36,13 +37,13 @@ public:
     void interactWithMolecules(double timestep) final;
 
     /// Sets variable on certain event
-    void setVariableOnEvent(std::string variable, double value) final;
+    void setVariableOnEvent(const std::string &variable, double value) final;
 
     /// Returns "ImmuneCellMacrophage"
     std::string getTypeName() final;
 
     /// Returns value for feature (variable)
-    double getFeatureValueByName(std::string name) final;
+    double getFeatureValueByName(const std::string &name) final;
 
     // Returns number of uptaken fungi
     unsigned int getCurrentNoOfUptakes();
@@ -60,6 +61,7 @@ private:
     double k_i{};
     double k_r{};
     double consumedLigandsPersistence{};
+    OdeModel::Instance receptor_ligand_{};
 
     double radius{};
     AlveoleSite* alveolesite{};
@@ -0,0 +1,48 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#include <cmath>
+
+#include "apps/alveolus/cells/IntracellularModels.h"
+
+void LogisticSwelling::rightHandSide(const double *y, const double *parameters, const double *inputs, double *dydt,
+                                     size_t n) const {
+    for (size_t i = 0; i < n; ++i) {
+        const double rate = parameters[2 * i];
+        const double capacity = parameters[2 * i + 1];
+        dydt[i] = capacity > 0 ? rate * y[i] * (1 - y[i] / capacity) : 0.0;
+    }
+}
+
+void LogisticSwelling::solve(double dt, double *y, const double *parameters, const double *inputs, size_t n) const {
+    for (size_t i = 0; i < n; ++i) {
+        const double rate = parameters[2 * i];
+        const double capacity = parameters[2 * i + 1];
+        if (capacity > 0 && y[i] > 0) {
+            // y(t) = K / (1 + (K / y0 - 1) * exp(-r * t))
+            y[i] = capacity / (1 + (capacity / y[i] - 1) * std::exp(-rate * dt));
+        }
+    }
+}
+
+void ReceptorLigandKinetics::rightHandSide(const double *y, const double *parameters, const double *inputs,
+                                           double *dydt, size_t n) const {
+    for (size_t i = 0; i < n; ++i) {
+        const double receptors = y[3 * i];
+        const double complexes = y[3 * i + 1];
+        const double internalized = y[3 * i + 2];
+        const double k_r = parameters[2 * i];
+        const double k_i = parameters[2 * i + 1];
+        const double binding = inputs[i] * receptors;
+        dydt[3 * i] = -binding + k_r * internalized;
+        dydt[3 * i + 1] = binding - k_i * complexes;
+        dydt[3 * i + 2] = k_i * complexes - k_r * internalized;
+    }
+}
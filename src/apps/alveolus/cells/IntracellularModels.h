@@ -0,0 +1,39 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#ifndef COREABM_INTRACELLULARMODELS_H
+#define COREABM_INTRACELLULARMODELS_H
+
+#include "core/simulation/OdeEngine.h"
+
+class LogisticSwelling : public OdeModel {
+public:
+    // Logistic swelling of the diameter of conidia, state (swell diameter), parameters (rate, carrying capacity).
+    // The model is solved in closed form.
+    LogisticSwelling() : OdeModel(1, 2, 0) {};
+
+    void rightHandSide(const double *y, const double *parameters, const double *inputs, double *dydt,
+                       size_t n) const final;
+    [[nodiscard]] bool hasClosedForm() const final { return true; };
+    void solve(double dt, double *y, const double *parameters, const double *inputs, size_t n) const final;
+};
+
+class ReceptorLigandKinetics : public OdeModel {
+public:
+    // Receptor-ligand model of Guo et al. (2007) for macrophages, state (free receptors, ligand-receptor complexes,
+    // internalized receptors), parameters (recycling rate k_r, internalization rate k_i) and the binding rate per free
+    // receptor as input, which is set by the interaction with the molecules in every timestep.
+    ReceptorLigandKinetics() : OdeModel(3, 2, 1) {};
+
+    void rightHandSide(const double *y, const double *parameters, const double *inputs, double *dydt,
+                       size_t n) const final;
+};
+
+#endif /* COREABM_INTRACELLULARMODELS_H */
@@ -11,6 +11,7 @@
 #include "PiercingOfImmuneCell.h"
 #include "core/simulation/Interaction.h"
 #include "core/simulation/Cell.h"
+#include "core/utils/Names.h"
 
 
 std::string PiercingOfImmuneCell::getTypeName() const{
@@ -18,9 +19,10 @@ std::string PiercingOfImmuneCell::getTypeName() const{
 }
 
 void PiercingOfImmuneCell::handleInteraction(Interaction *interaction,Cell* cell, double timestep, double current_time){
+    static const int immune_cell_type = abm::util::Names::intern("ImmuneCell");
     Cell* immune_cell;
     Cell* fungal_cell;
-    if (abm::util::isSubstring(interaction->getFirstCell()->getTypeName(), "ImmuneCell")) {
+    if (abm::util::Names::related(interaction->getFirstCell()->getTypeId(), immune_cell_type)) {
         immune_cell = interaction->getFirstCell();
         fungal_cell = interaction->getSecondCell();
     } else {
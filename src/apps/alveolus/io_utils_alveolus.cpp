@@ -44,6 +44,10 @@ abm::util::SimulationParameters abm::utilAlveolus::getSimulationParameters(const
         as_para.length_alv_epth_type_two = site["AlveoleSite"]["length_alv_epth_type_two"];
         as_para.site_center = {site["AlveoleSite"]["site_center"][0], site["AlveoleSite"]["site_center"][1],
                                site["AlveoleSite"]["site_center"][2]};
+        // Agents in distant tiles of the site are updated in parallel within one run, the tile edge is at least four
+        // times the grid constant of the neighbourhood locator (0: minimal edge)
+        as_para.parallel_agent_updates = site["AlveoleSite"].value("parallel_agent_updates", false);
+        as_para.parallel_tile_size = site["AlveoleSite"].value("parallel_tile_size", 0.0);
 
         if (auto particles = site.find("Particles"); particles != site.end()) {
             as_para.particle_manager_parameters.diffusion_constant = particles->value("diffusion_constant", 0.0);
@@ -53,6 +57,78 @@ abm::util::SimulationParameters abm::utilAlveolus::getSimulationParameters(const
                     "particle_delauney_input_file", "");
             as_para.particle_manager_parameters.start_secrection = particles->value("start_secretion", -1.0);
             as_para.particle_manager_parameters.visualize_concentration = particles->value("visualize_concentration", false);
+            // A particle mesh is generated (and cached) if the delauney input file does not exist
+            as_para.particle_manager_parameters.number_of_particles = particles->value("number_of_particles", 0);
+            as_para.particle_manager_parameters.particle_mesh_seeding = particles->value("particle_mesh_seeding", "fibonacci");
+            // Empty cache directory means the output directory of the simulator, the input files are never written to
+            as_para.particle_manager_parameters.particle_mesh_cache_dir = particles->value("particle_mesh_cache_dir", "");
+            // A subdivided icosahedron has 10 * 4^k + 2 vertices, other numbers would silently be rounded up
+            if (as_para.particle_manager_parameters.particle_mesh_seeding == "icosphere") {
+                const auto number_of_particles = as_para.particle_manager_parameters.number_of_particles;
+                unsigned int reachable = 12;
+                while (reachable < number_of_particles) reachable = 4 * (reachable - 2) + 2;
+                if (number_of_particles != 0 && reachable != number_of_particles) {
+                    ERROR_STDERR("Icosphere seeding cannot generate " << number_of_particles << " particles, the next "
+                                 << "possible number is " << reachable << " (10 * 4^k + 2).");
+                    exit(1);
+                }
+            }
+            // "superposition" assembles the secreted molecules from cached step responses of the secretion sources,
+            // "spectral" integrates diffusion on the sphere in spherical harmonics up to the band limit
+            auto &pm_para = as_para.particle_manager_parameters;
+            pm_para.diffusion_solver = particles->value("diffusion_solver", "explicit");
+            const bool explicit_solver = pm_para.diffusion_solver == "explicit";
+            const bool spectral_solver = pm_para.diffusion_solver == "spectral";
+            if (!explicit_solver && !spectral_solver && pm_para.diffusion_solver != "superposition") {
+                ERROR_STDERR("Unknown diffusion solver " << pm_para.diffusion_solver
+                             << ", use \"explicit\", \"superposition\" or \"spectral\".");
+                exit(1);
+            }
+            pm_para.superposition_tolerance = particles->value("superposition_tolerance", 1e-7);
+            pm_para.superposition_memory_limit = particles->value("superposition_memory_limit", 4096.0);
+            pm_para.spectral_band_limit = particles->value("spectral_band_limit", 16);
+            pm_para.spectral_penalty = particles->value("spectral_penalty", 1000.0);
+            // Explicit diffusion of a step runs on a second thread while the agents act on the same field. Off by default,
+            // the fork costs more than it saves on small meshes and oversubscribes the cores of parallel runs.
+            pm_para.concurrent_diffusion = particles->value("concurrent_diffusion", false);
+            // Steps without agents that interact with molecules are recorded and replayed when the field is read
+            pm_para.demand_driven_diffusion = particles->value("demand_driven_diffusion", explicit_solver);
+            // "single" diffuses in float32, optionally monitored by a double precision shadow field on sampled steps
+            pm_para.field_precision = particles->value("field_precision", "double");
+            pm_para.precision_monitor_interval = particles->value("precision_monitor_interval", 0);
+            pm_para.precision_monitor_window = particles->value("precision_monitor_window", 100);
+            if (pm_para.field_precision != "double" && pm_para.field_precision != "single") {
+                ERROR_STDERR("Unknown field precision " << pm_para.field_precision << ", use \"double\" or \"single\".");
+                exit(1);
+            }
+
+            // Diffusion only sweeps particles with (or next to) a concentration above the epsilon, exact for epsilon 0
+            pm_para.active_set_diffusion = particles->value("active_set_diffusion", !spectral_solver);
+            pm_para.active_set_epsilon = particles->value("active_set_epsilon", 0.0);
+
+            // Superposition and spectral solver change their state in every step and keep the field in double
+            // precision, only the explicit sweeps are run concurrently, deferred or in single precision. The spectral
+            // field is not represented on the particles (no active set) and agents read it at arbitrary positions
+            // through shared buffers (no parallel agent updates).
+            const auto reject = [&pm_para](const std::string &option) {
+                ERROR_STDERR(option << " is not supported for the " << pm_para.diffusion_solver << " diffusion solver.");
+                exit(1);
+            };
+            if (!explicit_solver && pm_para.concurrent_diffusion) reject("concurrent_diffusion");
+            if (!explicit_solver && pm_para.demand_driven_diffusion) reject("demand_driven_diffusion");
+            if (!explicit_solver && pm_para.field_precision == "single") reject("Single field_precision");
+            if (spectral_solver && pm_para.active_set_diffusion) reject("active_set_diffusion");
+            if (spectral_solver && as_para.parallel_agent_updates) reject("parallel_agent_updates");
+            if (auto species = particles->find("additional_species"); species != particles->end()) {
+                for (const auto &sp: *species) {
+                    abm::utilAlveolus::MoleculeSpeciesParameters species_parameters{};
+                    species_parameters.name = sp.value("name", "");
+                    species_parameters.diffusion_constant = sp.value("diffusion_constant", 0.0);
+                    species_parameters.molecule_secretion_per_cell = sp.value("molecule_secretion_per_cell", 0.0);
+                    species_parameters.uptake_rate = sp.value("uptake_rate", 0.0);
+                    as_para.particle_manager_parameters.additional_species.emplace_back(species_parameters);
+                }
+            }
         }
 
         sitep = std::make_unique<AlveolusSiteParameter>(as_para);
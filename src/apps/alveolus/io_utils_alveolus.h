@@ -65,12 +65,36 @@ namespace abm::utilAlveolus {
         double k_blr{};
     };
 
+    // Further molecule species that diffuse on the particle mesh next to the chemokine
+    struct MoleculeSpeciesParameters {
+        std::string name{};
+        double diffusion_constant{};
+        double molecule_secretion_per_cell{};
+        double uptake_rate{};
+    };
+
     struct ParticleManagerParameters {
         double diffusion_constant{};
         double molecule_secretion_per_cell{};
         double start_secrection{};
         bool visualize_concentration{};
         std::string particle_delauney_input_file{};
+        unsigned int number_of_particles{};
+        std::string particle_mesh_seeding{};
+        std::string particle_mesh_cache_dir{};
+        bool active_set_diffusion{};
+        double active_set_epsilon{};
+        std::vector<MoleculeSpeciesParameters> additional_species{};
+        std::string diffusion_solver{};
+        double superposition_tolerance{};
+        double superposition_memory_limit{};
+        unsigned int spectral_band_limit{};
+        double spectral_penalty{};
+        bool concurrent_diffusion{};
+        bool demand_driven_diffusion{};
+        std::string field_precision{};
+        unsigned int precision_monitor_interval{};
+        unsigned int precision_monitor_window{};
     };
 
     struct AlveolusSiteParameter : abm::util::SimulationParameters::SiteParameters {
@@ -85,6 +109,8 @@ namespace abm::utilAlveolus {
         double radius_pores_of_kohn{};
         double radius_alv_epith_type_one{};
         double length_alv_epth_type_two{};
+        bool parallel_agent_updates{};
+        double parallel_tile_size{};
         ParticleManagerParameters particle_manager_parameters{};
         Coordinate3D site_center{};
     };
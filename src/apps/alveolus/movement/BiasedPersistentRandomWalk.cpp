@@ -26,24 +26,24 @@ BiasedPersistentRandomWalk::BiasedPersistentRandomWalk(Agent *agent, double pers
 
     if (agent->getInitialTime() > 0.0) {
         persistence_time_start_ = 0;
-        persistence_time_left_ = alveolesite_->getRandomGenerator()->generateDouble() * persistenceTime;
+        *persistence_time_left_ = alveolesite_->getRandomGenerator()->generateDouble() * persistenceTime;
     } else {
         persistence_time_start_ = alveolesite_->getRandomGenerator()->generateDouble() * persistenceTime;
-        persistence_time_left_ = persistence_time_start_;
+        *persistence_time_left_ = persistence_time_start_;
     }
 
     current_velocity_ = std::make_shared<Coordinate3D>();
     speed_ = speed;
-    persistence_direction_ = std::make_unique<Coordinate3D>();
 }
 
 Coordinate3D *BiasedPersistentRandomWalk::move(double timestep, double dc) {
+    static const std::string reset_cumulative_gradient = "reset-cumulative-gradient";
     setCurrentTimestep(timestep);
     if (persistentMove()) {
         *current_velocity_ = *movePersistent(timestep);
     } else {
         moveBiasedRandomly(timestep);
-        agent_->setVariableOnEvent("reset-cumulative-gradient", 0);
+        agent_->setVariableOnEvent(reset_cumulative_gradient, 0);
         setNewPersistence();
     }
     decrementLeftTime(timestep);
@@ -62,7 +62,7 @@ Coordinate3D *BiasedPersistentRandomWalk::movePersistent(double timestep) {
                                                                            persistent_angle_alpha_2_d_);
     }
 
-    return persistence_direction_.get();
+    return persistence_direction_;
 }
 
 Coordinate3D *BiasedPersistentRandomWalk::moveBiasedRandomly(double timestep) {
@@ -74,16 +74,16 @@ Coordinate3D *BiasedPersistentRandomWalk::moveBiasedRandomly(double timestep) {
 }
 
 void BiasedPersistentRandomWalk::decrementLeftTime(double timestep) {
-    persistence_time_left_ -= timestep;
+    *persistence_time_left_ -= timestep;
 }
 
 void BiasedPersistentRandomWalk::setNewPersistence() {
     *persistence_direction_ = *current_velocity_.get();
-    persistence_time_left_ += persistence_time_;
+    *persistence_time_left_ += persistence_time_;
 }
 
 bool BiasedPersistentRandomWalk::persistentMove() const {
-    return (persistence_time_left_ > 0);
+    return (*persistence_time_left_ > 0);
 }
 
 double BiasedPersistentRandomWalk::getStartingTime() {
@@ -93,4 +93,11 @@ double BiasedPersistentRandomWalk::getStartingTime() {
 void BiasedPersistentRandomWalk::setPreviousMove(Coordinate3D *prevMove) {
     *persistence_direction_ = *prevMove;
     persistent_angle_alpha_2_d_ = alveolesite_->getLatestAlpha2dTurningAngle();
-}
\ No newline at end of file
+}
+
+void BiasedPersistentRandomWalk::attachComponents(AgentComponents &components, const AgentComponents::Handle &handle) {
+    components.direction(handle) = *persistence_direction_;
+    components.persistenceTimeLeft(handle) = *persistence_time_left_;
+    persistence_direction_ = &components.direction(handle);
+    persistence_time_left_ = &components.persistenceTimeLeft(handle);
+}
@@ -27,7 +27,8 @@ public:
     Coordinate3D *move(double, double dc) final;
     double getStartingTime() final;
     void setPreviousMove(Coordinate3D *) final;
-    void annulatePersistence() final { persistence_time_left_ = 0; };
+    void annulatePersistence() final { *persistence_time_left_ = 0; };
+    void attachComponents(AgentComponents &components, const AgentComponents::Handle &handle) final;
     void decrementLeftTime(double);
     void setNewPersistence();
     [[nodiscard]] bool persistentMove() const;
@@ -38,13 +39,16 @@ private:
     AlveoleSite* alveolesite_;
     Agent *agent_{};
     double persistence_time_{};
-    double persistence_time_left_{};
+    double *persistence_time_left_{&detached_time_left_};
     double persistence_time_start_{};
     double speed_{};
     double persistent_angle_alpha_2_d_{};
-    std::unique_ptr<Coordinate3D> persistence_direction_{};
+    Coordinate3D *persistence_direction_{&detached_direction_};
     std::unique_ptr<Sampler> sampler_{};
     std::shared_ptr<Coordinate3D> current_velocity_{};
+    // Persistence until the movement is attached to the component store
+    Coordinate3D detached_direction_{};
+    double detached_time_left_{};
 
 };
 
@@ -0,0 +1,42 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#ifndef COREABM_MORTONORDER_H
+#define COREABM_MORTONORDER_H
+
+#include <cstdint>
+
+namespace abm::utilAlveolus {
+
+    /// Spreads the lower 21 bits of a value to every third bit
+    inline std::uint64_t spreadBits(std::uint64_t value) {
+        value &= 0x1fffff;
+        value = (value | value << 32) & 0x1f00000000ffffULL;
+        value = (value | value << 16) & 0x1f0000ff0000ffULL;
+        value = (value | value << 8) & 0x100f00f00f00f00fULL;
+        value = (value | value << 4) & 0x10c30c30c30c30c3ULL;
+        value = (value | value << 2) & 0x1249249249249249ULL;
+        return value;
+    }
+
+    /*!
+     * Computes the position of a grid point on the Morton (Z-order) curve, points that are close in space are mostly
+     * close on the curve
+     * @param x Unsigned int that contains the x index (21 bits)
+     * @param y Unsigned int that contains the y index (21 bits)
+     * @param z Unsigned int that contains the z index (21 bits)
+     * @return Unsigned 64 bit int that contains the interleaved bits of the indices
+     */
+    inline std::uint64_t mortonCode(std::uint32_t x, std::uint32_t y, std::uint32_t z) {
+        return spreadBits(x) | spreadBits(y) << 1 | spreadBits(z) << 2;
+    }
+}
+
+#endif //COREABM_MORTONORDER_H
@@ -15,21 +15,19 @@ Particle::Particle(int id, Coordinate3D position, double area, Site *site) {
     position_ = position;
     double rad = abm::util::toSphericCoordinates(position).r;
     area_ = area;
-    concentration_ = 0.0;
     is_in_site_ = site->containsPosition(position) && site->getRadius() < rad * 1.05 && site->getRadius() > rad * 0.95;
     associated_type1_aec_ = -1;
     associated_type2_aec_ = -1;
     particle_neighbourlist_ = std::make_unique<ParticleNeighbourList>(this);
 }
 
-void Particle::addNeighbour(Particle *p, double contact_area, double dc) {
-    particle_neighbourlist_->addNeighbour(p, contact_area, dc);
+void Particle::addNeighbour(Particle *p, double contact_area) {
+    particle_neighbourlist_->addNeighbour(p, contact_area);
 }
 
 double Particle::estimateLowestTimestep(double dc) {
-    auto neighbour_particles = particle_neighbourlist_->getNeighbours();
-    auto distances = particle_neighbourlist_->getDistances();
-    auto contact_areas = particle_neighbourlist_->getContactAreas();
+    const auto &distances = particle_neighbourlist_->getDistances();
+    const auto &contact_areas = particle_neighbourlist_->getContactAreas();
 
     double sum = 0;
     for (size_t i = 0; i < distances.size(); i++) {
@@ -39,75 +37,22 @@ double Particle::estimateLowestTimestep(double dc) {
     return 1.0 / sum;
 }
 
-void Particle::doDiffusion(double timestep) {
-    if (is_in_site_) { //only "in site" grid points are used for the calculations
-        double current_own_prefactor = 0.0, conc_change_diffusion = 0.0;
-        for (size_t i=0; i < particle_neighbourlist_->getNeighbours().size(); ++i) {
-            auto neighbour_particle = particle_neighbourlist_->getNeighbours()[i];
-            auto neighbour_particle_prefactor_pse = particle_neighbourlist_->getPreFactorsPSE()[i];
-            conc_change_diffusion += neighbour_particle->getConcentration() * neighbour_particle_prefactor_pse;
-            current_own_prefactor += neighbour_particle_prefactor_pse;
-        }
-        conc_change_diffusion -= concentration_ * current_own_prefactor;
-        conc_change_diffusion *= timestep;
-
-        addConcentrationChange(conc_change_diffusion);
-    }
+void Particle::setConcentrationStorage(double *concentrations, double *concentration_changes,
+                                       unsigned int number_of_species) {
+    concentrations_ = concentrations;
+    concentration_changes_ = concentration_changes;
+    number_of_species_ = number_of_species;
 }
 
-void Particle::addConcentrationChange(double conc_change_diffusion) {
-    conc_change_in_current_timestep_ += conc_change_diffusion;
+void Particle::addConcentrationChange(double conc_change_diffusion, unsigned int species) {
+    concentration_changes_[species] += conc_change_diffusion;
 }
 
 void Particle::applyConcentrationChange(double timestep) {
     if (is_in_site_) { //only "in site" grid points are used for the calculations
-        concentration_ += conc_change_in_current_timestep_;
-        conc_change_in_current_timestep_ = 0;
-    }
-}
-
-Coordinate3D Particle::getGradient() {
-    Coordinate3D gradient = Coordinate3D();
-    if (is_in_site_) { //only "in site" grid points are used for the calculations
-        std::vector<Particle *> neighbours = particle_neighbourlist_->getNeighbours();
-        std::vector<double> preFactorsGradient = particle_neighbourlist_->getPreFactorsGradient();
-        std::vector<Particle *>::iterator it = neighbours.begin();
-        unsigned int index = 0;
-        while (it != neighbours.end()) {
-
-            //Sukumar et al.
-            Coordinate3D curGradient{(*it)->getPosition() - position_};
-            curGradient *= 0.5 * preFactorsGradient[index] * ((*it)->getConcentration() - concentration_);
-            it++;
-            index++;
-            gradient += curGradient;
-        }
-    }
-
-    return gradient;
-}
-
-double Particle::getGradientStrength() {
-    Coordinate3D gradient = Coordinate3D();
-    if (is_in_site_) {
-        std::vector<Particle *> neighbours = particle_neighbourlist_->getNeighbours();
-        std::vector<double> preFactorsGradient = particle_neighbourlist_->getPreFactorsGradient();
-
-        std::vector<Particle *>::iterator it = neighbours.begin();
-        unsigned int index = 0;
-        while (it != neighbours.end()) {
-
-            //Sukumar et al.
-            Coordinate3D curGradient{(*it)->getPosition() - position_};
-            curGradient *= 0.5 * preFactorsGradient[index] * ((*it)->getConcentration() - concentration_);
-            it++;
-            index++;
-            gradient += curGradient;
+        for (unsigned int species = 0; species < number_of_species_; ++species) {
+            concentrations_[species] += concentration_changes_[species];
+            concentration_changes_[species] = 0;
         }
     }
-
-    return gradient.getMagnitude();
 }
-
-
-
@@ -23,15 +23,13 @@ class Particle {
 public:
     Particle(int id, Coordinate3D position, double area, Site *site);
 
-    void addNeighbour(Particle *p, double contact_area, double dc);
+    void addNeighbour(Particle *p, double contact_area);
 
     Coordinate3D getPosition() { return position_; };
     int getId() { return id_; };
     double getArea() { return area_; };
-    double getConcentration() { return concentration_; };
+    double getConcentration(unsigned int species = 0) { return concentrations_[species]; };
     bool getIsInSite() const { return is_in_site_; };
-    Coordinate3D getGradient();
-    double getGradientStrength();
 
     double estimateLowestTimestep(double dc);
 
@@ -39,17 +37,19 @@ public:
     int associated_type1_aec_{};
     int associated_type2_aec_{};
 
-    void doDiffusion(double timestep);
+    /// Concentrations of all species are stored interleaved by the ParticleManager, a particle refers to its slots
+    void setConcentrationStorage(double *concentrations, double *concentration_changes, unsigned int number_of_species);
     void applyConcentrationChange(double timestep);
-    void addConcentrationChange(double diffusion);
+    void addConcentrationChange(double diffusion, unsigned int species = 0);
 
 private:
     int id_{};
     Coordinate3D position_{};
     double area_{};
-    double concentration_{};
     bool is_in_site_{};
-    double conc_change_in_current_timestep_{};
+    unsigned int number_of_species_{};
+    double *concentrations_{};
+    double *concentration_changes_{};
 
 
 };
@@ -9,13 +9,15 @@
 //  See the LICENSE file provided with this code for the full license.
 
 #include "ParticleManager.h"
-#include "external/json.hpp"
+#include "ParticleMeshGenerator.h"
 #include "core/simulation/neighbourhood/BalloonListNHLocator.h"
 #include "apps/alveolus/cells/FungalCellAlveolus.h"
+#include "core/utils/Names.h"
 #include <chrono>
 #include <algorithm>
-
-using json = nlohmann::json;
+#include <array>
+#include <type_traits>
+#include <cmath>
 
 ParticleManager::ParticleManager(abm::utilAlveolus::ParticleManagerParameters parameters, Site *site){
     site_ = dynamic_cast<AlveoleSite*>(site);
@@ -23,44 +25,92 @@ ParticleManager::ParticleManager(abm::utilAlveolus::ParticleManagerParameters pa
     s_aec_ = parameters.molecule_secretion_per_cell;
     visualize_concentration_ = parameters.visualize_concentration;
     start_chemotaxis_ = parameters.start_secrection;
+    number_of_particles_ = parameters.number_of_particles;
+    particle_mesh_seeding_ = parameters.particle_mesh_seeding;
+    particle_mesh_cache_dir_ = parameters.particle_mesh_cache_dir;
+    use_active_set_ = parameters.active_set_diffusion;
+    active_set_epsilon_ = parameters.active_set_epsilon;
+    use_superposition_ = parameters.diffusion_solver == "superposition";
+    superposition_tolerance_ = parameters.superposition_tolerance;
+    if (use_superposition_) SecretionResponse::setMemoryLimit(parameters.superposition_memory_limit * 1024 * 1024);
+    // Combinations of the solver with the other field options are checked when the configuration is loaded
+    single_precision_ = parameters.field_precision == "single";
+    use_spectral_ = parameters.diffusion_solver == "spectral";
+    spectral_penalty_ = parameters.spectral_penalty;
+    if (use_spectral_) harmonics_ = std::make_unique<SphericalHarmonics>(parameters.spectral_band_limit);
+    concurrent_diffusion_ = parameters.concurrent_diffusion;
+    demand_driven_diffusion_ = parameters.demand_driven_diffusion;
+    monitor_interval_ = single_precision_ ? parameters.precision_monitor_interval : 0;
+    monitor_window_ = std::max(1u, parameters.precision_monitor_window);
+    diffusion_constants_.push_back(dc_);
+    secretion_per_cell_.push_back(s_aec_);
+    uptake_rates_.push_back(0.0); // uptake of the chemokine is given by the receptor dynamics of the AM
+    for (const auto &species: parameters.additional_species) {
+        INFO_STDOUT("Molecule species " << diffusion_constants_.size() << " (" << species.name << ") with diffusion constant "
+                    << species.diffusion_constant << " and uptake rate " << species.uptake_rate);
+        diffusion_constants_.push_back(species.diffusion_constant);
+        secretion_per_cell_.push_back(species.molecule_secretion_per_cell);
+        uptake_rates_.push_back(species.uptake_rate);
+    }
+    number_of_species_ = diffusion_constants_.size();
+    if (number_of_species_ > max_number_of_species) {
+        ERROR_STDERR("At most " << max_number_of_species << " molecule species are supported, " << number_of_species_ << " are given.");
+        exit(1);
+    }
     number_aecs_ = site_->getAECT1().size() + site_->getAECT2().size();
     sum_area_aec_particles_cells_.resize(number_aecs_, 0.0);
-    aec_secretion_rate_per_grid_.resize(number_aecs_, 0.0);
+    aec_secretion_rate_per_grid_.resize(number_aecs_ * number_of_species_, 0.0);
     auto nhl = dynamic_cast<BalloonListNHLocator*>(site_->getNeighbourhoodLocator()); //nhl->getGridConstant()
     particle_balloon_list_ = std::make_unique<StaticBalloonList>(nhl->getGridConstant(), site_->getLowerLimits(), site_->getUpperLimits());
     initializeParticles(parameters.particle_delauney_input_file);
 }
 
 void ParticleManager::initializeParticles(std::string filename) {
-    std::ifstream infile(filename);
-    json j;
-    infile >> j;
-
-    int supposed_id = 0;
     if (s_aec_ > 0) {
-        for (const auto &particle_json: j["Particles"]) {
-            int id = particle_json["id"];
-            auto pos = particle_json["position"].get<std::vector<double>>();
-            Coordinate3D position{pos[0], pos[1], pos[2]};
-            double area = particle_json["area"];
-            all_particles_.emplace_back(std::make_shared<Particle>(id, position, area, site_));
-            particle_balloon_list_->addCoordinateWithId(position, id);
-
-            if (id != supposed_id) {
-                ERROR_STDERR("Particles are not in order at id = " + std::to_string(supposed_id));
-            }
-            ++supposed_id;
+        mesh_ = loadParticleMesh(filename);
+        const auto positions = mesh_->getPositions();
+        const auto offsets = mesh_->getNeighbourOffsets();
+        all_particles_.reserve(mesh_->size());
+        particles_in_input_order_.resize(mesh_->size());
+        for (size_t id = 0; id < mesh_->size(); ++id) {
+            all_particles_.emplace_back(std::make_shared<Particle>(id, positions[id], mesh_->getAreas()[id], site_));
+            particles_in_input_order_[mesh_->getOriginalIds()[id]] = id;
+        }
+        // Particles are stored in Morton order, the balloon list gets them in input order such that interactions are
+        // found in the same order as for the input mesh
+        for (auto id: particles_in_input_order_) {
+            particle_balloon_list_->addCoordinateWithId(positions[id], id);
+        }
+        particle_balloon_list_->compact();
+        concentrations_.assign(mesh_->size() * number_of_species_, 0.0);
+        concentration_changes_.assign(mesh_->size() * number_of_species_, 0.0);
+        diffusion_field_ = concentrations_.data();
+        if (use_superposition_) {
+            correction_field_.assign(mesh_->size() * number_of_species_, 0.0);
+            diffusion_field_ = correction_field_.data();
+            species_stencils_.resize(number_of_species_);
+        }
+        if (single_precision_) {
+            field_single_.assign(mesh_->size() * number_of_species_, 0.0f);
+            field_compensation_.assign(mesh_->size() * number_of_species_, 0.0f);
+        }
+        if (single_precision_ || concurrent_diffusion_) {
+            diffusion_changes_.assign(mesh_->size() * number_of_species_, 0.0);
+        }
+        for (size_t id = 0; id < mesh_->size(); ++id) {
+            all_particles_[id]->setConcentrationStorage(&concentrations_[id * number_of_species_],
+                                                        &concentration_changes_[id * number_of_species_],
+                                                        number_of_species_);
         }
 
-        for (const auto &particle_json: j["Particles"]) {
-            auto p = all_particles_[particle_json["id"]];
-            for (const auto &neighbour: particle_json["neighbours"]) {
-                auto pn = all_particles_[neighbour["id"]];
-                double contact_area = neighbour["contact_area"];
-                p->addNeighbour(pn.get(), contact_area, dc_);
+        for (size_t id = 0; id < mesh_->size(); ++id) {
+            auto &neighbour_list = all_particles_[id]->particle_neighbourlist_;
+            neighbour_list->reserve(offsets[id + 1] - offsets[id]);
+            for (auto k = offsets[id]; k < offsets[id + 1]; ++k) {
+                neighbour_list->addNeighbour(all_particles_[mesh_->getNeighbourIds()[k]].get(),
+                                             mesh_->getContactAreas()[k], mesh_->getDistances()[k]);
             }
         }
-        infile.close();
 
         // assign aec cells to particles, associated_type2_aec_ == -1, not associated with any aec2
         for (auto &p: all_particles_) {
@@ -91,53 +141,708 @@ void ParticleManager::initializeParticles(std::string filename) {
         }
 
         computeMaxPossibleTimestep();
+        initializeSecretionSources();
+        assembleOperators();
+        if (use_active_set_) initializeActiveSet();
+        if (use_spectral_) initializeSpectralField();
 
         if (visualize_concentration_) extractTriangles();
     }
 }
 
+std::shared_ptr<const MappedParticleMesh> ParticleManager::loadParticleMesh(const std::string &filename) {
+    const boost::filesystem::path input_file(filename);
+    if (input_file.extension() == ".pmesh") {
+        auto mesh = MappedParticleMesh::open(filename);
+        if (mesh == nullptr) {
+            ERROR_STDERR("Particle mesh file " << filename << " could not be read.");
+            exit(1);
+        }
+        return mesh;
+    }
+
+    std::shared_ptr<const MappedParticleMesh> mesh{};
+    if (!filename.empty() && boost::filesystem::exists(input_file)) {
+        // Json meshes are converted once into a binary mesh next to the cache, later runs map the binary mesh
+        const auto binary_file = (boost::filesystem::path(particle_mesh_cache_dir_) /
+                                  input_file.filename().replace_extension(".pmesh")).string();
+#pragma omp critical(particle_mesh_cache)
+        {
+            if (boost::filesystem::exists(binary_file) &&
+                boost::filesystem::last_write_time(binary_file) >= boost::filesystem::last_write_time(input_file)) {
+                mesh = MappedParticleMesh::open(binary_file);
+            }
+            if (mesh == nullptr) {
+                auto json_mesh = abm::utilAlveolus::readParticleMeshFromJson(filename);
+                abm::utilAlveolus::reorderParticleMesh(json_mesh);
+                if (abm::utilAlveolus::writeParticleMeshToBinary(binary_file, json_mesh)) {
+                    mesh = MappedParticleMesh::open(binary_file);
+                }
+                if (mesh == nullptr) {
+                    mesh = MappedParticleMesh::fromMesh(json_mesh, {});
+                }
+            }
+        }
+        return mesh;
+    }
+    if (number_of_particles_ == 0) {
+        ERROR_STDERR("Particle input file " << filename << " does not exist and no number_of_particles is given to generate a particle mesh.");
+        exit(1);
+    }
+
+    // Generated meshes are cached on disk, runs of the same screening share one mesh
+    const ParticleMeshKey key{site_->getRadius(), number_of_particles_, site_->getOrganism()};
+    ParticleMeshGenerator generator(key.radius, key.number_of_particles, key.organism, particle_mesh_seeding_);
+    const auto cache_file = (boost::filesystem::path(particle_mesh_cache_dir_) / generator.getCacheFileName()).string();
+#pragma omp critical(particle_mesh_cache)
+    {
+        mesh = MappedParticleMesh::open(cache_file);
+        if (mesh == nullptr || !(mesh->getKey() == key)) {
+            SYSTEM_STDOUT("Generate particle mesh " << cache_file);
+            auto generated_mesh = generator.generateMesh();
+            abm::utilAlveolus::reorderParticleMesh(generated_mesh);
+            mesh = nullptr;
+            if (abm::utilAlveolus::writeParticleMeshToBinary(cache_file, generated_mesh, key)) {
+                mesh = MappedParticleMesh::open(cache_file);
+            }
+            if (mesh == nullptr) {
+                mesh = MappedParticleMesh::fromMesh(generated_mesh, key);
+            }
+        }
+    }
+    return mesh;
+}
+
 void ParticleManager::computeMaxPossibleTimestep() {
     double min_timestep = std::numeric_limits<double>::max();
     double timestep{};
 
+    const double max_dc = *std::max_element(diffusion_constants_.begin(), diffusion_constants_.end());
     for (auto particle: all_particles_){
-        timestep = particle->estimateLowestTimestep(dc_);
+        timestep = particle->estimateLowestTimestep(max_dc);
         if (timestep < min_timestep)
             min_timestep = timestep;
     }
     INFO_STDOUT("Maximum possible timestep with regard to stability of diffusion: " + std::to_string(min_timestep));
 }
 
-void ParticleManager::extractTriangles() {
-    std::vector<std::vector<unsigned int>> triangle_candidates;
-
-    for (auto& particle : all_particles_) {
-        unsigned int id_p = particle->getId();
-        const auto& neighbours = particle->particle_neighbourlist_->getNeighbours();
-        for (size_t i = 0; i < neighbours.size(); ++i) {
-            unsigned int id_i = neighbours[i]->getId();
-            for (size_t j = i + 1; j < neighbours.size(); ++j) {
-                unsigned int id_j = neighbours[j]->getId();
-                const auto& i_neighbours = all_particles_[id_i]->particle_neighbourlist_->getNeighbours();
-                if (std::find(i_neighbours.begin(), i_neighbours.end(), neighbours[j]) != i_neighbours.end()) {
-                    std::vector<unsigned int> sorted{id_p, id_i, id_j};
-                    std::sort(sorted.begin(), sorted.end());
-                    triangle_candidates.emplace_back(sorted);
+void ParticleManager::assembleOperators() {
+    stencil_offsets_.reserve(all_particles_.size() + 1);
+    stencil_offsets_.push_back(0);
+    for (const auto &particle: all_particles_) {
+        if (particle->getIsInSite()) {
+            const auto &neighbours = particle->particle_neighbourlist_->getNeighbours();
+            const auto &distances = particle->particle_neighbourlist_->getDistances();
+            const auto &contact_areas = particle->particle_neighbourlist_->getContactAreas();
+            const auto &prefactors_gradient = particle->particle_neighbourlist_->getPreFactorsGradient();
+            for (size_t k = 0; k < neighbours.size(); ++k) {
+                stencil_columns_.push_back(neighbours[k]->getId());
+                for (auto dc: diffusion_constants_) {
+                    diffusion_prefactors_.push_back(dc * contact_areas[k] / (distances[k] * particle->getArea()));
+                }
+                gradient_weights_.push_back(0.5 * prefactors_gradient[k]);
+                gradient_directions_.push_back(neighbours[k]->getPosition() - particle->getPosition());
+            }
+        }
+        stencil_offsets_.push_back(stencil_columns_.size());
+    }
+    if (single_precision_) {
+        diffusion_prefactors_single_.assign(diffusion_prefactors_.begin(), diffusion_prefactors_.end());
+    }
+    gradients_.resize(all_particles_.size() * number_of_species_);
+    gradient_epochs_.resize(all_particles_.size() * number_of_species_, 0);
+}
+
+const Coordinate3D &ParticleManager::getGradient(unsigned int particle_id, unsigned int species) {
+    if (deferring_steps_ || !deferred_steps_.empty()) synchronizeField();
+    const auto index = particle_id * number_of_species_ + species;
+    if (gradient_epochs_[index] != field_epoch_ && use_spectral_) {
+        gradients_[index] = all_particles_[particle_id]->getIsInSite()
+                            ? getAnalyticGradient(all_particles_[particle_id]->getPosition(), species) : Coordinate3D{};
+        gradient_epochs_[index] = field_epoch_;
+    } else if (gradient_epochs_[index] != field_epoch_) {
+        const double own_concentration = concentrations_[index];
+        Coordinate3D gradient{};
+        for (auto k = stencil_offsets_[particle_id]; k < stencil_offsets_[particle_id + 1]; ++k) {
+            const double concentration_difference =
+                    concentrations_[stencil_columns_[k] * number_of_species_ + species] - own_concentration;
+            gradient += gradient_directions_[k] * (gradient_weights_[k] * concentration_difference);
+        }
+        gradients_[index] = gradient;
+        gradient_epochs_[index] = field_epoch_;
+    }
+    return gradients_[index];
+}
+
+double ParticleManager::getConcentration(unsigned int particle_id, unsigned int species) {
+    if (deferring_steps_ || !deferred_steps_.empty()) synchronizeField();
+    if (use_spectral_ && concentration_epochs_[particle_id] != field_epoch_) {
+        double *concentrations = &concentrations_[particle_id * number_of_species_];
+        if (all_particles_[particle_id]->getIsInSite()) {
+            const auto size = harmonics_->size();
+            const double *values = getHarmonicValues(particle_id);
+            for (unsigned int s = 0; s < number_of_species_; ++s) {
+                const double *coefficients = &spectral_coefficients_[s * size];
+                double concentration = 0;
+                for (size_t p = 0; p < size; ++p) concentration += coefficients[p] * values[p];
+                concentrations[s] = concentration;
+            }
+        }
+        concentration_epochs_[particle_id] = field_epoch_;
+    }
+    return concentrations_[particle_id * number_of_species_ + species];
+}
+
+void ParticleManager::synchronizeConcentrations() {
+    synchronizeField();
+    if (!use_spectral_) return;
+    for (size_t id = 0; id < all_particles_.size(); ++id) {
+        getConcentration(id);
+    }
+}
+
+void ParticleManager::prepareConcurrentReads() {
+    synchronizeConcentrations();
+    for (unsigned int id = 0; id < all_particles_.size(); ++id) {
+        for (unsigned int species = 0; species < number_of_species_; ++species) {
+            getGradient(id, species);
+        }
+    }
+}
+
+Coordinate3D ParticleManager::getAnalyticGradient(const Coordinate3D &position, unsigned int species) {
+    const auto size = harmonics_->size();
+    harmonics_->evaluate(position, harmonic_values_.data(), harmonic_gradients_.data());
+    const double *coefficients = &spectral_coefficients_[species * size];
+    Coordinate3D gradient{};
+    for (size_t p = 0; p < size; ++p) gradient += harmonic_gradients_[p] * coefficients[p];
+    // Gradients of the harmonics are given on the unit sphere
+    return gradient * (1.0 / spectral_geometry_.radius);
+}
+
+void ParticleManager::initializeSpectralField() {
+    spectral_geometry_.radius = site_->getRadius();
+    spectral_geometry_.positions.reserve(all_particles_.size());
+    spectral_geometry_.weights.reserve(all_particles_.size());
+    spectral_geometry_.is_outside.reserve(all_particles_.size());
+    for (const auto &particle: all_particles_) {
+        spectral_geometry_.positions.push_back(particle->getPosition());
+        spectral_geometry_.weights.push_back(particle->getArea() / (spectral_geometry_.radius * spectral_geometry_.radius));
+        spectral_geometry_.is_outside.push_back(!particle->getIsInSite());
+    }
+    // FNV-1a over the quadrature points and the mask, identifies equal geometries of different runs
+    size_t fingerprint = 14695981039346656037ULL;
+    auto add = [&fingerprint](const void *data, size_t bytes) {
+        for (size_t i = 0; i < bytes; ++i) {
+            fingerprint = (fingerprint ^ static_cast<const unsigned char *>(data)[i]) * 1099511628211ULL;
+        }
+    };
+    add(&spectral_geometry_.radius, sizeof(double));
+    for (size_t id = 0; id < all_particles_.size(); ++id) {
+        const bool is_outside = spectral_geometry_.is_outside[id];
+        add(&spectral_geometry_.positions[id], sizeof(Coordinate3D));
+        add(&spectral_geometry_.weights[id], sizeof(double));
+        add(&is_outside, sizeof(bool));
+    }
+    spectral_geometry_.fingerprint = fingerprint;
+
+    const auto size = harmonics_->size();
+    spectral_coefficients_.assign(number_of_species_ * size, 0.0);
+    spectral_source_rates_.assign(number_of_species_ * size, 0.0);
+    harmonic_values_.resize(size);
+    harmonic_gradients_.resize(size);
+    harmonic_value_offsets_.assign(all_particles_.size(), std::numeric_limits<unsigned int>::max());
+    concentration_epochs_.assign(all_particles_.size(), 0);
+}
+
+const double *ParticleManager::getHarmonicValues(unsigned int particle_id) {
+    // Only particles that are read or changed (near AMs and sources) are evaluated, and only once
+    const auto size = harmonics_->size();
+    if (harmonic_value_offsets_[particle_id] == std::numeric_limits<unsigned int>::max()) {
+        harmonic_value_offsets_[particle_id] = harmonic_value_cache_.size() / size;
+        harmonic_value_cache_.resize(harmonic_value_cache_.size() + size);
+        harmonics_->evaluate(spectral_geometry_.positions[particle_id], &harmonic_value_cache_[harmonic_value_cache_.size() - size]);
+    }
+    return &harmonic_value_cache_[static_cast<size_t>(harmonic_value_offsets_[particle_id]) * size];
+}
+
+void ParticleManager::projectSecretionSources(double time_delta) {
+    // Per-grid secretion rates are amounts per timestep, the spectral sources are rates per time
+    const auto size = harmonics_->size();
+    std::fill(spectral_source_rates_.begin(), spectral_source_rates_.end(), 0.0);
+    for (auto aec_id: secreting_aecs_) {
+        const double *secretion_rates = &aec_secretion_rate_per_grid_[aec_id * number_of_species_];
+        for (auto id: secretion_sources_[aec_id]) {
+            const double *values = getHarmonicValues(id);
+            for (unsigned int s = 0; s < number_of_species_; ++s) {
+                const double weight = secretion_rates[s] / time_delta * spectral_geometry_.weights[id];
+                if (weight == 0) continue;
+                double *source_rates = &spectral_source_rates_[s * size];
+                for (size_t p = 0; p < size; ++p) source_rates[p] += weight * values[p];
+            }
+        }
+    }
+    spectral_sources_changed_ = false;
+}
+
+void ParticleManager::applySpectralStep(double timestep) {
+    const auto size = harmonics_->size();
+    // Changes of the particles (uptake by AMs) are projected onto the harmonics
+    for (size_t id = 0; id < all_particles_.size(); ++id) {
+        double *changes = &concentration_changes_[id * number_of_species_];
+        if (std::all_of(changes, changes + number_of_species_, [](double change) { return change == 0.0; })) continue;
+        if (all_particles_[id]->getIsInSite()) {
+            const double *values = getHarmonicValues(id);
+            for (unsigned int s = 0; s < number_of_species_; ++s) {
+                const double weight = changes[s] * spectral_geometry_.weights[id];
+                double *coefficients = &spectral_coefficients_[s * size];
+                for (size_t p = 0; p < size; ++p) coefficients[p] += weight * values[p];
+            }
+        }
+        std::fill(changes, changes + number_of_species_, 0.0);
+    }
+
+    if (spectral_step_pending_) {
+        if (spectral_dt_ != timestep) {
+            spectral_dt_ = timestep;
+            spectral_propagators_.clear();
+            for (unsigned int s = 0; s < number_of_species_; ++s) {
+                spectral_propagators_.push_back(SpectralPropagator::get(spectral_geometry_, *harmonics_,
+                                                                        diffusion_constants_[s], timestep,
+                                                                        spectral_penalty_));
+            }
+        }
+        for (unsigned int s = 0; s < number_of_species_; ++s) {
+            spectral_propagators_[s]->step(&spectral_coefficients_[s * size], &spectral_source_rates_[s * size]);
+        }
+        spectral_step_pending_ = false;
+    } else {
+        // Without diffusion in this step (steady state), secretion is only added as for the particles
+        for (size_t i = 0; i < spectral_coefficients_.size(); ++i) {
+            spectral_coefficients_[i] += timestep * spectral_source_rates_[i];
+        }
+    }
+}
+
+void ParticleManager::initializeActiveSet() {
+    // Transposed neighbourhood, mesh files do not guarantee symmetric neighbour lists
+    reverse_neighbour_offsets_.assign(all_particles_.size() + 1, 0);
+    for (const auto &particle: all_particles_) {
+        for (auto neighbour: particle->particle_neighbourlist_->getNeighbours()) {
+            ++reverse_neighbour_offsets_[neighbour->getId() + 1];
+        }
+    }
+    for (size_t id = 0; id < all_particles_.size(); ++id) {
+        reverse_neighbour_offsets_[id + 1] += reverse_neighbour_offsets_[id];
+    }
+    reverse_neighbour_ids_.resize(reverse_neighbour_offsets_.back());
+    auto next_entry = reverse_neighbour_offsets_;
+    for (const auto &particle: all_particles_) {
+        for (auto neighbour: particle->particle_neighbourlist_->getNeighbours()) {
+            reverse_neighbour_ids_[next_entry[neighbour->getId()]++] = particle->getId();
+        }
+    }
+
+    number_of_particles_in_site_ = std::count_if(all_particles_.begin(), all_particles_.end(),
+                                                 [](const auto &particle) { return particle->getIsInSite(); });
+    is_active_.assign(all_particles_.size(), false);
+    active_particles_.reserve(number_of_particles_in_site_);
+}
+
+void ParticleManager::activateParticle(unsigned int particle_id) {
+    if (!is_active_[particle_id] && all_particles_[particle_id]->getIsInSite()) {
+        is_active_[particle_id] = true;
+        active_particles_.push_back(particle_id);
+        front_particles_.push_back(particle_id);
+    }
+}
+
+void ParticleManager::expandActiveSet() {
+    // The previous front is moved to the scratch buffer, both keep their capacity between timesteps
+    auto &front_particles = previous_front_particles_;
+    front_particles.clear();
+    front_particles.swap(front_particles_);
+    for (auto id: front_particles) {
+        const auto begin = diffusion_field_ + id * number_of_species_;
+        if (std::any_of(begin, begin + number_of_species_,
+                        [this](double concentration) { return std::abs(concentration) > active_set_epsilon_; })) {
+            for (auto k = reverse_neighbour_offsets_[id]; k < reverse_neighbour_offsets_[id + 1]; ++k) {
+                activateParticle(reverse_neighbour_ids_[k]);
+            }
+        } else {
+            front_particles_.push_back(id);
+        }
+    }
+
+    if (active_particles_.size() == number_of_particles_in_site_) {
+        // Active set covers the whole mesh, fall back to sweeping all particles
+        DEBUG_STDOUT("Active set covers all " << number_of_particles_in_site_ << " particles");
+        use_active_set_ = false;
+        std::vector<unsigned int>().swap(active_particles_);
+        std::vector<unsigned int>().swap(front_particles_);
+        std::vector<unsigned int>().swap(previous_front_particles_);
+        std::vector<unsigned int>().swap(reverse_neighbour_offsets_);
+        std::vector<unsigned int>().swap(reverse_neighbour_ids_);
+    }
+}
+
+void ParticleManager::doDiffusion(double timestep) {
+    if (deferring_steps_) return; // the whole step is recorded when the changes are applied
+    if (use_spectral_) {
+        // Diffusion, secretion and uptake are integrated together when the changes are applied
+        spectral_step_pending_ = true;
+        return;
+    }
+    if (use_superposition_) {
+        // Step responses are only valid for a fixed timestep and as long as they fit into the memory limit
+        if (superposition_dt_ == 0) superposition_dt_ = timestep;
+        bool available = superposition_dt_ == timestep;
+        for (auto &term: secretion_terms_) {
+            available = available && term.response->ensureStep(diffusion_step_ + 1 - term.start_step);
+        }
+        if (!available) stopSuperposition();
+    }
+
+    // Number of species as template parameter for the common cases, such that the species loops are unrolled
+    auto diffuse = [&](auto species_tag) {
+        auto diffuse_particle = [&](size_t id) {
+            constexpr unsigned int fixed_number_of_species = decltype(species_tag)::value;
+            if (single_precision_) {
+                diffuseParticle<fixed_number_of_species>(id, timestep, field_single_.data(),
+                                                         diffusion_prefactors_single_.data(), diffusion_changes_.data());
+                if (monitor_steps_left_ > 0) {
+                    diffuseParticle<fixed_number_of_species>(id, timestep, shadow_field_.data(),
+                                                             diffusion_prefactors_.data(), shadow_changes_.data());
+                }
+            } else {
+                diffuseParticle<fixed_number_of_species>(id, timestep, static_cast<const double *>(diffusion_field_),
+                                                         diffusion_prefactors_.data(),
+                                                         concurrent_diffusion_ ? diffusion_changes_.data()
+                                                                               : concentration_changes_.data());
+            }
+        };
+        if (use_active_set_) {
+            for (auto id: active_particles_) {
+                diffuse_particle(id);
+            }
+        } else {
+            for (size_t id = 0; id < all_particles_.size(); ++id) {
+                diffuse_particle(id);
+            }
+        }
+    };
+    switch (number_of_species_) {
+        case 1:
+            diffuse(std::integral_constant<unsigned int, 1>{});
+            break;
+        case 2:
+            diffuse(std::integral_constant<unsigned int, 2>{});
+            break;
+        case 3:
+            diffuse(std::integral_constant<unsigned int, 3>{});
+            break;
+        default:
+            diffuse(std::integral_constant<unsigned int, 0>{});
+    }
+}
+
+void ParticleManager::setFieldConsumed(bool consumed) {
+    if (consumed) synchronizeField();
+    deferring_steps_ = demand_driven_diffusion_ && !consumed;
+}
+
+void ParticleManager::synchronizeField() {
+    // The field is read during the current step (e.g. by an AM that entered it), which is not deferred anymore. The
+    // changes of the readers are applied at the end of the step, after the replayed steps and as without deferring.
+    deferring_steps_ = false;
+    if (deferred_steps_.empty()) return;
+    DEBUG_STDOUT("Replay deferred steps of the molecule field");
+    std::vector<DeferredSteps> deferred_steps;
+    deferred_steps.swap(deferred_steps_);
+    for (const auto &steps: deferred_steps) {
+        for (size_t step = 0; step < steps.count; ++step) {
+            // Same order of operations as in AlveoleSite::doAgentDynamics
+            doDiffusion(steps.timestep);
+            if (concurrent_diffusion_) mergeDiffusionChanges();
+            const auto &secretion = *steps.secretion;
+            for (size_t i = 0; i < secretion.ids.size(); ++i) {
+                double *concentration_changes = &concentration_changes_[secretion.ids[i] * number_of_species_];
+                for (unsigned int species = 0; species < number_of_species_; ++species) {
+                    concentration_changes[species] += secretion.rates[i * number_of_species_ + species];
+                }
+            }
+            applyConcentrationChanges(steps.timestep);
+        }
+    }
+}
+
+void ParticleManager::recordDeferredStep(double timestep) {
+    if (secretion_snapshot_ == nullptr || secretion_snapshot_->version != secretion_sources_version_) {
+        auto snapshot = std::make_shared<SecretionSnapshot>();
+        for (auto aec_id: secreting_aecs_) {
+            for (auto id: secretion_sources_[aec_id]) {
+                snapshot->ids.push_back(id);
+                snapshot->rates.insert(snapshot->rates.end(), &aec_secretion_rate_per_grid_[aec_id * number_of_species_],
+                                       &aec_secretion_rate_per_grid_[(aec_id + 1) * number_of_species_]);
+            }
+        }
+        snapshot->version = secretion_sources_version_;
+        secretion_snapshot_ = snapshot;
+    }
+    if (!deferred_steps_.empty() && deferred_steps_.back().timestep == timestep &&
+        deferred_steps_.back().secretion == secretion_snapshot_) {
+        ++deferred_steps_.back().count;
+    } else {
+        deferred_steps_.push_back({timestep, secretion_snapshot_, 1});
+    }
+}
+
+void ParticleManager::mergeDiffusionChanges() {
+    // The single precision field applies the diffusion changes together with the changes of the agents anyway
+    if (single_precision_) return;
+    // Diffusion changes are added after the changes of the agents, as if diffusion had run after the agents
+    auto merge = [this](size_t id) {
+        for (auto index = id * number_of_species_; index < (id + 1) * number_of_species_; ++index) {
+            concentration_changes_[index] += diffusion_changes_[index];
+            diffusion_changes_[index] = 0;
+        }
+    };
+    if (use_active_set_) {
+        for (auto id: active_particles_) merge(id);
+    } else {
+        for (size_t id = 0; id < all_particles_.size(); ++id) merge(id);
+    }
+}
+
+void ParticleManager::discardDiffusionChanges() {
+    std::fill(diffusion_changes_.begin(), diffusion_changes_.end(), 0.0);
+    std::fill(shadow_changes_.begin(), shadow_changes_.end(), 0.0);
+}
+
+template<unsigned int fixed_number_of_species, typename Real>
+void ParticleManager::diffuseParticle(size_t particle_id, double timestep, const Real *field, const Real *prefactors,
+                                      double *changes) {
+    constexpr unsigned int max_species = fixed_number_of_species > 0 ? fixed_number_of_species : max_number_of_species;
+    const unsigned int number_of_species = fixed_number_of_species > 0 ? fixed_number_of_species : number_of_species_;
+    const auto begin = stencil_offsets_[particle_id], end = stencil_offsets_[particle_id + 1];
+    if (begin == end) return; //only "in site" grid points are used for the calculations
+
+    std::array<Real, max_species> conc_change_diffusion{}, current_own_prefactor{};
+    for (auto k = begin; k < end; ++k) {
+        const Real *neighbour_concentrations = &field[stencil_columns_[k] * number_of_species];
+        const Real *prefactors_pse = &prefactors[k * number_of_species];
+        for (unsigned int s = 0; s < number_of_species; ++s) {
+            conc_change_diffusion[s] += neighbour_concentrations[s] * prefactors_pse[s];
+            current_own_prefactor[s] += prefactors_pse[s];
+        }
+    }
+    const Real *own_concentrations = &field[particle_id * number_of_species];
+    double *own_changes = &changes[particle_id * number_of_species];
+    for (unsigned int s = 0; s < number_of_species; ++s) {
+        conc_change_diffusion[s] -= own_concentrations[s] * current_own_prefactor[s];
+        conc_change_diffusion[s] *= static_cast<Real>(timestep);
+        own_changes[s] += conc_change_diffusion[s];
+    }
+}
+
+void ParticleManager::applySinglePrecisionChanges() {
+    auto apply = [this](size_t id) {
+        if (!all_particles_[id]->getIsInSite()) return; //only "in site" grid points are used for the calculations
+        for (auto index = id * number_of_species_; index < (id + 1) * number_of_species_; ++index) {
+            const double change = concentration_changes_[index] + diffusion_changes_[index];
+            if (monitor_steps_left_ > 0) {
+                shadow_field_[index] += concentration_changes_[index] + shadow_changes_[index];
+                shadow_changes_[index] = 0;
+            }
+            // Kahan summation, the compensation holds the lost low order part of the concentration
+            const float y = static_cast<float>(change) - field_compensation_[index];
+            const float t = field_single_[index] + y;
+            field_compensation_[index] = (t - field_single_[index]) - y;
+            field_single_[index] = t;
+            concentrations_[index] = static_cast<double>(t) - static_cast<double>(field_compensation_[index]);
+            concentration_changes_[index] = 0;
+            diffusion_changes_[index] = 0;
+        }
+    };
+    if (use_active_set_) {
+        for (auto id: active_particles_) apply(id);
+    } else {
+        for (size_t id = 0; id < all_particles_.size(); ++id) apply(id);
+    }
+}
+
+void ParticleManager::updatePrecisionMonitor() {
+    if (monitor_steps_left_ > 0) {
+        if (--monitor_steps_left_ == 0) {
+            double deviation = 0;
+            for (unsigned int species = 0; species < number_of_species_; ++species) {
+                double max_difference = 0, max_concentration = 0;
+                for (auto index = species; index < shadow_field_.size(); index += number_of_species_) {
+                    max_difference = std::max(max_difference, std::abs(concentrations_[index] - shadow_field_[index]));
+                    max_concentration = std::max(max_concentration, std::abs(shadow_field_[index]));
+                }
+                if (max_concentration > 0) deviation = std::max(deviation, max_difference / max_concentration);
+            }
+            DEBUG_STDOUT("Relative deviation of single precision field after " << monitor_window_ << " steps: " << deviation);
+            if (deviation > max_precision_deviation_) {
+                max_precision_deviation_ = deviation;
+                INFO_STDOUT("Maximum relative deviation of single precision field: " << max_precision_deviation_);
+            }
+        }
+    } else if (monitor_interval_ > 0 && diffusion_step_ % monitor_interval_ == 0) {
+        // Start a shadow window from the current state
+        shadow_field_ = concentrations_;
+        shadow_changes_.assign(concentrations_.size(), 0.0);
+        monitor_steps_left_ = monitor_window_;
+    }
+}
+
+void ParticleManager::applyConcentrationChanges(double timestep) {
+    if (deferring_steps_) {
+        recordDeferredStep(timestep);
+        return;
+    }
+    if (single_precision_) {
+        applySinglePrecisionChanges();
+        if (use_active_set_) expandActiveSet();
+        ++diffusion_step_;
+        updatePrecisionMonitor();
+    } else if (use_superposition_) {
+        // All changes (uptake and diffusion of the correction) belong to the correction field
+        for (size_t id = 0; id < all_particles_.size(); ++id) {
+            if (!all_particles_[id]->getIsInSite()) continue;
+            bool changed = false;
+            for (unsigned int species = 0; species < number_of_species_; ++species) {
+                const auto index = id * number_of_species_ + species;
+                changed = changed || concentration_changes_[index] != 0.0;
+                correction_field_[index] += concentration_changes_[index];
+                concentration_changes_[index] = 0;
+            }
+            if (changed && use_active_set_) activateParticle(id);
+        }
+        if (use_active_set_) expandActiveSet();
+        ++diffusion_step_;
+        materializeConcentrations();
+    } else if (use_spectral_) {
+        applySpectralStep(timestep);
+    } else if (use_active_set_) {
+        for (auto id: active_particles_) {
+            all_particles_[id]->applyConcentrationChange(timestep);
+        }
+        expandActiveSet();
+    } else {
+        for (const auto &particle: all_particles_) {
+            particle->applyConcentrationChange(timestep);
+        }
+    }
+    // Invalidates all cached gradients (and concentrations of the spectral solver)
+    ++field_epoch_;
+}
+
+void ParticleManager::materializeConcentrations() {
+    // A stopped term only diffuses from now on, like the correction field. Once the responses at its start and stop are
+    // both extrapolated, the term is moved to the correction field (the concentrations are the buffer, they are
+    // overwritten below), such that the list of terms does not grow and unused responses are released.
+    const auto converged = [this](const SecretionTerm &term) {
+        return term.stop_step <= diffusion_step_ && term.response->isExtrapolated(diffusion_step_ - term.stop_step);
+    };
+    if (std::any_of(secretion_terms_.begin(), secretion_terms_.end(), converged)) {
+        std::fill(concentrations_.begin(), concentrations_.end(), 0.0);
+        for (const auto &term: secretion_terms_) {
+            if (!converged(term)) continue;
+            term.response->addStep(diffusion_step_ - term.start_step, term.rate, &concentrations_[term.species], number_of_species_);
+            term.response->addStep(diffusion_step_ - term.stop_step, -term.rate, &concentrations_[term.species], number_of_species_);
+        }
+        secretion_terms_.erase(std::remove_if(secretion_terms_.begin(), secretion_terms_.end(), converged),
+                               secretion_terms_.end());
+        for (size_t id = 0; id < all_particles_.size(); ++id) {
+            bool changed = false;
+            for (unsigned int species = 0; species < number_of_species_; ++species) {
+                const auto index = id * number_of_species_ + species;
+                changed = changed || concentrations_[index] != 0.0;
+                correction_field_[index] += concentrations_[index];
+            }
+            if (changed && use_active_set_) activateParticle(id);
+        }
+        if (use_active_set_) expandActiveSet();
+    }
+
+    std::copy(correction_field_.begin(), correction_field_.end(), concentrations_.begin());
+    for (const auto &term: secretion_terms_) {
+        term.response->addStep(diffusion_step_ - term.start_step, term.rate, &concentrations_[term.species], number_of_species_);
+        if (term.stop_step <= diffusion_step_) {
+            term.response->addStep(diffusion_step_ - term.stop_step, -term.rate, &concentrations_[term.species], number_of_species_);
+        }
+    }
+}
+
+void ParticleManager::startSecretionTerms() {
+    for (auto aec_id: secreting_aecs_) {
+        for (unsigned int species = 0; species < number_of_species_; ++species) {
+            const double rate = aec_secretion_rate_per_grid_[aec_id * number_of_species_ + species];
+            if (rate == 0) continue;
+            if (species_stencils_[species] == nullptr) {
+                auto stencil = std::make_shared<DiffusionStencil>();
+                stencil->offsets = stencil_offsets_;
+                stencil->columns = stencil_columns_;
+                stencil->prefactors.reserve(stencil_columns_.size());
+                for (size_t k = 0; k < stencil_columns_.size(); ++k) {
+                    stencil->prefactors.push_back(diffusion_prefactors_[k * number_of_species_ + species]);
+                }
+                stencil->reverse_offsets.assign(all_particles_.size() + 1, 0);
+                for (auto column: stencil_columns_) ++stencil->reverse_offsets[column + 1];
+                for (size_t id = 0; id < all_particles_.size(); ++id) {
+                    stencil->reverse_offsets[id + 1] += stencil->reverse_offsets[id];
+                }
+                stencil->reverse_columns.resize(stencil_columns_.size());
+                auto next_entry = stencil->reverse_offsets;
+                for (size_t id = 0; id < all_particles_.size(); ++id) {
+                    for (auto k = stencil_offsets_[id]; k < stencil_offsets_[id + 1]; ++k) {
+                        stencil->reverse_columns[next_entry[stencil_columns_[k]]++] = id;
+                    }
                 }
+                stencil->number_of_particles_in_site = std::count_if(
+                        all_particles_.begin(), all_particles_.end(),
+                        [](const auto &particle) { return particle->getIsInSite(); });
+                stencil->computeFingerprint();
+                species_stencils_[species] = stencil;
+            }
+            auto response = SecretionResponse::get(species_stencils_[species], superposition_dt_,
+                                                   secretion_sources_[aec_id], superposition_tolerance_);
+            response->ensureStep(1);
+
+            // A source that was only stopped by the cleanup of this step continues
+            auto term = std::find_if(secretion_terms_.begin(), secretion_terms_.end(), [&](const SecretionTerm &t) {
+                return t.response == response && t.species == species && t.rate == rate && t.stop_step == diffusion_step_;
+            });
+            if (term != secretion_terms_.end()) {
+                term->stop_step = std::numeric_limits<size_t>::max();
+            } else {
+                secretion_terms_.push_back({response, aec_id, species, rate, diffusion_step_, std::numeric_limits<size_t>::max()});
             }
         }
     }
+}
 
-    std::sort(triangle_candidates.begin(), triangle_candidates.end(), abm::util::compareTriple);
-    triangle_candidates.erase(std::unique(triangle_candidates.begin(), triangle_candidates.end()), triangle_candidates.end());
+void ParticleManager::stopSuperposition() {
+    // The concentrations of the last step are complete, continue with the explicit integration of the whole field
+    INFO_STDOUT("Superposition of secretion sources not possible anymore, continue with explicit diffusion");
+    use_superposition_ = false;
+    use_active_set_ = false;
+    diffusion_field_ = concentrations_.data();
+    secretion_terms_.clear();
+    std::vector<double>().swap(correction_field_);
+}
 
-    for (const auto& sorted: triangle_candidates) {
+void ParticleManager::extractTriangles() {
+    triangles_.reserve(mesh_->getNumberOfTriangles());
+    for (size_t i = 0; i < mesh_->getNumberOfTriangles(); ++i) {
+        const auto &triangle = mesh_->getTriangles()[i];
         TRIANGLE3D newTriangle{};
-        newTriangle.outside = !all_particles_[sorted[0]]->getIsInSite() and !all_particles_[sorted[1]]->getIsInSite() and !all_particles_[sorted[2]]->getIsInSite();
-        newTriangle.neighbourIds[0] = sorted[0], newTriangle.neighbourIds[1] = sorted[1], newTriangle.neighbourIds[2] = sorted[2];
+        newTriangle.outside = !all_particles_[triangle[0]]->getIsInSite() and !all_particles_[triangle[1]]->getIsInSite() and !all_particles_[triangle[2]]->getIsInSite();
+        newTriangle.neighbourIds[0] = triangle[0], newTriangle.neighbourIds[1] = triangle[1], newTriangle.neighbourIds[2] = triangle[2];
         triangles_.emplace_back(newTriangle);
     }
-
 }
 
 void ParticleManager::inputOfParticles(double time_delta, double current_time) {
@@ -150,73 +855,119 @@ void ParticleManager::inputOfParticles(double time_delta, double current_time) {
 }
 
 void ParticleManager::cleanUpAllParticles() {
-    aec_particles_.clear();
+    for (auto &term: secretion_terms_) {
+        term.stop_step = std::min(term.stop_step, diffusion_step_);
+    }
+    for (auto aec_id: secreting_aecs_) {
+        for (auto id: secretion_sources_[aec_id]) {
+            is_secreting_particle_[id] = false;
+        }
+        secretion_sources_[aec_id].clear();
+    }
+    secreting_aecs_.clear();
+    ++secretion_sources_version_;
+    spectral_sources_changed_ = true;
 }
 
-void ParticleManager::insertConcentrationAtArea(double time_delta, double current_time) {
-    if (aec_particles_.empty() && s_aec_ > 0) {
-        aec_particles_cells_.clear();
-        std::fill(sum_area_aec_particles_cells_.begin(), sum_area_aec_particles_cells_.end(), 0.0);
-        std::fill(aec_secretion_rate_per_grid_.begin(), aec_secretion_rate_per_grid_.end(), 0.0);
-
-        std::vector<Agent *> all_fungal_cell = site_->getAgentManager()->getAllFungalCells();
-
-        int jump_over_spheres = 3;
-        for (auto fungal_cell: all_fungal_cell) {
-            auto cell_state = fungal_cell->getCurrentCellState()->getStateName();
-
-            bool start_secreting = (current_time > start_chemotaxis_) && !abm::util::isSubstring(cell_state, "FungalOnAEC");
-
-            if (!fungal_cell->isDeleted() && dynamic_cast<FungalCellAlveolus*>(fungal_cell)->isActive() && start_secreting){
-                for (size_t i=0; i<fungal_cell->getSurface()->getAllSpheresOfThis().size(); i = i + jump_over_spheres) {
-                    auto cell_sphere = fungal_cell->getSurface()->getAllSpheresOfThis()[i];
-                    auto connected_aec = site_->overAECT1(abm::util::toSphericCoordinates(cell_sphere->getPosition()));
-                    bool is_over_aec1 = connected_aec.first;
-                    int obstacle_aec_id = connected_aec.second;
-                    std::vector<unsigned int> potential_aec_particles;
-                    bool aec_is_alive = true;
-                    if (is_over_aec1) {
-                        particle_balloon_list_->setThreshold(site_->getRadiusAEC1());
-                        aec_is_alive = site_->getAECT1()[obstacle_aec_id]->alive;
-                    } else {
-                        particle_balloon_list_->setThreshold(site_->getLengthAEC2() * sqrt(2.0)/2.0);
-                        aec_is_alive = site_->getAECT2()[obstacle_aec_id - site_->getAECT1().size()]->alive;
-                    }
-                    particle_balloon_list_->getInteractions(cell_sphere->getPosition(), potential_aec_particles);
-
-                    for (auto index: potential_aec_particles) {
-                        auto p = all_particles_[index];
-                        if (site_->containsPosition(p->getPosition())) {
-                        auto associated_aec = p->associated_type2_aec_ < 0 ? p->associated_type1_aec_ : p->associated_type2_aec_;
-                        if (associated_aec == obstacle_aec_id and aec_is_alive) {
-                                if (std::find(aec_particles_.begin(), aec_particles_.end(), p) ==
-                                    aec_particles_.end()) {
-                                    aec_particles_cells_.push_back(obstacle_aec_id);
-                                    sum_area_aec_particles_cells_[obstacle_aec_id] += p->getArea();
-                                    aec_particles_.push_back(p);
-                                }
-                            }
-                        }
+void ParticleManager::initializeSecretionSources() {
+    // A particle can only secrete for the aec it is associated with, and only if it is located in the site
+    secretion_aec_of_particle_.resize(all_particles_.size(), -1);
+    for (const auto &p: all_particles_) {
+        if (site_->containsPosition(p->getPosition())) {
+            secretion_aec_of_particle_[p->getId()] = p->associated_type2_aec_ < 0 ? p->associated_type1_aec_ : p->associated_type2_aec_;
+        }
+    }
+    is_secreting_particle_.resize(all_particles_.size(), false);
+    secretion_sources_.resize(number_aecs_);
+}
+
+void ParticleManager::updateSecretionSources(double time_delta, double current_time) {
+    std::fill(sum_area_aec_particles_cells_.begin(), sum_area_aec_particles_cells_.end(), 0.0);
+    std::fill(aec_secretion_rate_per_grid_.begin(), aec_secretion_rate_per_grid_.end(), 0.0);
+
+    std::vector<Agent *> all_fungal_cell = site_->getAgentManager()->getAllFungalCells();
+
+    int jump_over_spheres = 3;
+    std::vector<unsigned int> potential_aec_particles;
+    static const int fungal_on_aec = abm::util::Names::intern("FungalOnAEC");
+    for (auto fungal_cell: all_fungal_cell) {
+        auto cell_state = fungal_cell->getCurrentCellState()->getStateId();
+
+        bool start_secreting = (current_time > start_chemotaxis_) && !abm::util::Names::related(cell_state, fungal_on_aec);
+
+        if (!fungal_cell->isDeleted() && dynamic_cast<FungalCellAlveolus*>(fungal_cell)->isActive() && start_secreting){
+            for (size_t i=0; i<fungal_cell->getSurface()->getAllSpheresOfThis().size(); i = i + jump_over_spheres) {
+                auto cell_sphere = fungal_cell->getSurface()->getAllSpheresOfThis()[i];
+                auto connected_aec = site_->overAECT1(abm::util::toSphericCoordinates(cell_sphere->getPosition()));
+                bool is_over_aec1 = connected_aec.first;
+                int obstacle_aec_id = connected_aec.second;
+                bool aec_is_alive = true;
+                if (is_over_aec1) {
+                    particle_balloon_list_->setThreshold(site_->getRadiusAEC1());
+                    aec_is_alive = site_->getAECT1()[obstacle_aec_id]->alive;
+                } else {
+                    particle_balloon_list_->setThreshold(site_->getLengthAEC2() * sqrt(2.0)/2.0);
+                    aec_is_alive = site_->getAECT2()[obstacle_aec_id - site_->getAECT1().size()]->alive;
+                }
+                if (!aec_is_alive) continue;
+
+                potential_aec_particles.clear();
+                particle_balloon_list_->getInteractions(cell_sphere->getPosition(), potential_aec_particles);
+                for (auto index: potential_aec_particles) {
+                    if (secretion_aec_of_particle_[index] == obstacle_aec_id && !is_secreting_particle_[index]) {
+                        if (secretion_sources_[obstacle_aec_id].empty()) secreting_aecs_.push_back(obstacle_aec_id);
+                        secretion_sources_[obstacle_aec_id].push_back(index);
+                        is_secreting_particle_[index] = true;
+                        sum_area_aec_particles_cells_[obstacle_aec_id] += all_particles_[index]->getArea();
+                        if (use_active_set_) activateParticle(index);
                     }
                 }
             }
         }
+    }
 
-        for (int i = 0; i < number_aecs_; i++) {
-            if (sum_area_aec_particles_cells_[i] > 0) {
-                DEBUG_STDOUT("Cell " << i << " with an area of " << sum_area_aec_particles_cells_[i]);
-                double secretion_rate = (s_aec_ /  sum_area_aec_particles_cells_[i]) * time_delta;
-                aec_secretion_rate_per_grid_[i] = secretion_rate;
+    for (int i = 0; i < number_aecs_; i++) {
+        if (sum_area_aec_particles_cells_[i] > 0) {
+            DEBUG_STDOUT("Cell " << i << " with an area of " << sum_area_aec_particles_cells_[i]);
+            for (unsigned int species = 0; species < number_of_species_; ++species) {
+                double secretion_rate = (secretion_per_cell_[species] /  sum_area_aec_particles_cells_[i]) * time_delta;
+                aec_secretion_rate_per_grid_[i * number_of_species_ + species] = secretion_rate;
                 DEBUG_STDOUT("The cell gets an per-grid secretion rate of " + std::to_string(secretion_rate));
             }
         }
     }
+}
+
+void ParticleManager::insertConcentrationAtArea(double time_delta, double current_time) {
+    // The secretion sources are only determined anew after a cleanup, i.e. if conidia germinate or are removed
+    if (secreting_aecs_.empty() && s_aec_ > 0 && current_time > start_chemotaxis_) {
+        updateSecretionSources(time_delta, current_time);
+        if (use_superposition_) startSecretionTerms();
+        ++secretion_sources_version_;
+        spectral_sources_changed_ = true;
+    }
+    if (use_spectral_ && spectral_sources_changed_) projectSecretionSources(time_delta);
+    if (use_superposition_ || use_spectral_ || deferring_steps_) return;
 
-    for (size_t i = 0; i < aec_particles_.size(); i++) {
-        int particle_cell = aec_particles_cells_[i];
-        aec_particles_[i]->addConcentrationChange(aec_secretion_rate_per_grid_[particle_cell]);
+    for (auto aec_id: secreting_aecs_) {
+        const double *secretion_rates = &aec_secretion_rate_per_grid_[aec_id * number_of_species_];
+        for (auto id: secretion_sources_[aec_id]) {
+            double *concentration_changes = &concentration_changes_[id * number_of_species_];
+            for (unsigned int species = 0; species < number_of_species_; ++species) {
+                concentration_changes[species] += secretion_rates[species];
+            }
+        }
     }
+}
 
+std::vector<std::shared_ptr<Particle>> ParticleManager::getAECParticles() {
+    std::vector<std::shared_ptr<Particle>> aec_particles;
+    for (auto aec_id: secreting_aecs_) {
+        for (auto id: secretion_sources_[aec_id]) {
+            aec_particles.push_back(all_particles_[id]);
+        }
+    }
+    return aec_particles;
 }
 
 bool ParticleManager::steadyStateReached(double current_time) {
@@ -14,6 +14,9 @@
 #include "apps/alveolus/io_utils_alveolus.h"
 #include "apps/alveolus/AlveoleSite.h"
 #include "Particle.h"
+#include "ParticleMesh.h"
+#include "SecretionResponse.h"
+#include "SpectralDiffusion.h"
 #include "StaticBalloonList.h"
 
 class AlveoleSite;
@@ -25,44 +28,240 @@ struct TRIANGLE3D {
 
 class ParticleManager {
 public:
+    static constexpr unsigned int max_number_of_species = 16;
+
     ParticleManager(abm::utilAlveolus::ParticleManagerParameters parameters, Site *site);
 
     void initializeParticles(std::string filename);
 
-    std::vector<std::shared_ptr<Particle>> getAllParticles() { return all_particles_; };
-    std::vector<std::shared_ptr<Particle>> getAECParticles() { return aec_particles_; };
+    const std::vector<std::shared_ptr<Particle>> &getAllParticles() { return all_particles_; };
+    /// Particles are stored in Morton order of the mesh, outputs refer to the ids of the mesh input
+    unsigned int getOriginalId(unsigned int particle_id) const { return mesh_->getOriginalIds()[particle_id]; };
+    const std::vector<unsigned int> &getParticlesInInputOrder() const { return particles_in_input_order_; };
+    std::vector<std::shared_ptr<Particle>> getAECParticles();
 
     std::vector<TRIANGLE3D> getTriangles() { return triangles_; };
     double getDiffusionCoefficient() {return dc_; };
+    /// Species 0 is the chemokine, further species are given by additional_species in the config
+    unsigned int getNumberOfSpecies() const { return number_of_species_; };
+    double getUptakeRate(unsigned int species) const { return uptake_rates_[species]; };
 
     bool steadyStateReached(double current_time);
     void inputOfParticles(double time_delta, double current_time);
     void setCleanChemotaxis(bool val) { clean_chemotaxis_ = val; };
+    void doDiffusion(double timestep);
+    void applyConcentrationChanges(double timestep);
+
+    /// True if doDiffusion may run concurrently with the agents. The agents read the field and post their changes,
+    /// diffusion writes its changes into a separate buffer that is merged (or discarded) after both are finished.
+    bool diffusesConcurrently() const { return concurrent_diffusion_ && !deferring_steps_; };
+    void mergeDiffusionChanges();
+    void discardDiffusionChanges();
+
+    /*!
+     * Declares if the field is read by agents in the current step. Steps without consumers are only recorded (timestep
+     * and secretion sources) and replayed exactly as soon as the field is read again.
+     * @param consumed Bool if agents interact with the molecules in the current step
+     */
+    void setFieldConsumed(bool consumed);
+    /// Replays all deferred steps and stops deferring the current step, called by all readers of the field
+    void synchronizeField();
+
+    /*!
+     * Returns the concentration gradient at a particle, rows of the gradient operator are evaluated lazily and
+     * cached until the concentrations are updated by applyConcentrationChanges
+     * @param particle_id Unsigned int that contains the id of the particle
+     * @param species Unsigned int that contains the index of the molecule species
+     * @return Coordinate3D that contains the gradient (zero for particles outside of the site)
+     */
+    const Coordinate3D &getGradient(unsigned int particle_id, unsigned int species = 0);
+
+    /*!
+     * Returns the concentration at a particle, for the spectral solver it is evaluated lazily from the coefficients
+     * @param particle_id Unsigned int that contains the id of the particle
+     * @param species Unsigned int that contains the index of the molecule species
+     * @return Double that contains the concentration
+     */
+    double getConcentration(unsigned int particle_id, unsigned int species = 0);
+    /// Evaluates the concentrations of all particles, needed before the particles are read directly
+    void synchronizeConcentrations();
+    /// Replays deferred steps and evaluates the cached concentrations and gradients of all particles, afterwards
+    /// getConcentration and getGradient only read until the field changes (agents updated in parallel)
+    void prepareConcurrentReads();
+
+    /// True if the gradient can be evaluated at any position of the site (spectral solver)
+    bool hasAnalyticGradient() const { return use_spectral_; };
+    /*!
+     * Returns the gradient of the field on the sphere of the site in the direction of a position (spectral solver)
+     * @param position Coordinate3D that contains the position
+     * @param species Unsigned int that contains the index of the molecule species
+     * @return Coordinate3D that contains the tangential gradient
+     */
+    Coordinate3D getAnalyticGradient(const Coordinate3D &position, unsigned int species = 0);
+
+    /// Maximum deviation of the single precision field from its double precision shadow (relative to the maximum
+    /// concentration) over all monitored windows
+    double getMaxPrecisionDeviation() const { return max_precision_deviation_; };
 
     std::unique_ptr<StaticBalloonList> particle_balloon_list_;
 private:
+    std::shared_ptr<const MappedParticleMesh> loadParticleMesh(const std::string &filename);
     void computeMaxPossibleTimestep();
+    void assembleOperators();
+    template<unsigned int fixed_number_of_species, typename Real>
+    void diffuseParticle(size_t particle_id, double timestep, const Real *field, const Real *prefactors, double *changes);
+    void applySinglePrecisionChanges();
+    void updatePrecisionMonitor();
+    void initializeActiveSet();
+    void activateParticle(unsigned int particle_id);
+    void expandActiveSet();
     void extractTriangles();
     void cleanUpAllParticles();
+    void initializeSecretionSources();
+    void startSecretionTerms();
+    void stopSuperposition();
+    void materializeConcentrations();
+    void updateSecretionSources(double time_delta, double current_time);
     void insertConcentrationAtArea(double time_delta, double current_time);
+    void initializeSpectralField();
+    void projectSecretionSources(double time_delta);
+    void applySpectralStep(double timestep);
+    void recordDeferredStep(double timestep);
+    const double *getHarmonicValues(unsigned int particle_id);
 
     AlveoleSite *site_{};
     double dc_{};
     double s_aec_{};
     double start_chemotaxis_{};
     bool visualize_concentration_{};
+    unsigned int number_of_particles_{};
+    std::string particle_mesh_seeding_{};
+    std::string particle_mesh_cache_dir_{};
 
     int number_aecs_{};
     bool allow_higher_dt_{};
     bool clean_chemotaxis_{};
 
+    std::shared_ptr<const MappedParticleMesh> mesh_{};
     std::vector<std::shared_ptr<Particle>> all_particles_{};
-    std::vector<std::shared_ptr<Particle>> aec_particles_{};
-    std::vector<int> aec_particles_cells_{};
-    double sum_area_aec_particles_{};
+    std::vector<unsigned int> particles_in_input_order_{};
+    // Registry of the secretion sources: particles of every secreting aec (in order of discovery) and the per-grid
+    // secretion rate of every aec and species. It is determined anew only after a chemotaxis cleanup.
+    std::vector<int> secretion_aec_of_particle_{};
+    std::vector<bool> is_secreting_particle_{};
+    std::vector<std::vector<unsigned int>> secretion_sources_{};
+    std::vector<int> secreting_aecs_{};
     std::vector<double> sum_area_aec_particles_cells_{};
     std::vector<double> aec_secretion_rate_per_grid_{};
+    size_t secretion_sources_version_{};
     std::vector<TRIANGLE3D> triangles_{};
+
+    // Concentrations and their changes in the current timestep, interleaved by species (index id * species + s)
+    unsigned int number_of_species_{};
+    std::vector<double> diffusion_constants_{};
+    std::vector<double> secretion_per_cell_{};
+    std::vector<double> uptake_rates_{};
+    std::vector<double> concentrations_{};
+    std::vector<double> concentration_changes_{};
+
+    // Diffusion and gradient operator share one CSR stencil, rows of particles outside of the site are empty.
+    // The diffusion prefactors (PSE) are interleaved by species, so one sweep over the stencil updates all species.
+    // The gradient (Sukumar et al.) at particle i is the sum over its row of direction_ij * (weight_ij * (c_j - c_i)),
+    // weights and directions are kept apart to reproduce the rounding of Particle::getGradient exactly.
+    std::vector<unsigned int> stencil_offsets_{};
+    std::vector<unsigned int> stencil_columns_{};
+    std::vector<double> diffusion_prefactors_{};
+    std::vector<double> gradient_weights_{};
+    std::vector<Coordinate3D> gradient_directions_{};
+    std::vector<Coordinate3D> gradients_{};
+    std::vector<unsigned long> gradient_epochs_{};
+    unsigned long field_epoch_{1};
+
+    // Active set of the diffusion: particles outside of it have a zero concentration and only zero neighbours, i.e.
+    // their diffusion term vanishes. Particles on the front are active, but have not activated their reverse
+    // neighbours (all particles that have them as neighbour) yet, because their concentration is below the epsilon.
+    bool use_active_set_{};
+    double active_set_epsilon_{};
+    size_t number_of_particles_in_site_{};
+    std::vector<unsigned int> reverse_neighbour_offsets_{};
+    std::vector<unsigned int> reverse_neighbour_ids_{};
+    std::vector<bool> is_active_{};
+    std::vector<unsigned int> active_particles_{};
+    std::vector<unsigned int> front_particles_{};
+    std::vector<unsigned int> previous_front_particles_{};
+
+    // Superposition of the secretion sources (diffusion_solver "superposition"): the concentrations are the sum of the
+    // step responses of all secretion terms and a correction field. The correction field contains the uptake by AMs
+    // and is integrated explicitly, i.e. diffusion sweeps (and the active set) only work on the correction.
+    struct SecretionTerm {
+        std::shared_ptr<SecretionResponse> response{};
+        int aec_id{};
+        unsigned int species{};
+        double rate{};
+        size_t start_step{};
+        size_t stop_step{};
+    };
+    bool use_superposition_{};
+    double superposition_tolerance_{};
+    double superposition_dt_{};
+    size_t diffusion_step_{};
+    double *diffusion_field_{};
+    std::vector<double> correction_field_{};
+    std::vector<std::shared_ptr<const DiffusionStencil>> species_stencils_{};
+    std::vector<SecretionTerm> secretion_terms_{};
+
+    // Single precision field (field_precision "single"): diffusion reads the float field and prefactors, the changes
+    // are added with Kahan summation and the compensated value is provided as double concentration. The monitor runs
+    // a double precision shadow of the field for a window of steps every interval steps.
+    bool single_precision_{};
+    std::vector<float> field_single_{};
+    std::vector<float> field_compensation_{};
+    std::vector<float> diffusion_prefactors_single_{};
+    std::vector<double> diffusion_changes_{};
+    bool concurrent_diffusion_{};
+
+    // Deferred steps of the field (demand_driven_diffusion): runs of equal steps with the secretion sources of the
+    // step (particle ids and per-grid rates in order of the registry). Replaying them reproduces the skipped steps.
+    struct SecretionSnapshot {
+        std::vector<unsigned int> ids{};
+        std::vector<double> rates{};
+        size_t version{};
+    };
+    struct DeferredSteps {
+        double timestep{};
+        std::shared_ptr<const SecretionSnapshot> secretion{};
+        size_t count{};
+    };
+    bool demand_driven_diffusion_{};
+    bool deferring_steps_{};
+    std::shared_ptr<const SecretionSnapshot> secretion_snapshot_{};
+    std::vector<DeferredSteps> deferred_steps_{};
+    unsigned int monitor_interval_{};
+    unsigned int monitor_window_{};
+    unsigned int monitor_steps_left_{};
+    std::vector<double> shadow_field_{};
+    std::vector<double> shadow_changes_{};
+    double max_precision_deviation_{};
+
+    // Spectral solver (diffusion_solver "spectral"): the field of every species is given by the coefficients of the
+    // spherical harmonics up to the band limit (one block per species, index s * harmonics + p). The changes of the
+    // particles (uptake) and the secretion sources are projected onto the harmonics with the particle areas as
+    // quadrature weights, concentrations at the particles are evaluated lazily when they are read.
+    bool use_spectral_{};
+    double spectral_penalty_{};
+    bool spectral_step_pending_{};
+    bool spectral_sources_changed_{};
+    double spectral_dt_{};
+    std::unique_ptr<SphericalHarmonics> harmonics_{};
+    SpectralPropagator::Geometry spectral_geometry_{};
+    std::vector<std::shared_ptr<const SpectralPropagator>> spectral_propagators_{};
+    std::vector<double> spectral_coefficients_{};
+    std::vector<double> spectral_source_rates_{};
+    std::vector<double> harmonic_values_{};
+    std::vector<Coordinate3D> harmonic_gradients_{};
+    std::vector<unsigned int> harmonic_value_offsets_{};
+    std::vector<double> harmonic_value_cache_{};
+    std::vector<unsigned long> concentration_epochs_{};
 };
 
 
@@ -0,0 +1,357 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+
+#include "MortonOrder.h"
+#include "ParticleMesh.h"
+#include "external/json.hpp"
+#include "core/utils/macros.h"
+
+using json = nlohmann::json;
+
+static_assert(sizeof(Coordinate3D) == 3 * sizeof(double), "Coordinate3D must be layout compatible with double[3]");
+static_assert(sizeof(std::array<unsigned int, 3>) == 3 * sizeof(unsigned int), "Triangles must be packed");
+
+namespace {
+    constexpr char kMeshMagic[8] = {'h', 'A', 'B', 'M', 'M', 'S', 'H', '\0'};
+    constexpr std::uint32_t kMeshVersion = 3;
+    constexpr size_t kSectionAlignment = 64;
+
+    enum Section {
+        POSITIONS, AREAS, NEIGHBOUR_OFFSETS, NEIGHBOUR_IDS, DISTANCES, CONTACT_AREAS, TRIANGLES, ORIGINAL_IDS,
+        NUMBER_OF_SECTIONS
+    };
+
+    struct MeshHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t header_size;
+        std::int32_t organism;
+        std::uint32_t number_of_particles;
+        double radius;
+        std::uint64_t size;
+        std::uint64_t number_of_neighbours;
+        std::uint64_t number_of_triangles;
+        std::uint64_t section_offsets[NUMBER_OF_SECTIONS];
+    };
+
+    std::array<size_t, NUMBER_OF_SECTIONS> sectionSizes(size_t size, size_t number_of_neighbours, size_t number_of_triangles) {
+        return {3 * size * sizeof(double), size * sizeof(double), (size + 1) * sizeof(std::uint32_t),
+                number_of_neighbours * sizeof(std::uint32_t), number_of_neighbours * sizeof(double),
+                number_of_neighbours * sizeof(double), 3 * number_of_triangles * sizeof(std::uint32_t),
+                size * sizeof(std::uint32_t)};
+    }
+
+    size_t align(size_t offset) {
+        return (offset + kSectionAlignment - 1) / kSectionAlignment * kSectionAlignment;
+    }
+
+    std::vector<char> serializeMesh(const ParticleMesh &mesh, const ParticleMeshKey &key) {
+        MeshHeader header{};
+        std::memcpy(header.magic, kMeshMagic, sizeof(kMeshMagic));
+        header.version = kMeshVersion;
+        header.header_size = sizeof(MeshHeader);
+        header.organism = key.organism;
+        header.number_of_particles = key.number_of_particles;
+        header.radius = key.radius;
+        header.size = mesh.size();
+        header.number_of_neighbours = mesh.neighbour_ids.size();
+        header.number_of_triangles = mesh.triangles.size();
+
+        // Meshes in input order are stored with the identity as original ids
+        std::vector<unsigned int> identity{};
+        if (mesh.original_ids.empty()) {
+            identity.resize(mesh.size());
+            std::iota(identity.begin(), identity.end(), 0);
+        }
+        const auto &original_ids = mesh.original_ids.empty() ? identity : mesh.original_ids;
+
+        const auto sizes = sectionSizes(header.size, header.number_of_neighbours, header.number_of_triangles);
+        const std::array<const void *, NUMBER_OF_SECTIONS> sources{
+                mesh.positions.data(), mesh.areas.data(), mesh.neighbour_offsets.data(), mesh.neighbour_ids.data(),
+                mesh.distances.data(), mesh.contact_areas.data(), mesh.triangles.data(), original_ids.data()};
+        size_t offset = align(sizeof(MeshHeader));
+        for (int section = 0; section < NUMBER_OF_SECTIONS; ++section) {
+            header.section_offsets[section] = offset;
+            offset = align(offset + sizes[section]);
+        }
+
+        std::vector<char> buffer(offset, 0);
+        std::memcpy(buffer.data(), &header, sizeof(header));
+        for (int section = 0; section < NUMBER_OF_SECTIONS; ++section) {
+            if (sizes[section] > 0) {
+                std::memcpy(buffer.data() + header.section_offsets[section], sources[section], sizes[section]);
+            }
+        }
+        return buffer;
+    }
+
+    std::mutex mapped_meshes_mutex;
+    std::map<std::string, std::weak_ptr<const MappedParticleMesh>> mapped_meshes;
+}
+
+MappedParticleMesh::~MappedParticleMesh() {
+    if (mapping_ != nullptr) {
+        munmap(mapping_, mapping_length_);
+    }
+}
+
+bool MappedParticleMesh::assignSections(const char *data, size_t length) {
+    MeshHeader header{};
+    if (length < sizeof(MeshHeader)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kMeshMagic, sizeof(kMeshMagic)) != 0 || header.version != kMeshVersion ||
+        header.header_size != sizeof(MeshHeader)) {
+        return false;
+    }
+    const auto sizes = sectionSizes(header.size, header.number_of_neighbours, header.number_of_triangles);
+    for (int section = 0; section < NUMBER_OF_SECTIONS; ++section) {
+        if (header.section_offsets[section] % kSectionAlignment != 0 ||
+            header.section_offsets[section] + sizes[section] > length) {
+            return false;
+        }
+    }
+
+    key_ = {header.radius, header.number_of_particles, header.organism};
+    size_ = header.size;
+    number_of_triangles_ = header.number_of_triangles;
+    positions_ = reinterpret_cast<const Coordinate3D *>(data + header.section_offsets[POSITIONS]);
+    areas_ = reinterpret_cast<const double *>(data + header.section_offsets[AREAS]);
+    neighbour_offsets_ = reinterpret_cast<const unsigned int *>(data + header.section_offsets[NEIGHBOUR_OFFSETS]);
+    neighbour_ids_ = reinterpret_cast<const unsigned int *>(data + header.section_offsets[NEIGHBOUR_IDS]);
+    distances_ = reinterpret_cast<const double *>(data + header.section_offsets[DISTANCES]);
+    contact_areas_ = reinterpret_cast<const double *>(data + header.section_offsets[CONTACT_AREAS]);
+    triangles_ = reinterpret_cast<const std::array<unsigned int, 3> *>(data + header.section_offsets[TRIANGLES]);
+    original_ids_ = reinterpret_cast<const unsigned int *>(data + header.section_offsets[ORIGINAL_IDS]);
+    return neighbour_offsets_[size_] == header.number_of_neighbours;
+}
+
+std::shared_ptr<const MappedParticleMesh> MappedParticleMesh::open(const std::string &filename) {
+    const int file_descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (file_descriptor < 0) {
+        return nullptr;
+    }
+    struct stat file_status{};
+    fstat(file_descriptor, &file_status);
+
+    std::lock_guard<std::mutex> lock(mapped_meshes_mutex);
+    const auto key = boost::filesystem::absolute(filename).lexically_normal().string();
+    if (const auto it = mapped_meshes.find(key); it != mapped_meshes.end()) {
+        if (auto mesh = it->second.lock(); mesh != nullptr && mesh->file_inode_ == file_status.st_ino &&
+                                           mesh->file_modification_time_ == file_status.st_mtime) {
+            close(file_descriptor);
+            return mesh;
+        }
+    }
+
+    std::shared_ptr<MappedParticleMesh> mesh(new MappedParticleMesh());
+    mesh->mapping_length_ = file_status.st_size;
+    mesh->file_inode_ = file_status.st_ino;
+    mesh->file_modification_time_ = file_status.st_mtime;
+    if (mesh->mapping_length_ > 0) {
+        void *mapping = mmap(nullptr, mesh->mapping_length_, PROT_READ, MAP_SHARED, file_descriptor, 0);
+        mesh->mapping_ = mapping == MAP_FAILED ? nullptr : mapping;
+    }
+    close(file_descriptor);
+    if (mesh->mapping_ == nullptr ||
+        !mesh->assignSections(static_cast<const char *>(mesh->mapping_), mesh->mapping_length_)) {
+        ERROR_STDERR("Particle mesh " << filename << " is not a valid mesh file of version " << kMeshVersion);
+        return nullptr;
+    }
+    mapped_meshes[key] = mesh;
+    return mesh;
+}
+
+std::shared_ptr<const MappedParticleMesh> MappedParticleMesh::fromMesh(const ParticleMesh &mesh,
+                                                                       const ParticleMeshKey &key) {
+    std::shared_ptr<MappedParticleMesh> mapped_mesh(new MappedParticleMesh());
+    mapped_mesh->buffer_ = serializeMesh(mesh, key);
+    mapped_mesh->assignSections(mapped_mesh->buffer_.data(), mapped_mesh->buffer_.size());
+    return mapped_mesh;
+}
+
+ParticleMesh abm::utilAlveolus::readParticleMeshFromJson(const std::string &filename) {
+    std::ifstream infile(filename);
+    json j;
+    infile >> j;
+
+    ParticleMesh mesh{};
+    const auto &particles = j["Particles"];
+    mesh.positions.reserve(particles.size());
+    mesh.areas.reserve(particles.size());
+    mesh.neighbour_offsets.reserve(particles.size() + 1);
+    mesh.neighbour_offsets.push_back(0);
+
+    int supposed_id = 0;
+    for (const auto &particle_json: particles) {
+        int id = particle_json["id"];
+        auto pos = particle_json["position"].get<std::vector<double>>();
+        mesh.positions.push_back({pos[0], pos[1], pos[2]});
+        mesh.areas.push_back(particle_json["area"]);
+        for (const auto &neighbour: particle_json["neighbours"]) {
+            mesh.neighbour_ids.push_back(neighbour["id"]);
+            mesh.contact_areas.push_back(neighbour["contact_area"]);
+        }
+        mesh.neighbour_offsets.push_back(mesh.neighbour_ids.size());
+
+        if (id != supposed_id) {
+            ERROR_STDERR("Particles are not in order at id = " + std::to_string(supposed_id));
+        }
+        ++supposed_id;
+    }
+    completeParticleMesh(mesh);
+    return mesh;
+}
+
+void abm::utilAlveolus::completeParticleMesh(ParticleMesh &mesh) {
+    // Remove duplicated neighbours (first occurrence is kept) and compute the distances to the neighbours
+    std::vector<unsigned int> offsets{0}, ids{};
+    std::vector<double> contact_areas{};
+    offsets.reserve(mesh.size() + 1);
+    ids.reserve(mesh.neighbour_ids.size());
+    contact_areas.reserve(mesh.neighbour_ids.size());
+    mesh.distances.clear();
+    mesh.distances.reserve(mesh.neighbour_ids.size());
+    for (size_t i = 0; i < mesh.size(); ++i) {
+        for (auto k = mesh.neighbour_offsets[i]; k < mesh.neighbour_offsets[i + 1]; ++k) {
+            const auto neighbour = mesh.neighbour_ids[k];
+            if (std::find(ids.begin() + offsets.back(), ids.end(), neighbour) == ids.end()) {
+                ids.push_back(neighbour);
+                contact_areas.push_back(mesh.contact_areas[k]);
+                mesh.distances.push_back(mesh.positions[neighbour].calculateEuclidianDistance(mesh.positions[i]));
+            }
+        }
+        offsets.push_back(ids.size());
+    }
+    mesh.neighbour_offsets = std::move(offsets);
+    mesh.neighbour_ids = std::move(ids);
+    mesh.contact_areas = std::move(contact_areas);
+
+    // Triangles are all triples of particles that are mutual neighbours
+    mesh.triangles.clear();
+    for (unsigned int p = 0; p < mesh.size(); ++p) {
+        const auto begin = mesh.neighbour_ids.begin() + mesh.neighbour_offsets[p];
+        const auto end = mesh.neighbour_ids.begin() + mesh.neighbour_offsets[p + 1];
+        for (auto i = begin; i != end; ++i) {
+            const auto i_begin = mesh.neighbour_ids.begin() + mesh.neighbour_offsets[*i];
+            const auto i_end = mesh.neighbour_ids.begin() + mesh.neighbour_offsets[*i + 1];
+            for (auto j = i + 1; j != end; ++j) {
+                if (std::find(i_begin, i_end, *j) != i_end) {
+                    std::array<unsigned int, 3> sorted{p, *i, *j};
+                    std::sort(sorted.begin(), sorted.end());
+                    mesh.triangles.push_back(sorted);
+                }
+            }
+        }
+    }
+    std::sort(mesh.triangles.begin(), mesh.triangles.end());
+    mesh.triangles.erase(std::unique(mesh.triangles.begin(), mesh.triangles.end()), mesh.triangles.end());
+}
+
+void abm::utilAlveolus::reorderParticleMesh(ParticleMesh &mesh) {
+    const auto size = mesh.size();
+    if (size == 0) return;
+
+    // Positions are quantised to 21 bits per axis in their bounding box, ties keep the current order
+    Coordinate3D lower = mesh.positions[0], upper = mesh.positions[0];
+    for (const auto &position: mesh.positions) {
+        lower = {std::min(lower.x, position.x), std::min(lower.y, position.y), std::min(lower.z, position.z)};
+        upper = {std::max(upper.x, position.x), std::max(upper.y, position.y), std::max(upper.z, position.z)};
+    }
+    const double extent = std::max({upper.x - lower.x, upper.y - lower.y, upper.z - lower.z});
+    const double scale = extent > 0 ? 2097151.0 / extent : 0.0;
+    std::vector<std::uint64_t> codes(size);
+    for (size_t i = 0; i < size; ++i) {
+        const auto &position = mesh.positions[i];
+        codes[i] = mortonCode(static_cast<std::uint32_t>((position.x - lower.x) * scale),
+                              static_cast<std::uint32_t>((position.y - lower.y) * scale),
+                              static_cast<std::uint32_t>((position.z - lower.z) * scale));
+    }
+    std::vector<unsigned int> order(size);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&codes](unsigned int a, unsigned int b) { return codes[a] < codes[b]; });
+    std::vector<unsigned int> new_ids(size);
+    for (unsigned int i = 0; i < size; ++i) {
+        new_ids[order[i]] = i;
+    }
+
+    ParticleMesh reordered{};
+    reordered.positions.reserve(size);
+    reordered.areas.reserve(size);
+    reordered.original_ids.reserve(size);
+    reordered.neighbour_offsets.reserve(size + 1);
+    reordered.neighbour_offsets.push_back(0);
+    reordered.neighbour_ids.reserve(mesh.neighbour_ids.size());
+    reordered.distances.reserve(mesh.neighbour_ids.size());
+    reordered.contact_areas.reserve(mesh.neighbour_ids.size());
+    for (auto id: order) {
+        reordered.positions.push_back(mesh.positions[id]);
+        reordered.areas.push_back(mesh.areas[id]);
+        reordered.original_ids.push_back(mesh.original_ids.empty() ? id : mesh.original_ids[id]);
+        for (auto k = mesh.neighbour_offsets[id]; k < mesh.neighbour_offsets[id + 1]; ++k) {
+            reordered.neighbour_ids.push_back(new_ids[mesh.neighbour_ids[k]]);
+            reordered.distances.push_back(mesh.distances[k]);
+            reordered.contact_areas.push_back(mesh.contact_areas[k]);
+        }
+        reordered.neighbour_offsets.push_back(reordered.neighbour_ids.size());
+    }
+
+    reordered.triangles.reserve(mesh.triangles.size());
+    for (const auto &triangle: mesh.triangles) {
+        reordered.triangles.push_back({new_ids[triangle[0]], new_ids[triangle[1]], new_ids[triangle[2]]});
+    }
+    std::stable_sort(reordered.triangles.begin(), reordered.triangles.end(), [](const auto &a, const auto &b) {
+        return *std::min_element(a.begin(), a.end()) < *std::min_element(b.begin(), b.end());
+    });
+    mesh = std::move(reordered);
+}
+
+bool abm::utilAlveolus::writeParticleMeshToBinary(const std::string &filename, const ParticleMesh &mesh,
+                                                  const ParticleMeshKey &key) {
+    boost::system::error_code error_code;
+    const auto directory = boost::filesystem::path(filename).parent_path();
+    if (!directory.empty()) {
+        boost::filesystem::create_directories(directory, error_code);
+    }
+
+    // Write into a temporary file first, so that concurrent simulations never map a partially written file
+    const auto temporary_file = filename + ".tmp" + std::to_string(getpid());
+    std::ofstream out(temporary_file, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        ERROR_STDERR("Could not write particle mesh " << filename);
+        return false;
+    }
+    const auto buffer = serializeMesh(mesh, key);
+    out.write(buffer.data(), buffer.size());
+    out.close();
+
+    boost::filesystem::rename(temporary_file, filename, error_code);
+    if (error_code) {
+        ERROR_STDERR("Could not write particle mesh " << filename << ": " << error_code.message());
+        boost::filesystem::remove(temporary_file, error_code);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,140 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#ifndef COREABM_PARTICLEMESH_H
+#define COREABM_PARTICLEMESH_H
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/basic/Coordinate3D.h"
+
+// Geometry of a particle mesh on the alveolar sphere. The neighbourhood is stored in CSR form, i.e. the neighbours of
+// particle i are neighbour_ids[neighbour_offsets[i]] ... neighbour_ids[neighbour_offsets[i + 1] - 1]. A reordered mesh
+// keeps the id of every particle in the input (original_ids), an empty list means the particles are in input order.
+struct ParticleMesh {
+    std::vector<Coordinate3D> positions{};
+    std::vector<double> areas{};
+    std::vector<unsigned int> neighbour_offsets{};
+    std::vector<unsigned int> neighbour_ids{};
+    std::vector<double> distances{};
+    std::vector<double> contact_areas{};
+    std::vector<std::array<unsigned int, 3>> triangles{};
+    std::vector<unsigned int> original_ids{};
+
+    [[nodiscard]] size_t size() const { return positions.size(); };
+};
+
+// Parameters a generated mesh was created for. Meshes converted from json files have an empty key.
+struct ParticleMeshKey {
+    double radius{};
+    unsigned int number_of_particles{};
+    int organism{};
+
+    bool operator==(const ParticleMeshKey &other) const {
+        return radius == other.radius && number_of_particles == other.number_of_particles && organism == other.organism;
+    }
+};
+
+class MappedParticleMesh {
+public:
+    // Class for read-only access to a particle mesh in the binary mesh format (.pmesh). Files are memory mapped and
+    // shared between all runs of a process, other processes share the pages via the page cache.
+    //
+    // Layout (version 3, native byte order): header followed by 64 byte aligned sections
+    //   positions (double[3n]), areas (double[n]), neighbour offsets (uint32[n + 1]), neighbour ids (uint32[m]),
+    //   distances (double[m]), contact areas (double[m]), triangles (uint32[3t]), original ids (uint32[n]),
+    // with n particles, m neighbour entries and t triangles. The header stores the byte offset of every section.
+    ~MappedParticleMesh();
+    MappedParticleMesh(const MappedParticleMesh &) = delete;
+    MappedParticleMesh &operator=(const MappedParticleMesh &) = delete;
+
+    /*!
+     * Maps a binary mesh file, already mapped files are shared as long as they were not modified on disk
+     * @param filename String that contains path to .pmesh file
+     * @return Shared pointer to the mapped mesh or nullptr if the file does not exist or has another format version
+     */
+    static std::shared_ptr<const MappedParticleMesh> open(const std::string &filename);
+
+    /// Creates the binary representation of a mesh in memory, e.g. if it could not be written to disk
+    static std::shared_ptr<const MappedParticleMesh> fromMesh(const ParticleMesh &mesh, const ParticleMeshKey &key);
+
+    [[nodiscard]] const ParticleMeshKey &getKey() const { return key_; };
+    [[nodiscard]] size_t size() const { return size_; };
+    [[nodiscard]] size_t getNumberOfTriangles() const { return number_of_triangles_; };
+    [[nodiscard]] const Coordinate3D *getPositions() const { return positions_; };
+    [[nodiscard]] const double *getAreas() const { return areas_; };
+    [[nodiscard]] const unsigned int *getNeighbourOffsets() const { return neighbour_offsets_; };
+    [[nodiscard]] const unsigned int *getNeighbourIds() const { return neighbour_ids_; };
+    [[nodiscard]] const double *getDistances() const { return distances_; };
+    [[nodiscard]] const double *getContactAreas() const { return contact_areas_; };
+    [[nodiscard]] const std::array<unsigned int, 3> *getTriangles() const { return triangles_; };
+    [[nodiscard]] const unsigned int *getOriginalIds() const { return original_ids_; };
+
+private:
+    MappedParticleMesh() = default;
+    bool assignSections(const char *data, size_t length);
+
+    void *mapping_{};
+    size_t mapping_length_{};
+    std::vector<char> buffer_{};
+    unsigned long file_inode_{};
+    long file_modification_time_{};
+
+    ParticleMeshKey key_{};
+    size_t size_{};
+    size_t number_of_triangles_{};
+    const Coordinate3D *positions_{};
+    const double *areas_{};
+    const unsigned int *neighbour_offsets_{};
+    const unsigned int *neighbour_ids_{};
+    const double *distances_{};
+    const double *contact_areas_{};
+    const std::array<unsigned int, 3> *triangles_{};
+    const unsigned int *original_ids_{};
+};
+
+namespace abm::utilAlveolus {
+
+    /*!
+     * Reads a particle mesh from a delaunay json file (as in input/particle-dist)
+     * @param filename String that contains path to json file
+     * @return ParticleMesh that contains positions, areas and neighbourhood of all particles
+     */
+    ParticleMesh readParticleMeshFromJson(const std::string &filename);
+
+    /*!
+     * Computes distances and triangles of a mesh from positions and neighbourhood. Duplicated neighbours are removed.
+     * Triangles are all triples of mutual neighbours, sorted by particle ids
+     * @param mesh ParticleMesh that is completed
+     */
+    void completeParticleMesh(ParticleMesh &mesh);
+
+    /*!
+     * Sorts the particles along the Morton curve of their positions, such that neighbours are mostly close in memory.
+     * Neighbours keep their order per particle, triangles keep their vertex order and are sorted by their smallest
+     * particle id. The input id of every particle is kept in original_ids
+     * @param mesh ParticleMesh that is reordered
+     */
+    void reorderParticleMesh(ParticleMesh &mesh);
+
+    /*!
+     * Writes a particle mesh in the binary mesh format
+     * @param filename String that contains path to .pmesh file
+     * @param mesh ParticleMesh that contains the complete mesh
+     * @param key ParticleMeshKey that contains the parameters of a generated mesh
+     * @return Bool if the file could be written
+     */
+    bool writeParticleMeshToBinary(const std::string &filename, const ParticleMesh &mesh, const ParticleMeshKey &key = {});
+}
+
+#endif //COREABM_PARTICLEMESH_H
@@ -0,0 +1,328 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+#include "ParticleMeshGenerator.h"
+#include "core/utils/macros.h"
+
+namespace {
+    double tripleProduct(const Coordinate3D &a, const Coordinate3D &b, const Coordinate3D &c) {
+        return a.scalarProduct(b.crossProduct(c));
+    }
+
+    Coordinate3D normalized(Coordinate3D vec) {
+        vec.setMagnitude(1.0);
+        return vec;
+    }
+
+    // Signed area of the spherical triangle between the unit vectors a, b and c (Van Oosterom and Strackee)
+    double sphericalTriangleArea(const Coordinate3D &a, const Coordinate3D &b, const Coordinate3D &c) {
+        return 2.0 * atan2(tripleProduct(a, b, c), 1.0 + a.scalarProduct(b) + b.scalarProduct(c) + c.scalarProduct(a));
+    }
+
+    struct HullFace {
+        std::array<unsigned int, 3> v{};
+        std::array<int, 3> adjacent{};  // face across the edge v[k] -> v[(k + 1) % 3]
+        bool alive{};
+    };
+}
+
+ParticleMeshGenerator::ParticleMeshGenerator(double radius, unsigned int number_of_particles, int organism,
+                                             std::string seeding)
+        : radius_(radius), number_of_particles_(number_of_particles), organism_(organism), seeding_(std::move(seeding)) {}
+
+std::string ParticleMeshGenerator::getCacheFileName() const {
+    std::ostringstream name;
+    name << number_of_particles_ << "particles-" << seeding_ << "_organism" << organism_ << "_r" << radius_ << ".pmesh";
+    return name.str();
+}
+
+ParticleMesh ParticleMeshGenerator::generateMesh() const {
+    if (number_of_particles_ < 12) {
+        ERROR_STDERR("A particle mesh needs at least 12 particles, but " << number_of_particles_ << " were requested.");
+        exit(1);
+    }
+    std::vector<Coordinate3D> points{};
+    std::vector<Triangle> triangles{};
+    if (seeding_ == "fibonacci") {
+        points = seedFibonacci();
+        triangles = triangulate(points);
+    } else if (seeding_ == "icosphere") {
+        seedIcosphere(points, triangles);
+    } else {
+        ERROR_STDERR("Unknown particle mesh seeding " << seeding_ << ". Use fibonacci or icosphere.");
+        exit(1);
+    }
+    return buildMesh(points, triangles);
+}
+
+std::vector<Coordinate3D> ParticleMeshGenerator::seedFibonacci() const {
+    const double golden_angle = M_PI * (3.0 - sqrt(5.0));
+    std::vector<Coordinate3D> points(number_of_particles_);
+    for (unsigned int i = 0; i < number_of_particles_; ++i) {
+        const double z = 1.0 - (2.0 * i + 1.0) / number_of_particles_;
+        const double r = sqrt(1.0 - z * z);
+        const double phi = golden_angle * i;
+        points[i] = Coordinate3D{r * cos(phi), r * sin(phi), z} * radius_;
+    }
+    return points;
+}
+
+void ParticleMeshGenerator::seedIcosphere(std::vector<Coordinate3D> &points, std::vector<Triangle> &triangles) const {
+    const double phi = 0.5 * (1.0 + sqrt(5.0));
+    points = {{-1, phi, 0}, {1, phi, 0}, {-1, -phi, 0}, {1, -phi, 0},
+              {0, -1, phi}, {0, 1, phi}, {0, -1, -phi}, {0, 1, -phi},
+              {phi, 0, -1}, {phi, 0, 1}, {-phi, 0, -1}, {-phi, 0, 1}};
+    triangles = {{0, 11, 5}, {0, 5, 1}, {0, 1, 7}, {0, 7, 10}, {0, 10, 11},
+                 {1, 5, 9}, {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+                 {3, 9, 4}, {3, 4, 2}, {3, 2, 6}, {3, 6, 8}, {3, 8, 9},
+                 {4, 9, 5}, {2, 4, 11}, {6, 2, 10}, {8, 6, 7}, {9, 8, 1}};
+    for (auto &point: points) {
+        point = normalized(point);
+    }
+    for (auto &triangle: triangles) {
+        const auto &pa = points[triangle[0]];
+        if ((points[triangle[1]] - pa).crossProduct(points[triangle[2]] - pa).scalarProduct(pa) < 0) {
+            std::swap(triangle[1], triangle[2]);
+        }
+    }
+
+    // Subdivide until the requested number of particles is reached (10 * 4^k + 2 vertices after k subdivisions, other
+    // numbers are rejected with the configuration)
+    while (points.size() < number_of_particles_) {
+        std::map<std::pair<unsigned int, unsigned int>, unsigned int> midpoints{};
+        auto midpoint = [&](unsigned int a, unsigned int b) {
+            const auto key = std::minmax(a, b);
+            if (const auto it = midpoints.find(key); it != midpoints.end()) {
+                return it->second;
+            }
+            points.push_back(normalized(points[a] + points[b]));
+            midpoints.emplace(key, points.size() - 1);
+            return static_cast<unsigned int>(points.size() - 1);
+        };
+        std::vector<Triangle> subdivided{};
+        subdivided.reserve(4 * triangles.size());
+        for (const auto &[a, b, c]: triangles) {
+            const auto ab = midpoint(a, b);
+            const auto bc = midpoint(b, c);
+            const auto ca = midpoint(c, a);
+            subdivided.push_back({a, ab, ca});
+            subdivided.push_back({b, bc, ab});
+            subdivided.push_back({c, ca, bc});
+            subdivided.push_back({ab, bc, ca});
+        }
+        triangles = std::move(subdivided);
+    }
+    for (auto &point: points) {
+        point *= radius_;
+    }
+}
+
+std::vector<ParticleMeshGenerator::Triangle>
+ParticleMeshGenerator::triangulate(const std::vector<Coordinate3D> &points) const {
+    // The spherical delaunay triangulation is the convex hull of the points, which is built incrementally. The face that
+    // is visible from a new point is located by walking over the hull towards the point's radial projection.
+    const auto n = static_cast<unsigned int>(points.size());
+    std::vector<HullFace> faces{};
+    faces.reserve(6 * n);
+
+    // Initial tetrahedron around the origin: topmost point and three points in tetrahedral directions below
+    std::array<unsigned int, 4> tetrahedron{};
+    tetrahedron[0] = std::max_element(points.begin(), points.end(), [](const auto &a, const auto &b) { return a.z < b.z; }) -
+                     points.begin();
+    for (int k = 0; k < 3; ++k) {
+        const Coordinate3D direction{sqrt(8.0) / 3.0 * cos(2.0 * M_PI * k / 3.0), sqrt(8.0) / 3.0 * sin(2.0 * M_PI * k / 3.0),
+                                     -1.0 / 3.0};
+        double best = -std::numeric_limits<double>::max();
+        for (unsigned int i = 0; i < n; ++i) {
+            if (std::find(tetrahedron.begin(), tetrahedron.begin() + k + 1, i) == tetrahedron.begin() + k + 1 &&
+                points[i].scalarProduct(direction) > best) {
+                best = points[i].scalarProduct(direction);
+                tetrahedron[k + 1] = i;
+            }
+        }
+    }
+    for (const auto &[a, b, c]: std::array<Triangle, 4>{{{0, 1, 2}, {0, 2, 3}, {0, 3, 1}, {1, 3, 2}}}) {
+        HullFace face{{tetrahedron[a], tetrahedron[b], tetrahedron[c]}, {-1, -1, -1}, true};
+        const auto &pa = points[face.v[0]];
+        if ((points[face.v[1]] - pa).crossProduct(points[face.v[2]] - pa).scalarProduct(pa) < 0) {
+            std::swap(face.v[1], face.v[2]);
+        }
+        faces.push_back(face);
+    }
+    for (auto &face: faces) {
+        const auto &pa = points[face.v[0]];
+        if ((points[face.v[1]] - pa).crossProduct(points[face.v[2]] - pa).scalarProduct(pa) <= 0) {
+            ERROR_STDERR("Particle mesh generation failed: initial tetrahedron does not contain the center.");
+            exit(1);
+        }
+        for (int k = 0; k < 3; ++k) {
+            for (size_t g = 0; g < faces.size(); ++g) {
+                for (int l = 0; l < 3; ++l) {
+                    if (faces[g].v[l] == face.v[(k + 1) % 3] && faces[g].v[(l + 1) % 3] == face.v[k]) {
+                        face.adjacent[k] = g;
+                    }
+                }
+            }
+        }
+    }
+
+    auto isVisible = [&](const HullFace &face, const Coordinate3D &p) {
+        const auto &pa = points[face.v[0]];
+        return (points[face.v[1]] - pa).crossProduct(points[face.v[2]] - pa).scalarProduct(p - pa) > 0;
+    };
+
+    std::vector<unsigned int> visited(6 * n, 0);
+    unsigned int stamp = 0;
+    int last_face = 0;
+    for (unsigned int p = 0; p < n; ++p) {
+        if (std::find(tetrahedron.begin(), tetrahedron.end(), p) != tetrahedron.end()) {
+            continue;
+        }
+        const auto &point = points[p];
+
+        // Walk to the face that contains the radial projection of the point
+        int current = last_face;
+        for (size_t steps = 0; steps < faces.size(); ++steps) {
+            const auto &face = faces[current];
+            int next = -1;
+            for (int k = 0; k < 3 && next < 0; ++k) {
+                if (tripleProduct(points[face.v[k]], points[face.v[(k + 1) % 3]], point) < 0) {
+                    next = face.adjacent[k];
+                }
+            }
+            if (next < 0) {
+                break;
+            }
+            current = next;
+        }
+        if (!isVisible(faces[current], point)) {
+            for (size_t f = 0; f < faces.size(); ++f) {
+                if (faces[f].alive && isVisible(faces[f], point)) {
+                    current = f;
+                    break;
+                }
+            }
+        }
+
+        // Collect all faces visible from the point and the horizon edges around them
+        ++stamp;
+        if (visited.size() < faces.size()) {
+            visited.resize(2 * faces.size(), 0);
+        }
+        struct HorizonEdge {
+            unsigned int a, b;
+            int outside, inside;
+        };
+        std::vector<HorizonEdge> horizon{};
+        std::vector<int> stack{current};
+        visited[current] = stamp;
+        while (!stack.empty()) {
+            const int f = stack.back();
+            stack.pop_back();
+            faces[f].alive = false;
+            for (int k = 0; k < 3; ++k) {
+                const int g = faces[f].adjacent[k];
+                if (visited[g] == stamp) {
+                    continue;
+                }
+                if (isVisible(faces[g], point)) {
+                    visited[g] = stamp;
+                    stack.push_back(g);
+                } else {
+                    horizon.push_back({faces[f].v[k], faces[f].v[(k + 1) % 3], g, f});
+                }
+            }
+        }
+
+        // Connect the horizon with the new point
+        std::unordered_map<unsigned int, int> face_starting_at{}, face_ending_at{};
+        for (const auto &edge: horizon) {
+            const int f = faces.size();
+            faces.push_back({{edge.a, edge.b, p}, {edge.outside, -1, -1}, true});
+            for (auto &adjacent: faces[edge.outside].adjacent) {
+                if (adjacent == edge.inside) {
+                    adjacent = f;
+                }
+            }
+            face_starting_at[edge.a] = f;
+            face_ending_at[edge.b] = f;
+        }
+        for (size_t i = faces.size() - horizon.size(); i < faces.size(); ++i) {
+            auto &face = faces[i];
+            const auto next = face_starting_at.find(face.v[1]);
+            const auto previous = face_ending_at.find(face.v[0]);
+            if (next == face_starting_at.end() || previous == face_ending_at.end()) {
+                ERROR_STDERR("Particle mesh generation failed: degenerated horizon at particle " << p);
+                exit(1);
+            }
+            face.adjacent[1] = next->second;
+            face.adjacent[2] = previous->second;
+        }
+        last_face = faces.size() - 1;
+    }
+
+    std::vector<Triangle> triangles{};
+    for (const auto &face: faces) {
+        if (face.alive) {
+            triangles.push_back(face.v);
+        }
+    }
+    return triangles;
+}
+
+ParticleMesh ParticleMeshGenerator::buildMesh(const std::vector<Coordinate3D> &points,
+                                              const std::vector<Triangle> &triangles) const {
+    const auto n = points.size();
+    ParticleMesh mesh{};
+    mesh.positions = points;
+    mesh.areas.resize(n, 0.0);
+
+    std::vector<std::vector<unsigned int>> neighbours(n);
+    for (const auto &triangle: triangles) {
+        std::array<Coordinate3D, 3> unit{};
+        for (int k = 0; k < 3; ++k) {
+            unit[k] = normalized(points[triangle[k]]);
+        }
+        const auto circumcenter = normalized((unit[1] - unit[0]).crossProduct(unit[2] - unit[0]));
+        for (int k = 0; k < 3; ++k) {
+            const auto &a = unit[k];
+            const auto &b = unit[(k + 1) % 3];
+            const auto &c = unit[(k + 2) % 3];
+            // Part of the voronoi cell of a within the triangle, bounded by the bisectors towards b and c
+            mesh.areas[triangle[k]] += (sphericalTriangleArea(a, normalized(a + b), circumcenter) +
+                                        sphericalTriangleArea(a, circumcenter, normalized(a + c))) * radius_ * radius_;
+            neighbours[triangle[k]].push_back(triangle[(k + 1) % 3]);
+            neighbours[triangle[k]].push_back(triangle[(k + 2) % 3]);
+        }
+    }
+
+    // Contact areas follow the convention of the shipped delaunay meshes: contact area = distance of the particles
+    mesh.neighbour_offsets.reserve(n + 1);
+    mesh.neighbour_offsets.push_back(0);
+    for (size_t i = 0; i < n; ++i) {
+        std::sort(neighbours[i].begin(), neighbours[i].end());
+        neighbours[i].erase(std::unique(neighbours[i].begin(), neighbours[i].end()), neighbours[i].end());
+        for (const auto neighbour: neighbours[i]) {
+            mesh.neighbour_ids.push_back(neighbour);
+            mesh.contact_areas.push_back(points[i].calculateEuclidianDistance(points[neighbour]));
+        }
+        mesh.neighbour_offsets.push_back(mesh.neighbour_ids.size());
+    }
+    abm::utilAlveolus::completeParticleMesh(mesh);
+    return mesh;
+}
@@ -0,0 +1,47 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#ifndef COREABM_PARTICLEMESHGENERATOR_H
+#define COREABM_PARTICLEMESHGENERATOR_H
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "ParticleMesh.h"
+
+class ParticleMeshGenerator {
+public:
+    // Class for generating a particle mesh on the whole alveolar sphere, as an alternative to pre-generated delaunay
+    // json files. Particles are seeded on a Fibonacci spiral ("fibonacci") or on a subdivided icosahedron
+    // ("icosphere") and connected by the spherical delaunay triangulation. The area of a particle is the area of its
+    // spherical voronoi cell. Cap and pores of Kohn are cut out at runtime by Particle::getIsInSite, as for json meshes.
+    ParticleMeshGenerator(double radius, unsigned int number_of_particles, int organism, std::string seeding);
+
+    ParticleMesh generateMesh() const;
+
+    /// File name of the binary cache, keyed by radius, number of particles, organism and seeding
+    std::string getCacheFileName() const;
+
+private:
+    using Triangle = std::array<unsigned int, 3>;
+
+    std::vector<Coordinate3D> seedFibonacci() const;
+    void seedIcosphere(std::vector<Coordinate3D> &points, std::vector<Triangle> &triangles) const;
+    std::vector<Triangle> triangulate(const std::vector<Coordinate3D> &points) const;
+    ParticleMesh buildMesh(const std::vector<Coordinate3D> &points, const std::vector<Triangle> &triangles) const;
+
+    double radius_{};
+    unsigned int number_of_particles_{};
+    int organism_{};
+    std::string seeding_{};
+};
+
+#endif //COREABM_PARTICLEMESHGENERATOR_H
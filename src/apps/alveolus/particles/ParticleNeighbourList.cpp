@@ -14,21 +14,28 @@ ParticleNeighbourList::ParticleNeighbourList(Particle *p) {
     particle_ = p;
 }
 
-void ParticleNeighbourList::addNeighbour(Particle *p, double area, double dc) {
+void ParticleNeighbourList::addNeighbour(Particle *p, double area) {
 
     if (!existsInNeighbourList(p)) {
-        neighbour_particles_.push_back(p);
         double distance = p->getPosition().calculateEuclidianDistance(particle_->getPosition());
-        neighbour_distances_.push_back(distance);
-        neighbour_contact_area_.push_back(area);
+        addNeighbour(p, area, distance);
+    }
+}
 
-        double prefactor_pse = dc * area / (distance * particle_->getArea());
-        prefactors_PSE_.push_back(prefactor_pse);
+void ParticleNeighbourList::addNeighbour(Particle *p, double area, double distance) {
+    neighbour_particles_.push_back(p);
+    neighbour_distances_.push_back(distance);
+    neighbour_contact_area_.push_back(area);
 
-        double const prefactor_gradient = area / (distance * particle_->getArea());
-        prefactors_gradient_.push_back(prefactor_gradient);
+    double const prefactor_gradient = area / (distance * particle_->getArea());
+    prefactors_gradient_.push_back(prefactor_gradient);
+}
 
-    }
+void ParticleNeighbourList::reserve(size_t number_of_neighbours) {
+    neighbour_particles_.reserve(number_of_neighbours);
+    neighbour_distances_.reserve(number_of_neighbours);
+    neighbour_contact_area_.reserve(number_of_neighbours);
+    prefactors_gradient_.reserve(number_of_neighbours);
 }
 
 bool ParticleNeighbourList::existsInNeighbourList(Particle *p) {
@@ -20,13 +20,15 @@ class Particle;
 class ParticleNeighbourList {
 public:
     ParticleNeighbourList(Particle *p);
-    void addNeighbour(Particle *p, double area, double dc);
+    void addNeighbour(Particle *p, double area);
+    /// Adds a neighbour with known distance, without checking for duplicates (mesh files are free of duplicates)
+    void addNeighbour(Particle *p, double area, double distance);
+    void reserve(size_t number_of_neighbours);
     bool existsInNeighbourList(Particle *p);
 
     std::vector<Particle *> &getNeighbours() { return neighbour_particles_; };
     std::vector<double> &getDistances() { return neighbour_distances_; };
     std::vector<double> &getContactAreas() { return neighbour_contact_area_; };
-    std::vector<double> &getPreFactorsPSE() { return prefactors_PSE_; };
     std::vector<double> &getPreFactorsGradient() { return prefactors_gradient_; };
 
 private:
@@ -37,7 +39,6 @@ private:
 
     std::vector<double> neighbour_distances_;
     std::vector<double> neighbour_contact_area_;
-    std::vector<double> prefactors_PSE_;
     std::vector<double> prefactors_gradient_;
 };
 
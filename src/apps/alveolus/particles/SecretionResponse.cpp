@@ -0,0 +1,195 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <tuple>
+
+#include "SecretionResponse.h"
+
+namespace {
+    using ResponseKey = std::tuple<size_t, double, double, std::vector<unsigned int>>;
+
+    std::mutex response_cache_mutex;
+    std::map<ResponseKey, std::weak_ptr<SecretionResponse>> response_cache;
+    std::atomic<size_t> stored_bytes{0};
+    std::atomic<size_t> memory_limit{0};
+}
+
+void DiffusionStencil::computeFingerprint() {
+    // FNV-1a over the bytes of the operator
+    fingerprint = 14695981039346656037ULL;
+    auto add = [this](const auto &values) {
+        const auto bytes = reinterpret_cast<const unsigned char *>(values.data());
+        for (size_t i = 0; i < values.size() * sizeof(values[0]); ++i) {
+            fingerprint = (fingerprint ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+    add(offsets);
+    add(columns);
+    add(prefactors);
+}
+
+std::shared_ptr<SecretionResponse> SecretionResponse::get(const std::shared_ptr<const DiffusionStencil> &stencil,
+                                                          double dt,
+                                                          std::vector<unsigned int> particle_ids, double tolerance) {
+    std::sort(particle_ids.begin(), particle_ids.end());
+    ResponseKey key{stencil->fingerprint, dt, tolerance, particle_ids};
+    std::lock_guard<std::mutex> lock(response_cache_mutex);
+    // Responses that are not used by any run anymore are released
+    for (auto entry = response_cache.begin(); entry != response_cache.end();) {
+        entry = entry->second.expired() ? response_cache.erase(entry) : std::next(entry);
+    }
+    auto &entry = response_cache[key];
+    auto response = entry.lock();
+    if (response == nullptr) {
+        response = std::make_shared<SecretionResponse>(stencil, dt, std::move(particle_ids), tolerance);
+        entry = response;
+    }
+    return response;
+}
+
+void SecretionResponse::setMemoryLimit(size_t bytes) {
+    memory_limit = bytes;
+}
+
+SecretionResponse::SecretionResponse(std::shared_ptr<const DiffusionStencil> stencil, double dt,
+                                     std::vector<unsigned int> particle_ids, double tolerance)
+        : stencil_(std::move(stencil)), dt_(dt), particle_ids_(std::move(particle_ids)), tolerance_(tolerance) {
+    field_.assign(stencil_->size(), 0.0);
+    changes_.assign(stencil_->size(), 0.0);
+    is_active_.assign(stencil_->size(), false);
+    for (auto id: particle_ids_) {
+        if (!is_active_[id]) {
+            is_active_[id] = true;
+            active_particles_.push_back(id);
+        }
+    }
+    steps_.emplace_back(std::make_unique<Step>());
+}
+
+SecretionResponse::~SecretionResponse() {
+    stored_bytes -= stored_bytes_;
+}
+
+bool SecretionResponse::ensureStep(size_t step) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!converged_ && steps_.size() <= step) {
+        // The first step (only the source itself) is always computed, such that new sources can be started
+        if (steps_.size() > 1 && memory_limit > 0 && stored_bytes > memory_limit) return false;
+        integrateStep();
+    }
+    return true;
+}
+
+void SecretionResponse::integrateStep() {
+    const auto &offsets = stencil_->offsets;
+    const auto &columns = stencil_->columns;
+    const auto &prefactors = stencil_->prefactors;
+
+    for (auto id: active_particles_) {
+        double conc_change_diffusion = 0.0, current_own_prefactor = 0.0;
+        for (auto k = offsets[id]; k < offsets[id + 1]; ++k) {
+            conc_change_diffusion += field_[columns[k]] * prefactors[k];
+            current_own_prefactor += prefactors[k];
+        }
+        conc_change_diffusion -= field_[id] * current_own_prefactor;
+        changes_[id] = conc_change_diffusion * dt_;
+    }
+    for (auto id: particle_ids_) {
+        changes_[id] += 1.0;
+    }
+
+    // Particles that were zero before the step activate all particles that have them as neighbour
+    const auto number_of_active_particles = active_particles_.size();
+    double max_value = 0.0;
+    for (size_t i = 0; i < number_of_active_particles; ++i) {
+        const auto id = active_particles_[i];
+        const bool was_zero = field_[id] == 0.0;
+        field_[id] += changes_[id];
+        max_value = std::max(max_value, std::abs(field_[id]));
+        if (was_zero && field_[id] != 0.0) {
+            for (auto k = stencil_->reverse_offsets[id]; k < stencil_->reverse_offsets[id + 1]; ++k) {
+                const auto neighbour = stencil_->reverse_columns[k];
+                if (!is_active_[neighbour] && stencil_->offsets[neighbour] != stencil_->offsets[neighbour + 1]) {
+                    is_active_[neighbour] = true;
+                    active_particles_.push_back(neighbour);
+                }
+            }
+        }
+    }
+
+    auto step = std::make_unique<Step>();
+    const double threshold = tolerance_ * max_value;
+    for (auto id: active_particles_) {
+        if (std::abs(field_[id]) > threshold) {
+            step->ids.push_back(id);
+            step->values.push_back(field_[id]);
+        }
+    }
+    addStoredBytes(step->ids.size() * (sizeof(unsigned int) + sizeof(double)));
+    steps_.emplace_back(std::move(step));
+
+    // The increment converges to zero (steady state, particles outside of the site absorb) or, on a closed mesh, to the
+    // uniform distribution of the secreted amount
+    if (number_of_active_particles == stencil_->number_of_particles_in_site &&
+        active_particles_.size() == number_of_active_particles) {
+        double min_change = std::numeric_limits<double>::max(), max_change = std::numeric_limits<double>::lowest();
+        for (auto id: active_particles_) {
+            min_change = std::min(min_change, changes_[id]);
+            max_change = std::max(max_change, changes_[id]);
+        }
+        if (max_change - min_change <= tolerance_ * max_value) {
+            converged_ = true;
+            converged_increment_.assign(field_.size(), 0.0);
+            for (auto id: active_particles_) {
+                converged_increment_[id] = changes_[id];
+            }
+            addStoredBytes(converged_increment_.size() * sizeof(double));
+            // The integration state is not needed anymore
+            std::vector<double>().swap(field_);
+            std::vector<double>().swap(changes_);
+        }
+    }
+}
+
+void SecretionResponse::addStoredBytes(size_t bytes) {
+    stored_bytes_ += bytes;
+    stored_bytes += bytes;
+}
+
+bool SecretionResponse::isExtrapolated(size_t step) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return converged_ && step + 1 >= steps_.size();
+}
+
+void SecretionResponse::addStep(size_t step, double factor, double *field, unsigned int stride) const {
+    const Step *stored_step;
+    size_t extrapolated_steps = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto last_step = steps_.size() - 1;
+        stored_step = steps_[std::min(step, last_step)].get();
+        if (converged_ && step > last_step) extrapolated_steps = step - last_step;
+    }
+    for (size_t i = 0; i < stored_step->ids.size(); ++i) {
+        field[stored_step->ids[i] * stride] += factor * stored_step->values[i];
+    }
+    if (extrapolated_steps > 0) {
+        // State after convergence is not modified anymore
+        const double extrapolation = factor * static_cast<double>(extrapolated_steps);
+        for (auto id: active_particles_) {
+            field[id * stride] += extrapolation * converged_increment_[id];
+        }
+    }
+}
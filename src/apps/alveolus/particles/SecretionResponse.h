@@ -0,0 +1,104 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#ifndef COREABM_SECRETIONRESPONSE_H
+#define COREABM_SECRETIONRESPONSE_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Explicit diffusion operator of one species on the particle mesh (PSE prefactors in CSR form, rows of particles
+// outside of the site are empty) together with its transposed neighbourhood.
+struct DiffusionStencil {
+    std::vector<unsigned int> offsets{};
+    std::vector<unsigned int> columns{};
+    std::vector<double> prefactors{};
+    std::vector<unsigned int> reverse_offsets{};
+    std::vector<unsigned int> reverse_columns{};
+    size_t number_of_particles_in_site{};
+    // Hash of the operator, identifies equal stencils of different runs
+    size_t fingerprint{};
+
+    [[nodiscard]] size_t size() const { return offsets.size() - 1; };
+    void computeFingerprint();
+};
+
+class SecretionResponse {
+public:
+    // Class for the step response of the particle system to a secretion source, i.e. the field R(m) after m diffusion
+    // steps of size dt with a constant secretion of 1 per step into each particle of the source:
+    //   R(0) = 0,  R(m + 1) = R(m) + dt * L R(m) + 1_source.
+    // The field of a source secreting with rate r from step n0 to step n1 is r * (R(n - n0) - R(n - n1)) by linearity.
+    // Steps are computed lazily by explicit integration and stored sparse, entries below the tolerance (relative to
+    // the maximum of the step) are truncated. Once the increment R(m) - R(m - 1) is uniform up to the tolerance (steady
+    // state or uniform growth), later steps are extrapolated linearly. Responses are shared between the runs of a
+    // process that use them at the same time and released with the last run.
+
+    /*!
+     * Returns the shared response of a source
+     * @param stencil Shared pointer to the diffusion stencil the response is computed with
+     * @param dt Double that contains the timestep
+     * @param particle_ids Vector of unsigned ints that contains the particles of the source
+     * @param tolerance Double that contains the relative truncation tolerance
+     * @return Shared pointer to the response
+     */
+    static std::shared_ptr<SecretionResponse> get(const std::shared_ptr<const DiffusionStencil> &stencil,
+                                                  double dt,
+                                                  std::vector<unsigned int> particle_ids, double tolerance);
+
+    /// Limit for the memory of all stored responses of the process in bytes, 0 means unlimited
+    static void setMemoryLimit(size_t bytes);
+
+    /*!
+     * Computes the response up to a step, if not available yet
+     * @param step Size_t that contains the number of steps since the start of the secretion
+     * @return Bool if the step is available (false if the memory limit is reached)
+     */
+    bool ensureStep(size_t step);
+
+    /// Adds factor * R(step) to a field with the given stride, the step must be ensured
+    void addStep(size_t step, double factor, double *field, unsigned int stride) const;
+
+    /// True if R(step) is extrapolated from the converged increment, i.e. later steps only add the increment
+    [[nodiscard]] bool isExtrapolated(size_t step) const;
+
+    SecretionResponse(std::shared_ptr<const DiffusionStencil> stencil, double dt, std::vector<unsigned int> particle_ids,
+                      double tolerance);
+    ~SecretionResponse();
+
+private:
+    struct Step {
+        std::vector<unsigned int> ids{};
+        std::vector<double> values{};
+    };
+
+    void integrateStep();
+    void addStoredBytes(size_t bytes);
+
+    std::shared_ptr<const DiffusionStencil> stencil_{};
+    double dt_{};
+    std::vector<unsigned int> particle_ids_{};
+    double tolerance_{};
+
+    mutable std::mutex mutex_{};
+    std::vector<std::unique_ptr<Step>> steps_{};
+    bool converged_{};
+    std::vector<double> converged_increment_{};
+    size_t stored_bytes_{};
+
+    // State of the explicit integration
+    std::vector<double> field_{};
+    std::vector<bool> is_active_{};
+    std::vector<unsigned int> active_particles_{};
+    std::vector<double> changes_{};
+};
+
+#endif //COREABM_SECRETIONRESPONSE_H
@@ -0,0 +1,177 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include "SpectralDiffusion.h"
+
+namespace {
+    using PropagatorKey = std::tuple<size_t, unsigned int, double, double, double>;
+
+    std::mutex propagator_cache_mutex;
+    std::map<PropagatorKey, std::shared_ptr<const SpectralPropagator>> propagator_cache;
+
+    // Directions closer to the poles are moved away from them, the spherical coordinates are singular there
+    constexpr double kMinimalSinTheta = 1e-9;
+}
+
+SphericalHarmonics::SphericalHarmonics(unsigned int band_limit) : band_limit_(band_limit) {
+    // Coefficients of the three-term recurrence of the normalised associated Legendre functions
+    recurrence_a_.resize(legendreIndex(band_limit_, band_limit_) + 1, 0.0);
+    recurrence_b_.resize(legendreIndex(band_limit_, band_limit_) + 1, 0.0);
+    legendre_.resize(legendreIndex(band_limit_ + 1, band_limit_ + 1) + 1, 0.0);
+    for (unsigned int m = 0; m <= band_limit_; ++m) {
+        for (unsigned int l = m + 2; l <= band_limit_; ++l) {
+            const double ll = l * l, mm = m * m;
+            recurrence_a_[legendreIndex(l, m)] = std::sqrt((4.0 * ll - 1.0) / (ll - mm));
+            recurrence_b_[legendreIndex(l, m)] = std::sqrt(((l - 1.0) * (l - 1.0) - mm) / (4.0 * (l - 1.0) * (l - 1.0) - 1.0));
+        }
+    }
+}
+
+void SphericalHarmonics::evaluate(const Coordinate3D &point, double *values, Coordinate3D *gradients) const {
+    const double r = point.getMagnitude();
+    double cos_theta = r > 0 ? point.z / r : 1.0;
+    double sin_theta = std::sqrt(std::max(0.0, 1.0 - cos_theta * cos_theta));
+    if (sin_theta < kMinimalSinTheta) {
+        sin_theta = kMinimalSinTheta;
+        cos_theta = std::copysign(std::sqrt(1.0 - sin_theta * sin_theta), cos_theta);
+    }
+    const double phi = std::atan2(point.y, point.x);
+
+    // Normalised associated Legendre functions P_lm(cos theta) (without Condon-Shortley phase)
+    auto P = [this](unsigned int l, unsigned int m) -> double & { return legendre_[legendreIndex(l, m)]; };
+    P(0, 0) = 1.0 / std::sqrt(4.0 * M_PI);
+    for (unsigned int m = 1; m <= band_limit_ + 1; ++m) {
+        P(m, m) = std::sqrt((2.0 * m + 1.0) / (2.0 * m)) * sin_theta * P(m - 1, m - 1);
+    }
+    for (unsigned int m = 0; m <= band_limit_; ++m) {
+        P(m + 1, m) = std::sqrt(2.0 * m + 3.0) * cos_theta * P(m, m);
+        for (unsigned int l = m + 2; l <= band_limit_; ++l) {
+            P(l, m) = recurrence_a_[legendreIndex(l, m)] * (cos_theta * P(l - 1, m) - recurrence_b_[legendreIndex(l, m)] * P(l - 2, m));
+        }
+    }
+
+    const double cos_phi = std::cos(phi), sin_phi = std::sin(phi);
+    const Coordinate3D e_theta{cos_theta * cos_phi, cos_theta * sin_phi, -sin_theta};
+    const Coordinate3D e_phi{-sin_phi, cos_phi, 0.0};
+    double cos_m_phi = 1.0, sin_m_phi = 0.0;
+    for (unsigned int m = 0; m <= band_limit_; ++m) {
+        if (m > 0) {
+            // cos(m phi) and sin(m phi) by rotation
+            const double cos_previous = cos_m_phi;
+            cos_m_phi = cos_previous * cos_phi - sin_m_phi * sin_phi;
+            sin_m_phi = sin_m_phi * cos_phi + cos_previous * sin_phi;
+        }
+        const double factor = m == 0 ? 1.0 : std::sqrt(2.0);
+        for (unsigned int l = m; l <= band_limit_; ++l) {
+            const size_t index = l * l + l;
+            const double p = factor * P(l, m);
+            values[index + m] = p * cos_m_phi;
+            if (m > 0) values[index - m] = p * sin_m_phi;
+
+            if (gradients != nullptr) {
+                // dP_lm/dtheta without division by sin(theta), which is stable at the poles
+                double dp_dtheta;
+                const double upper = m + 1 <= l ? std::sqrt((l - m) * (l + m + 1.0)) * P(l, m + 1) : 0.0;
+                if (m == 0) {
+                    dp_dtheta = -upper;
+                } else {
+                    dp_dtheta = 0.5 * (std::sqrt((l + m) * (l - m + 1.0)) * P(l, m - 1) - upper);
+                }
+                dp_dtheta *= factor;
+                gradients[index + m] = e_theta * (dp_dtheta * cos_m_phi) + e_phi * (-(m * p) / sin_theta * sin_m_phi);
+                if (m > 0) {
+                    gradients[index - m] = e_theta * (dp_dtheta * sin_m_phi) + e_phi * (m * p / sin_theta * cos_m_phi);
+                }
+            }
+        }
+    }
+}
+
+std::shared_ptr<const SpectralPropagator> SpectralPropagator::get(const Geometry &geometry,
+                                                                  const SphericalHarmonics &harmonics,
+                                                                  double dc, double dt, double penalty) {
+    PropagatorKey key{geometry.fingerprint, harmonics.getBandLimit(), dc, dt, penalty};
+    std::lock_guard<std::mutex> lock(propagator_cache_mutex);
+    auto &propagator = propagator_cache[key];
+    if (propagator == nullptr) {
+        propagator = std::make_shared<SpectralPropagator>(geometry, harmonics, dc, dt, penalty);
+    }
+    return propagator;
+}
+
+SpectralPropagator::SpectralPropagator(const Geometry &geometry, const SphericalHarmonics &harmonics, double dc,
+                                       double dt, double penalty) : size_(harmonics.size()) {
+    decay_.resize(size_);
+    source_factors_.resize(size_);
+    for (unsigned int l = 0; l <= harmonics.getBandLimit(); ++l) {
+        const double lambda = dc * l * (l + 1.0) / (geometry.radius * geometry.radius);
+        for (size_t index = l * l; index < (l + 1) * (l + 1); ++index) {
+            decay_[index] = std::exp(-lambda * dt);
+            source_factors_[index] = lambda > 0 ? -std::expm1(-lambda * dt) / lambda : dt;
+        }
+    }
+
+    // I + kappa dt M, only the lower triangle is assembled
+    auto &matrix = cholesky_factor_;
+    matrix.assign(size_ * size_, 0.0);
+    std::vector<double> values(size_);
+    for (size_t i = 0; i < geometry.positions.size(); ++i) {
+        if (!geometry.is_outside[i]) continue;
+        harmonics.evaluate(geometry.positions[i], values.data());
+        const double weight = penalty * dt * geometry.weights[i];
+        for (size_t p = 0; p < size_; ++p) {
+            const double weighted_value = weight * values[p];
+            double *row = &matrix[p * size_];
+            for (size_t q = 0; q <= p; ++q) {
+                row[q] += weighted_value * values[q];
+            }
+        }
+    }
+    for (size_t p = 0; p < size_; ++p) {
+        matrix[p * size_ + p] += 1.0;
+    }
+
+    // Cholesky factorisation in place (the matrix is symmetric positive definite)
+    for (size_t j = 0; j < size_; ++j) {
+        double diagonal = matrix[j * size_ + j];
+        for (size_t k = 0; k < j; ++k) diagonal -= matrix[j * size_ + k] * matrix[j * size_ + k];
+        diagonal = std::sqrt(diagonal);
+        matrix[j * size_ + j] = diagonal;
+        for (size_t i = j + 1; i < size_; ++i) {
+            double value = matrix[i * size_ + j];
+            for (size_t k = 0; k < j; ++k) value -= matrix[i * size_ + k] * matrix[j * size_ + k];
+            matrix[i * size_ + j] = value / diagonal;
+        }
+    }
+}
+
+void SpectralPropagator::step(double *coefficients, const double *source_rates) const {
+    for (size_t p = 0; p < size_; ++p) {
+        coefficients[p] = decay_[p] * coefficients[p] + source_factors_[p] * source_rates[p];
+    }
+    // Forward and backward substitution with the Cholesky factor
+    for (size_t i = 0; i < size_; ++i) {
+        double value = coefficients[i];
+        const double *row = &cholesky_factor_[i * size_];
+        for (size_t k = 0; k < i; ++k) value -= row[k] * coefficients[k];
+        coefficients[i] = value / row[i];
+    }
+    for (size_t i = size_; i-- > 0;) {
+        double value = coefficients[i];
+        for (size_t k = i + 1; k < size_; ++k) value -= cholesky_factor_[k * size_ + i] * coefficients[k];
+        coefficients[i] = value / cholesky_factor_[i * size_ + i];
+    }
+}
@@ -0,0 +1,87 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#ifndef COREABM_SPECTRALDIFFUSION_H
+#define COREABM_SPECTRALDIFFUSION_H
+
+#include <memory>
+#include <vector>
+
+#include "core/basic/Coordinate3D.h"
+
+class SphericalHarmonics {
+public:
+    // Class for the evaluation of real, orthonormal spherical harmonics Y_lm (l <= band limit) on the unit sphere.
+    // Harmonics are indexed by l * l + l + m, m = -l ... l (sin(|m| phi) for m < 0, cos(m phi) for m > 0).
+    explicit SphericalHarmonics(unsigned int band_limit);
+
+    [[nodiscard]] unsigned int getBandLimit() const { return band_limit_; };
+    [[nodiscard]] size_t size() const { return (band_limit_ + 1) * (band_limit_ + 1); };
+
+    /*!
+     * Evaluates all harmonics in the direction of a point
+     * @param point Coordinate3D that contains the point (does not need to be on the unit sphere)
+     * @param values Pointer to size() doubles for the values
+     * @param gradients Pointer to size() Coordinate3D for the surface gradients on the unit sphere (optional)
+     */
+    void evaluate(const Coordinate3D &point, double *values, Coordinate3D *gradients = nullptr) const;
+
+private:
+    [[nodiscard]] size_t legendreIndex(unsigned int l, unsigned int m) const { return l * (l + 1) / 2 + m; };
+
+    unsigned int band_limit_{};
+    std::vector<double> recurrence_a_{};
+    std::vector<double> recurrence_b_{};
+    // Scratch space of evaluate, instances must not be shared between threads
+    mutable std::vector<double> legendre_{};
+};
+
+class SpectralPropagator {
+public:
+    // Class for one timestep of diffusion on the sphere in spherical harmonic coefficients. Diffusion and sources are
+    // integrated exactly in time (a -> exp(-lambda_l dt) a + (1 - exp(-lambda_l dt)) / lambda_l s with
+    // lambda_l = dc l (l + 1) / R^2), regions outside of the site absorb by a penalty kappa * chi_out * c that is
+    // treated implicitly:  (I + kappa dt M) a_new = E a + F s  with the masked mass matrix M (Galerkin projection of
+    // chi_out, computed by quadrature over the particles). Propagators are shared between all runs of a process.
+
+    struct Geometry {
+        std::vector<Coordinate3D> positions{};
+        std::vector<double> weights{};
+        std::vector<bool> is_outside{};
+        double radius{};
+        size_t fingerprint{};
+    };
+
+    /*!
+     * Returns the shared propagator for a geometry and timestep
+     * @param geometry Geometry of the particles (quadrature points and weights area / R^2) and the mask
+     * @param harmonics SphericalHarmonics that define the band limit
+     * @param dc Double that contains the diffusion constant
+     * @param dt Double that contains the timestep
+     * @param penalty Double that contains the absorption rate kappa outside of the site
+     * @return Shared pointer to the propagator
+     */
+    static std::shared_ptr<const SpectralPropagator> get(const Geometry &geometry, const SphericalHarmonics &harmonics,
+                                                         double dc, double dt, double penalty);
+
+    SpectralPropagator(const Geometry &geometry, const SphericalHarmonics &harmonics, double dc, double dt,
+                       double penalty);
+
+    /// Advances the coefficients by one timestep with constant source rates (coefficients per time)
+    void step(double *coefficients, const double *source_rates) const;
+
+private:
+    size_t size_{};
+    std::vector<double> decay_{};
+    std::vector<double> source_factors_{};
+    std::vector<double> cholesky_factor_{};
+};
+
+#endif //COREABM_SPECTRALDIFFUSION_H
@@ -12,6 +12,7 @@
 #include <stdlib.h>
 #include <cmath>
 
+#include "MortonOrder.h"
 #include "StaticBalloonList.h"
 #include "core/utils/macros.h"
 
@@ -47,61 +48,82 @@ void StaticBalloonList::initialGridCreation() {
     gridSize[1] = ny;
     gridSize[2] = nz;
 
-    //create the vectors for the representation of grid points
+    //order the cells along the Morton curve, cells that are close in space are mostly close in memory
+    std::vector<std::pair<std::uint64_t, unsigned int> > codes;
+    codes.reserve(nx * ny * nz);
     for (unsigned int i = 0; i < nx; i++) {
-        std::vector<std::vector<std::vector<unsigned int> > > currXVector;
-
         for (unsigned int j = 0; j < ny; j++) {
-            std::vector<std::vector<unsigned int> > currYVector;
-
             for (unsigned int k = 0; k < nz; k++) {
-                std::vector<unsigned int> currZVector;
-                currYVector.push_back(currZVector);
+                codes.emplace_back(abm::utilAlveolus::mortonCode(i, j, k), (i * ny + j) * nz + k);
             }
-            currXVector.push_back(currYVector);
         }
-        balloonList.push_back(currXVector);
     }
+    std::sort(codes.begin(), codes.end());
+    cellRanks.resize(codes.size());
+    for (unsigned int rank = 0; rank < codes.size(); rank++) {
+        cellRanks[codes[rank].second] = rank;
+    }
+    cellOffsets.assign(codes.size() + 1, 0);
+    entries.clear();
+    pendingEntries.clear();
 }
 
 void StaticBalloonList::addCoordinateWithId(Coordinate3D input, unsigned int id) {
+    int u, v, w;
+    Coordinate3D pos = input;
+
+    u = (int) round((pos.x - lowerPoint.x) / gridConstant);
+    v = (int) round((pos.y - lowerPoint.y) / gridConstant);
+    w = (int) round((pos.z - lowerPoint.z) / gridConstant);
+
+    if (u >= gridSize[0] || v >= gridSize[1] || w >= gridSize[2] ||
+        u < 0 || v < 0 || w < 0) {
+        ERROR_STDERR("sphere's position is out of balloonlist-boundary area. "
+                     "Position:" <<
+                                 pos.x);
+        exit(1);
+    } else {
+        pendingEntries.emplace_back(cellRanks[(u * gridSize[1] + v) * gridSize[2] + w], Entry{input, id});
+    }
+}
 
-    if (objectAllocator.find(id) == objectAllocator.end()) {
-
-        int u, v, w;
-        Coordinate3D pos = input;
-
-        u = (int) round((pos.x - lowerPoint.x) / gridConstant);
-        v = (int) round((pos.y - lowerPoint.y) / gridConstant);
-        w = (int) round((pos.z - lowerPoint.z) / gridConstant);
+void StaticBalloonList::compact() {
+    //stable counting sort of the stored and the pending entries by the rank of their cell
+    std::vector<unsigned int> offsets(cellOffsets.size(), 0);
+    for (size_t rank = 0; rank + 1 < cellOffsets.size(); rank++) {
+        offsets[rank + 1] = cellOffsets[rank + 1] - cellOffsets[rank];
+    }
+    for (const auto &pending: pendingEntries) {
+        offsets[pending.first + 1]++;
+    }
+    for (size_t rank = 0; rank + 1 < offsets.size(); rank++) {
+        offsets[rank + 1] += offsets[rank];
+    }
 
-        if (u >= gridSize[0] || v >= gridSize[1] || w >= gridSize[2] ||
-            u < 0 || v < 0 || w < 0) {
-            ERROR_STDERR("sphere's position is out of balloonlist-boundary area. "
-                         "Position:" <<
-                                     pos.x);
-            exit(1);
-        } else {
-            balloonList[u][v][w].push_back(id);
-            coordinateAllocator[id] = input;
+    std::vector<Entry> sortedEntries(offsets.back());
+    std::vector<unsigned int> next(offsets.begin(), offsets.end() - 1);
+    for (size_t rank = 0; rank + 1 < cellOffsets.size(); rank++) {
+        for (auto index = cellOffsets[rank]; index < cellOffsets[rank + 1]; index++) {
+            sortedEntries[next[rank]++] = entries[index];
         }
     }
-
+    for (const auto &pending: pendingEntries) {
+        sortedEntries[next[pending.first]++] = pending.second;
+    }
+    entries = std::move(sortedEntries);
+    cellOffsets = std::move(offsets);
+    pendingEntries.clear();
 }
 
-void StaticBalloonList::getInteractions(Coordinate3D myPos, std::vector<unsigned int> &neighbours) {
-
-    std::vector<unsigned int>::iterator itIds;
-
+template<typename Visitor>
+void StaticBalloonList::visitCells(const Coordinate3D &pos, double thresh, Visitor visit) const {
     int u, v, w;
-    Coordinate3D pos = myPos;
-
     u = round((pos.x - lowerPoint.x) / gridConstant);
     v = round((pos.y - lowerPoint.y) / gridConstant);
     w = round((pos.z - lowerPoint.z) / gridConstant);
 
     int nHSize;
-    nHSize = (int) ceil(threshold / gridConstant);
+    nHSize = (int) ceil(thresh / gridConstant);
 
     for (int i = u - nHSize; i <= u + nHSize; i++) {
         if (i < gridSize[0] && i >= 0) {
@@ -109,14 +131,9 @@ void StaticBalloonList::getInteractions(Coordinate3D myPos, std::vector<unsigned
                 if (j < gridSize[1] && j >= 0) {
                     for (int k = w - nHSize; k <= w + nHSize; k++) {
                         if (k < gridSize[2] && k >= 0) {
-                            itIds = balloonList[i][j][k].begin();
-                            while (itIds != balloonList[i][j][k].end()) {
-                                unsigned int idPN = *itIds;
-                                double distance = pos.calculateEuclidianDistance(coordinateAllocator[idPN]);
-                                if (distance < threshold) {
-                                    neighbours.push_back(idPN);
-                                }
-                                itIds++;
+                            const auto rank = cellRanks[(i * gridSize[1] + j) * gridSize[2] + k];
+                            for (auto index = cellOffsets[rank]; index < cellOffsets[rank + 1]; index++) {
+                                visit(entries[index]);
                             }
                         }
                     }
@@ -124,48 +141,35 @@ void StaticBalloonList::getInteractions(Coordinate3D myPos, std::vector<unsigned
             }
         }
     }
-
 }
 
-unsigned int StaticBalloonList::getClosestObjectIndex(Coordinate3D myPos) {
-    std::vector<unsigned int>::iterator itIds;
-
-    int u, v, w;
-    Coordinate3D pos = myPos;
+void StaticBalloonList::getInteractions(Coordinate3D myPos, std::vector<unsigned int> &neighbours) {
+    if (!pendingEntries.empty()) compact();
+    getInteractions(myPos, neighbours, threshold);
+}
 
-    u = round((pos.x - lowerPoint.x) / gridConstant);
-    v = round((pos.y - lowerPoint.y) / gridConstant);
-    w = round((pos.z - lowerPoint.z) / gridConstant);
+void StaticBalloonList::getInteractions(Coordinate3D myPos, std::vector<unsigned int> &neighbours, double thresh) const {
+    visitCells(myPos, thresh, [&](const Entry &entry) {
+        double distance = myPos.calculateEuclidianDistance(entry.position);
+        if (distance < thresh) {
+            neighbours.push_back(entry.id);
+        }
+    });
+}
 
-    int nHSize;
-    nHSize = (int) ceil(threshold / gridConstant);
+unsigned int StaticBalloonList::getClosestObjectIndex(Coordinate3D myPos) {
     double minDistance = 1000;
-    unsigned int closestObjectIndex = 999999;
-
-    for (int i = u - nHSize; i <= u + nHSize; i++) {
-        if (i < gridSize[0] && i >= 0) {
-            for (int j = v - nHSize; j <= v + nHSize; j++) {
-                if (j < gridSize[1] && j >= 0) {
-                    for (int k = w - nHSize; k <= w + nHSize; k++) {
-                        if (k < gridSize[2] && k >= 0) {
-                            itIds = balloonList[i][j][k].begin();
-                            while (itIds != balloonList[i][j][k].end()) {
-                                unsigned int idPN = *itIds;
-                                double distance = pos.calculateEuclidianDistance(coordinateAllocator[idPN]);
-                                if (distance < minDistance) {
-                                    minDistance = distance;
-                                    closestObjectIndex = idPN;
-                                }
-                                itIds++;
-                            }
-
-                        }
-                    }
-                }
-            }
+    unsigned int closestObjectIndex = no_object;
+
+    if (!pendingEntries.empty()) compact();
+    visitCells(myPos, threshold, [&](const Entry &entry) {
+        double distance = myPos.calculateEuclidianDistance(entry.position);
+        if (distance < minDistance) {
+            minDistance = distance;
+            closestObjectIndex = entry.id;
         }
-    }
-    if (closestObjectIndex == 99999) {
+    });
+    if (closestObjectIndex == no_object) {
         INFO_STDOUT("warning: no closest neighbour found!");
     }
     return closestObjectIndex;
@@ -173,42 +177,13 @@ unsigned int StaticBalloonList::getClosestObjectIndex(Coordinate3D myPos) {
 
 void StaticBalloonList::getClosestObjectIndices(Coordinate3D myPos, std::vector<unsigned int> &neighbourList,
                                                 unsigned int closestXParticles) {
-    std::vector<unsigned int>::iterator itIds;
     std::vector<std::pair<double, unsigned int> > distancesOfIndices;
 
-    int u, v, w;
-    Coordinate3D pos = myPos;
-
-    u = round((pos.x - lowerPoint.x) / gridConstant);
-    v = round((pos.y - lowerPoint.y) / gridConstant);
-    w = round((pos.z - lowerPoint.z) / gridConstant);
-
-    int nHSize;
-    nHSize = (int) ceil(threshold / gridConstant);
-    double minDistance = 1000;
-    unsigned int closestObjectIndex = 999999;
-
-    for (int i = u - nHSize; i <= u + nHSize; i++) {
-        if (i < gridSize[0] && i >= 0) {
-            for (int j = v - nHSize; j <= v + nHSize; j++) {
-                if (j < gridSize[1] && j >= 0) {
-                    for (int k = w - nHSize; k <= w + nHSize; k++) {
-                        if (k < gridSize[2] && k >= 0) {
-                            itIds = balloonList[i][j][k].begin();
-                            while (itIds != balloonList[i][j][k].end()) {
-                                unsigned int idPN = *itIds;
-                                double distance = pos.calculateEuclidianDistance(coordinateAllocator[idPN]);
-                                std::pair<double, unsigned int> curDistanceOfIdx = std::pair<double, unsigned int>(
-                                        distance, idPN);
-                                distancesOfIndices.push_back(curDistanceOfIdx);
-                                itIds++;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
+    if (!pendingEntries.empty()) compact();
+    visitCells(myPos, threshold, [&](const Entry &entry) {
+        double distance = myPos.calculateEuclidianDistance(entry.position);
+        distancesOfIndices.emplace_back(distance, entry.id);
+    });
 
     std::sort(distancesOfIndices.begin(), distancesOfIndices.end());
     std::vector<std::pair<double, unsigned int> >::iterator it = distancesOfIndices.begin();
@@ -218,4 +193,4 @@ void StaticBalloonList::getClosestObjectIndices(Coordinate3D myPos, std::vector<
         curNumberOfInserts++;
         it++;
     }
-}
\ No newline at end of file
+}
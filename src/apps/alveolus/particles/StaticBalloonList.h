@@ -11,14 +11,17 @@
 #ifndef STATICBALLOONLIST_H
 #define    STATICBALLOONLIST_H
 
+#include <limits>
 #include <vector>
-#include <map>
 
 #include "core/basic/Coordinate3D.h"
 
 class StaticBalloonList {
 public:
   // Class for defining a baloon list as a grid that represents the whole environment for efficient neighbourhood detection of cells.
+  // The cells are stored contiguously in Morton order of the grid, every entry keeps the coordinate next to the id.
+    static constexpr unsigned int no_object = std::numeric_limits<unsigned int>::max();
+
     StaticBalloonList();
     StaticBalloonList(const StaticBalloonList &orig);
     virtual ~StaticBalloonList();
@@ -26,18 +29,35 @@ public:
     StaticBalloonList(double gridConstant, Coordinate3D lowerValues, Coordinate3D upperValues);
     void instantiate();
     void getInteractions(Coordinate3D myPos, std::vector<unsigned int> &neighbours);
+    /// Same as getInteractions with the given threshold, but without compact, i.e. queries of several threads do not interfere
+    void getInteractions(Coordinate3D myPos, std::vector<unsigned int> &neighbours, double thresh) const;
+    /// Index of the closest object within the threshold, no_object if there is none
     unsigned int getClosestObjectIndex(Coordinate3D myPos);
     void getClosestObjectIndices(Coordinate3D myPos, std::vector<unsigned int> &neighbourList,
                                  unsigned int closestXParticles);
     void addCoordinateWithId(Coordinate3D input, unsigned int id);
     void setThreshold(double thresh) { threshold = thresh; };
+    /// Merges added coordinates into the cells, done by the first query after an addition
+    void compact();
 
 private:
+    struct Entry {
+        Coordinate3D position;
+        unsigned int id;
+    };
+
+    template<typename Visitor>
+    void visitCells(const Coordinate3D &pos, double thresh, Visitor visit) const;
+
     double gridConstant;
     double threshold;
-    std::vector<std::vector<std::vector<std::vector<unsigned int> > > > balloonList;
-    std::map<unsigned int, int *> objectAllocator;
-    std::map<unsigned int, Coordinate3D> coordinateAllocator;
+    // Rank of every cell (index (u * ny + v) * nz + w) on the Morton curve, entries of a cell are
+    // entries[cellOffsets[rank]] ... entries[cellOffsets[rank + 1] - 1] in order of insertion
+    std::vector<unsigned int> cellRanks;
+    std::vector<unsigned int> cellOffsets;
+    std::vector<Entry> entries;
+    // Entries that are added after the last query (with the rank of their cell), they are merged by compact
+    std::vector<std::pair<unsigned int, Entry>> pendingEntries;
     Coordinate3D lowerPoint;
     Coordinate3D upperPoint;
     int gridSize[3];
@@ -45,4 +65,3 @@ private:
 };
 
 #endif    /* STATICBALLOONLIST_H */
-
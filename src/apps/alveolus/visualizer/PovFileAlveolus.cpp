@@ -151,6 +151,7 @@ void PovFileAlveolus::transcribeSite(Site &site) {
 
 void PovFileAlveolus::transcribeParticles(Site &site) {
     AlveoleSite &alveoleSite = dynamic_cast<AlveoleSite&>(site);
+    alveoleSite.particle_manager_->synchronizeConcentrations();
     auto particles = alveoleSite.particle_manager_->getAllParticles();
     auto triangles = alveoleSite.particle_manager_->getTriangles();
 
@@ -13,6 +13,7 @@
 #include "core/simulation/cells/FungalCell.h"
 #include "FungalCellExample.h"
 #include "core/simulation/Site.h"
+#include "core/utils/RunArena.h"
 
 
 CellFactoryExample::CellFactoryExample(const std::unique_ptr<abm::util::SimulationParameters::SiteParameters>
@@ -28,13 +29,13 @@ std::shared_ptr<Cell> CellFactoryExample::createCell(const std::string &agenttyp
     std::shared_ptr<Cell> agent{};
     auto site_tag = site->getIdentifier();
     if (agenttype == "Cell") {
-        agent = std::make_shared<Cell>(std::move(c), id, site, time_delta, current_time);
+        agent = abm::util::makeShared<Cell>(std::move(c), id, site, time_delta, current_time);
     } else if (agenttype == "ImmuneCell") {
-        agent = std::make_shared<ImmuneCell>(std::move(c), id, site, time_delta, current_time);
+        agent = abm::util::makeShared<ImmuneCell>(std::move(c), id, site, time_delta, current_time);
     } else if (agenttype == "FungalCell") {
-        agent = std::make_shared<FungalCell>(std::move(c), id, site, time_delta, current_time);
+        agent = abm::util::makeShared<FungalCell>(std::move(c), id, site, time_delta, current_time);
     }else if (agenttype == "FungalCellExample") {
-        agent = std::make_shared<FungalCellExample>(std::move(c), id, site, time_delta, current_time);
+        agent = abm::util::makeShared<FungalCellExample>(std::move(c), id, site, time_delta, current_time);
     }
     agent->setup(time_delta, current_time, agent_configurations_[site_tag + agenttype].get());
     return agent;
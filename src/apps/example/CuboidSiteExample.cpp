@@ -259,7 +259,9 @@ void CuboidSiteExample::doAgentDynamics(Randomizer *random_generator, const Simu
     const auto &all_agents = agent_manager_->getAllAgents();
     if (!all_agents.empty()) {
         // Loop over all agents (random order)
-        const auto current_order = abm::util::generateRandomPermutation(random_generator, all_agents.size());
+        agent_order_.resize(all_agents.size());
+        abm::util::generateRandomPermutation(random_generator, agent_order_.data(), agent_order_.size());
+        const auto &current_order = agent_order_;
         for (auto agent_idx = current_order.begin(); agent_idx < current_order.end(); ++agent_idx) {
             auto curr_agent = all_agents[*agent_idx];
             if (nullptr != curr_agent) {
@@ -276,6 +278,9 @@ void CuboidSiteExample::doAgentDynamics(Randomizer *random_generator, const Simu
             }
         }
 
+        // Intracellular models of all agents are integrated in one batch per model
+        if (auto *ode_engine = agent_manager_->getOdeEngine()) ode_engine->integrate(dt);
+
         // Clean up agents
         agent_manager_->cleanUpAgents(current_time);
         agent_manager_->inputOfAgents(current_time, random_generator);
@@ -0,0 +1,40 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#include <boost/filesystem.hpp>
+#include <iostream>
+
+#include "apps/alveolus/particles/ParticleMesh.h"
+#include "core/utils/macros.h"
+
+// Converts a delaunay particle json file (see src/apps/alveolus/input/particle-dist) into the binary mesh format that
+// is memory mapped by the ParticleManager. Without output file, the .pmesh file is written next to the json file.
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        ERROR_STDERR("usage: " << argv[0] << " <particles.json> [<particles.pmesh>]");
+        return 1;
+    }
+    const boost::filesystem::path input_file(argv[1]);
+    if (!boost::filesystem::exists(input_file)) {
+        ERROR_STDERR("Particle file " << input_file.string() << " does not exist!");
+        return 2;
+    }
+    const auto output_file = argc == 3 ? boost::filesystem::path(argv[2])
+                                       : boost::filesystem::path(input_file).replace_extension(".pmesh");
+
+    auto mesh = abm::utilAlveolus::readParticleMeshFromJson(input_file.string());
+    abm::utilAlveolus::reorderParticleMesh(mesh);
+    if (!abm::utilAlveolus::writeParticleMeshToBinary(output_file.string(), mesh)) {
+        return 3;
+    }
+    std::cout << "Converted " << mesh.size() << " particles with " << mesh.neighbour_ids.size() << " neighbour entries and "
+              << mesh.triangles.size() << " triangles to " << output_file.string() << std::endl;
+    return 0;
+}
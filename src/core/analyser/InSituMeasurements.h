@@ -16,6 +16,7 @@
 #include <utility>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <set>
 
 #include "core/utils/time_util.h"
@@ -41,6 +42,7 @@ public:
 
     template<typename T, typename U>
     void increment(const std::string &measurement_name, const std::string &curve_name, U value) {
+        std::lock_guard<std::mutex> lock(values_mutex_);
         if constexpr(std::is_same_v<T, HistogramMeasurement>) {
             const auto &measurement = histogram_measurements_.find(measurement_name);
             if (measurement != histogram_measurements_.end()) {
@@ -73,6 +75,7 @@ public:
     }
     template<typename T, typename ...ARGS>
     void addValues(const std::string &measurement_name, ARGS &&...args) {
+        std::lock_guard<std::mutex> lock(values_mutex_);
         if constexpr(std::is_same_v<T, HistogramMeasurement>) {
             const auto &measurement = histogram_measurements_.find(measurement_name);
             if (measurement != histogram_measurements_.end()) {
@@ -92,6 +95,8 @@ protected:
     std::unordered_set<std::string> active_measurements_;
     std::unordered_map<std::string, std::unique_ptr<HistogramMeasurement>> histogram_measurements_{};
     std::unordered_map<std::string, std::unique_ptr<PairMeasurement>> pair_measurements_{};
+    // Agents of one run may be updated in parallel
+    std::mutex values_mutex_{};
 };
 
 #endif /* CORE_ANALYSER_INSITUMEASUREMENTS_H */
@@ -16,6 +16,13 @@
 
 Randomizer::Randomizer(int seed) : seed_(seed), random_mt_(seed) {}
 
+void Randomizer::reseed(int seed) {
+    seed_ = seed;
+    random_mt_.seed(seed);
+    second_gauss_available_ = false;
+    second_gauss_value_ = 0.0;
+}
+
 double Randomizer::generateDouble() {
 
     return 1.0 * (random_mt_)() / boost::mt19937::max();
@@ -25,6 +25,8 @@ class Randomizer {
 public:
   // Class for wrapping C++ random generator
     explicit Randomizer(int seed);
+    /// Restarts the generator with a new seed, it draws the same numbers as a new generator with this seed
+    void reseed(int seed);
     double generateDouble();
     double generateDouble(double);
     double generateDouble(double, double);
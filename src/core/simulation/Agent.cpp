@@ -19,7 +19,7 @@
 
 Agent::Agent() {
     id = 0;
-    initialTime = 0;
+    *initialTime = 0;
     is_deleted_ = false;
     initialPosition = std::make_unique<Coordinate3D>();
     previousPosition = std::make_unique<Coordinate3D>();
@@ -42,7 +42,7 @@ Agent::Agent(std::unique_ptr<Coordinate3D> c, int id, Site *site) {
     previousPosition = std::make_unique<Coordinate3D>();
     setPreviousPosition(initialPosition.get());
     position = std::move(c);
-    this->initialTime = 0;
+    *initialTime = 0;
     currShift = 0;
     hasBeenMoved = false;
     positionShiftAllowed = true;
@@ -51,6 +51,33 @@ Agent::Agent(std::unique_ptr<Coordinate3D> c, int id, Site *site) {
 
 }
 
+Agent::~Agent() {
+    if (components_ != nullptr) components_->release(components_handle_);
+}
+
+void Agent::attachComponents(const std::shared_ptr<AgentComponents> &components) {
+    if (components_ != nullptr) return;
+    components_ = components;
+    type_id_ = abm::util::Names::intern(getTypeName());
+    components_handle_ = components_->allocate(getTypeName());
+    components_->position(components_handle_) = *position;
+    components_->initialTime(components_handle_) = *initialTime;
+    components_->lastTreatmentTime(components_handle_) = *timestepLastTreatment;
+    position = components_->sharePosition(components_handle_);
+    initialTime = &components_->initialTime(components_handle_);
+    timestepLastTreatment = &components_->lastTreatmentTime(components_handle_);
+}
+
+int Agent::getTypeId() {
+    if (type_id_ == abm::util::Names::no_name) type_id_ = abm::util::Names::intern(getTypeName());
+    return type_id_;
+}
+
+void Agent::setMovement(std::shared_ptr<Movement> movement) {
+    movement_ = std::move(movement);
+    if (components_ != nullptr && movement_ != nullptr) movement_->attachComponents(*components_, components_handle_);
+}
+
 void Agent::doAllActionsForTimestep(double timestep, double current_time) {
     move(timestep, current_time);
 }
@@ -102,11 +129,11 @@ bool Agent::shiftPosition(Coordinate3D *shifter, double current_time, SphereRepr
 
 double Agent::getLifetime(double curTime) {
 
-    return curTime - initialTime;
+    return curTime - *initialTime;
 }
 
 double Agent::getInitialTime() {
-    return initialTime;
+    return *initialTime;
 }
 
 Coordinate3D *Agent::getCurrentShift() {
@@ -145,7 +172,7 @@ void Agent::applyMethodByName(std::string mehtodName) {
 }
 
 void Agent::resetAgent(Coordinate3D pos, double current_time) {
-    initialTime = current_time;
+    *initialTime = current_time;
     setInitialPosition(pos);
     setPreviousPosition(&pos);
     id = site->getAgentManager()->getIdHandling();
@@ -210,12 +237,12 @@ bool Agent::hasCollisionsInsideAgent(Agent *ingestedAgent, const std::vector<Age
 }
 
 void Agent::setTimestepLastTreatment(double current_time) {
-    timestepLastTreatment = current_time;
+    *timestepLastTreatment = current_time;
 }
 
 bool Agent::agentTreatedInCurrentTimestep(double current_time) const {
     bool treatedInCurrentTimestep = false;
-    if (timestepLastTreatment == current_time) {
+    if (*timestepLastTreatment == current_time) {
         treatedInCurrentTimestep = true;
     }
     return treatedInCurrentTimestep;
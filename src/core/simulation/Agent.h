@@ -14,10 +14,12 @@
 #include <iostream>
 
 #include "core/basic/Coordinate3D.h"
+#include "core/simulation/AgentComponents.h"
 #include "core/simulation/movement/RandomWalk.h"
 #include "core/simulation/movement/Movement.h"
 #include "core/simulation/morphology/Morphology.h"
 #include "core/simulation/states/CellState.h"
+#include "core/utils/Names.h"
 
 class Site; //forward declaration
 class Interactions; //forward declaration
@@ -27,7 +29,7 @@ public:
   // Abstract class for agents in the hABM. This class provides the cell class with it main functionality.
     Agent();
     Agent(std::unique_ptr<Coordinate3D>, int, Site *);
-    virtual ~Agent() = default;
+    virtual ~Agent();
 
     void setPosition(Coordinate3D newPos);
     void setBeenMovedThisTimestep(bool newHasBeenMoved);
@@ -36,13 +38,17 @@ public:
     void setPreviousPosition(Coordinate3D *pos) { *previousPosition = *pos; }
     void setInputRate(double input_rate) {inputRate = input_rate;}
     void setMorphology(std::shared_ptr<Morphology> morphology) {morphology_ = std::move(morphology);};
-    void setMovement(std::shared_ptr<Movement> movement) {movement_ = std::move(movement);};
+    void setMovement(std::shared_ptr<Movement> movement);
     void setPassiveMovement(std::shared_ptr<Movement> passiveMovement) {passive_movement_ = std::move(passiveMovement);};
     void setInteractions(std::shared_ptr<Interactions> interactions) {interactions_ = interactions;};
     void resetAgent(Coordinate3D, double current_time);
     void setShiftAllowed(bool shiftAllowed) {positionShiftAllowed = shiftAllowed;};
+    /// Moves the hot data (position, timers, state id) of the agent into a slot of the component store
+    void attachComponents(const std::shared_ptr<AgentComponents> &components);
 
     [[nodiscard]] int getId() const;
+    /// Id of the type name in abm::util::Names, interned when the agent is attached to the component store
+    int getTypeId();
     [[nodiscard]] bool isDeleted() const { return is_deleted_; }
     [[nodiscard]] bool agentTreatedInCurrentTimestep(double current_time) const;
     bool hasBeenMovedThisTimestep();
@@ -66,6 +72,8 @@ public:
     Movement *getPassiveMovement() {return passive_movement_.get();};
     Interactions *getInteractions() {return interactions_.get();};
     Morphology *getMorphology() {return morphology_.get();};
+    AgentComponents *getComponents() {return components_.get();};
+    [[nodiscard]] const AgentComponents::Handle &getComponentsHandle() const {return components_handle_;};
 
     std::map<std::string, double> molecule_uptake;
 
@@ -75,12 +83,13 @@ public:
     virtual CellState *getCurrentCellState() = 0;
     virtual std::string generatePovObject() = 0;
     virtual void setPassive() = 0;
-    virtual void setVariableOnEvent(std::string variable, double value) = 0;
+    virtual void setVariableOnEvent(const std::string &variable, double value) = 0;
     virtual void setFeatureValueByName(std::string featureName, int value) = 0;
     virtual void applyMethodByName(std::string mehtodName) = 0;
     virtual void changeState(std::string stateName) = 0;
-    virtual double getFeatureValueByName(std::string featureName) = 0;
+    virtual double getFeatureValueByName(const std::string &featureName) = 0;
     virtual std::shared_ptr<CellState> getCellStateByName(std::string nameOfState) = 0;
+    virtual std::shared_ptr<CellState> getCellStateById(int state_id) = 0;
     virtual void setState(std::shared_ptr<CellState> state) = 0;
     virtual Morphology *getSurface() = 0;
     virtual Coordinate3D get_gradient() = 0;
@@ -92,8 +101,8 @@ protected:
     bool hasBeenMoved{};
     bool passive{};
     bool is_deleted_{};
-    double initialTime{};
-    double timestepLastTreatment{};
+    double *initialTime{&detached_times_[0]};
+    double *timestepLastTreatment{&detached_times_[1]};
     double inputRate{};
 
     std::shared_ptr<Movement> movement_{};
@@ -108,6 +117,13 @@ protected:
     std::shared_ptr<Coordinate3D> position{};
     std::shared_ptr<Movement> movement{};
     std::shared_ptr<Movement> passiveMovement{};
+
+    // Hot data is kept in the component store of the agent manager once the agent is attached, until then the
+    // timers are stored in the agent itself
+    std::shared_ptr<AgentComponents> components_{};
+    AgentComponents::Handle components_handle_{};
+    int type_id_{abm::util::Names::no_name};
+    double detached_times_[2]{};
 };
 
 #endif /* CORE_SIMULATION_AGENT_H */
@@ -0,0 +1,117 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#include <algorithm>
+#include <functional>
+
+#include "core/simulation/AgentComponents.h"
+#include "core/utils/macros.h"
+
+AgentComponents::AgentComponents() {
+    blocks_.reserve(max_number_of_types);
+}
+
+unsigned int AgentComponents::findOrAddType(const std::string &agent_type) {
+    auto[type_it, inserted] = type_indices_.emplace(agent_type, blocks_.size());
+    if (inserted) {
+        if (blocks_.size() == max_number_of_types) {
+            ERROR_STDERR("More than " << max_number_of_types << " agent types in the component store");
+            exit(1);
+        }
+        blocks_.emplace_back(std::make_unique<Block>());
+    }
+    return type_it->second;
+}
+
+AgentComponents::Handle AgentComponents::allocate(const std::string &agent_type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto type = findOrAddType(agent_type);
+    auto &block = *blocks_[type];
+
+    unsigned int slot;
+    if (block.free_slots.empty()) {
+        slot = block.number_of_slots++;
+        if (slot / chunk_size == block.chunks.size()) {
+            block.chunks.emplace_back(std::make_shared<Chunk>());
+        }
+    } else {
+        // Lowest free slot first, keeps the occupied slots of a type dense
+        std::pop_heap(block.free_slots.begin(), block.free_slots.end(), std::greater<>());
+        slot = block.free_slots.back();
+        block.free_slots.pop_back();
+    }
+
+    Handle handle{type, slot, true, block.chunks[slot / chunk_size].get()};
+    auto &c = *handle.chunk;
+    const auto i = slot % chunk_size;
+    c.positions[i] = Coordinate3D{};
+    c.radii[i] = 0.0;
+    c.state_ids[i] = -1;
+    c.directions[i] = Coordinate3D{};
+    c.persistence_times_left[i] = 0.0;
+    c.initial_times[i] = 0.0;
+    c.last_treatment_times[i] = 0.0;
+    c.occupied[i] = true;
+    c.counted[i] = false;
+    return handle;
+}
+
+void AgentComponents::release(const Handle &handle) {
+    if (!handle.valid) return;
+    setCounted(handle, false);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &block = *blocks_[handle.type];
+    handle.chunk->occupied[handle.slot % chunk_size] = false;
+    block.free_slots.push_back(handle.slot);
+    std::push_heap(block.free_slots.begin(), block.free_slots.end(), std::greater<>());
+}
+
+void AgentComponents::setStateId(const Handle &h, int state_id) {
+    const auto i = h.slot % chunk_size;
+    auto &current = h.chunk->state_ids[i];
+    if (current == state_id) return;
+    if (h.chunk->counted[i]) {
+        auto &block = *blocks_[h.type];
+        if (current >= 0) block.state_counts[current].fetch_sub(1, std::memory_order_relaxed);
+        if (state_id >= 0) block.state_counts[state_id].fetch_add(1, std::memory_order_relaxed);
+    }
+    current = state_id;
+}
+
+void AgentComponents::setCounted(const Handle &h, bool counted) {
+    const auto i = h.slot % chunk_size;
+    if (h.chunk->counted[i] == counted) return;
+    h.chunk->counted[i] = counted;
+    auto &block = *blocks_[h.type];
+    const auto state_id = h.chunk->state_ids[i];
+    if (counted) {
+        block.size.fetch_add(1, std::memory_order_relaxed);
+        if (state_id >= 0) block.state_counts[state_id].fetch_add(1, std::memory_order_relaxed);
+    } else {
+        block.size.fetch_sub(1, std::memory_order_relaxed);
+        if (state_id >= 0) block.state_counts[state_id].fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+size_t AgentComponents::getNumberOfAgents(unsigned int type, int state_id) const {
+    if (state_id < 0 || state_id >= static_cast<int>(abm::util::Names::max_number_of_names)) return 0;
+    return blocks_[type]->state_counts[state_id].load(std::memory_order_relaxed);
+}
+
+unsigned int AgentComponents::getTypeIndex(const std::string &agent_type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return findOrAddType(agent_type);
+}
+
+std::shared_ptr<Coordinate3D> AgentComponents::sharePosition(const Handle &h) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto &owner = blocks_[h.type]->chunks[h.slot / chunk_size];
+    return std::shared_ptr<Coordinate3D>(owner, &owner->positions[h.slot % chunk_size]);
+}
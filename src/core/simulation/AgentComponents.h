@@ -0,0 +1,108 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#ifndef CORE_SIMULATION_AGENTCOMPONENTS_H
+#define CORE_SIMULATION_AGENTCOMPONENTS_H
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/basic/Coordinate3D.h"
+#include "core/utils/Names.h"
+
+class AgentComponents {
+public:
+    // Component store for the hot data of the agents in structure-of-arrays layout, one block per agent type. The
+    // columns are split into chunks of fixed capacity, i.e. components keep their address for the lifetime of the agent
+    // and the agent, its spheres and its movement access them by pointer. Slots of destroyed agents are reused.
+    static constexpr unsigned int chunk_size = 256;
+    // Agent types are names, the blocks are allocated up front and never move
+    static constexpr unsigned int max_number_of_types = abm::util::Names::max_number_of_names;
+
+    struct Chunk {
+        std::array<Coordinate3D, chunk_size> positions{};
+        std::array<double, chunk_size> radii{};
+        std::array<int, chunk_size> state_ids{}; // ids of abm::util::Names
+        std::array<Coordinate3D, chunk_size> directions{};
+        std::array<double, chunk_size> persistence_times_left{};
+        std::array<double, chunk_size> initial_times{};
+        std::array<double, chunk_size> last_treatment_times{};
+        std::array<bool, chunk_size> occupied{};
+        std::array<bool, chunk_size> counted{};
+    };
+
+    struct Handle {
+        unsigned int type{};
+        unsigned int slot{};
+        bool valid{};
+        Chunk *chunk{};
+    };
+
+    AgentComponents();
+
+    /// Returns a free slot in the block of an agent type, all components are reset
+    Handle allocate(const std::string &agent_type);
+    /// Frees the slot of a destroyed agent
+    void release(const Handle &handle);
+
+    /// Index of an agent type, blocks of unknown types are empty
+    unsigned int getTypeIndex(const std::string &agent_type);
+
+    Coordinate3D &position(const Handle &h) { return h.chunk->positions[h.slot % chunk_size]; };
+    double &radius(const Handle &h) { return h.chunk->radii[h.slot % chunk_size]; };
+    [[nodiscard]] int stateId(const Handle &h) const { return h.chunk->state_ids[h.slot % chunk_size]; };
+    /// Sets the state of an agent and moves a counted agent between the counters of the states
+    void setStateId(const Handle &h, int state_id);
+    Coordinate3D &direction(const Handle &h) { return h.chunk->directions[h.slot % chunk_size]; };
+    double &persistenceTimeLeft(const Handle &h) { return h.chunk->persistence_times_left[h.slot % chunk_size]; };
+    double &initialTime(const Handle &h) { return h.chunk->initial_times[h.slot % chunk_size]; };
+    double &lastTreatmentTime(const Handle &h) { return h.chunk->last_treatment_times[h.slot % chunk_size]; };
+
+    /// Position as shared pointer that keeps the chunk alive (spheres share the position of their agent)
+    std::shared_ptr<Coordinate3D> sharePosition(const Handle &h);
+
+    /*!
+     * Adds an agent to the counters or removes it, agents are counted while they are in the agent list of the agent
+     * manager (an agent that left the list may still be alive)
+     * @param h Handle of the agent
+     * @param counted Bool whether the agent is counted
+     */
+    void setCounted(const Handle &h, bool counted);
+    /// Number of counted agents of an agent type
+    size_t getNumberOfAgents(unsigned int type) const { return blocks_[type]->size.load(std::memory_order_relaxed); };
+    /// Number of counted agents of an agent type in a state (ids of abm::util::Names), it follows every state change
+    size_t getNumberOfAgents(unsigned int type, int state_id) const;
+
+private:
+    struct Block {
+        // Chunks and free slots (min-heap) are changed under the mutex of the store
+        std::vector<std::shared_ptr<Chunk>> chunks{};
+        std::vector<unsigned int> free_slots{};
+        unsigned int number_of_slots{};
+        // Counters of the block are updated without a lock, one counter per name id
+        std::atomic<size_t> size{};
+        std::unique_ptr<std::atomic<size_t>[]> state_counts{
+                new std::atomic<size_t>[abm::util::Names::max_number_of_names]()};
+    };
+
+    /// Index of an agent type, the caller holds the mutex
+    unsigned int findOrAddType(const std::string &agent_type);
+
+    std::mutex mutex_{};
+    std::map<std::string, unsigned int> type_indices_{};
+    std::vector<std::unique_ptr<Block>> blocks_{};
+};
+
+#endif /* CORE_SIMULATION_AGENTCOMPONENTS_H */
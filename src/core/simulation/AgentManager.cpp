@@ -8,7 +8,9 @@
 //  This code is licensed under BSD 2-Clause
 //  See the LICENSE file provided with this code for the full license.
 
+#include <algorithm>
 #include <cmath>
+#include <iterator>
 
 #include "core/simulation/AgentManager.h"
 #include "core/simulation/factories/CellFactory.h"
@@ -16,6 +18,7 @@
 #include "core/simulation/cells/interaction/PhagocyteFungusInteraction.h"
 #include "core/analyser/InSituMeasurements.h"
 #include "core/utils/macros.h"
+#include "core/utils/Names.h"
 #include "core/simulation/factories/RateFactory.h"
 #include "core/simulation/Site.h"
 #include "core/simulation/states/InteractionState.h"
@@ -26,13 +29,28 @@ AgentManager::AgentManager(abm::util::SimulationParameters& parameters, Site *si
     time_delta_ = parameters.time_stepping;
     idHandling = 0;
     idHandlingSphereRepresentation = 0;
+    event_driven_transitions_ = parameters.site_parameters->agent_manager_parameters.event_driven_transitions;
+    quiescent_agents_ = parameters.site_parameters->agent_manager_parameters.quiescent_agents;
+    // Sleeping cells count down the sampled step of their next transition, without it they would be woken in every step
+    if (quiescent_agents_ && !event_driven_transitions_) {
+        ERROR_STDERR("AgentManager: quiescent_agents requires event_driven_transitions");
+        exit(1);
+    }
+    boundary_placement_precheck_ = parameters.site_parameters->agent_manager_parameters.boundary_placement_precheck;
+    if (const auto &ode_engine = parameters.site_parameters->agent_manager_parameters.ode_engine; ode_engine.activated) {
+        ode_engine_ = std::make_unique<OdeEngine>(ode_engine.relative_tolerance, ode_engine.absolute_tolerance);
+    }
     for (auto& agent: parameters.site_parameters->agent_manager_parameters.agents){
         agent_types_.emplace_back(agent->type);
+        // Sampled radii are normally distributed, the bounding radius covers them up to 3 standard deviations (as the
+        // grid constant of the balloon list)
+        const auto &morphology = agent->morphology_parameters;
+        agent_radii_.emplace_back(morphology.type == "SphericalMorphology" ? morphology.radius + 3 * morphology.stddev : 0.0);
     }
 }
 
 void AgentManager::inputOfAgents(double current_time, Randomizer *random_generator) {
-    for (auto agent_name: agent_types_) {
+    for (const auto &agent_name: agent_types_) {
         double lambda = site->getInputRate(agent_name);
         if (lambda > 0) {
             if (current_time == 0) {
@@ -62,22 +80,44 @@ void AgentManager::insertAgentAtBoundary(Site *site, std::string agentType, doub
     Agent *agent = nullptr;
     int rejections = 0;
 
+    // Candidate points are tested with the bounding radius of the agent type first, only points without a neighbour in
+    // reach get an agent (a sampled radius beyond the bound may still collide, then it is removed as before). Types
+    // without a spherical morphology have no spheres and bypass the check.
+    double radius = 0;
+    if (boundary_placement_precheck_) {
+        const auto type = std::find(agent_types_.begin(), agent_types_.end(), agentType);
+        if (type != agent_types_.end()) radius = agent_radii_[type - agent_types_.begin()];
+    }
+
     // Add an agent to the system without having any collisions
     do {
         if (agent != nullptr) {
             removeAgent(site, agent, current_time);
+            agent = nullptr;
         }
         initialPosition = site->getRandomBoundaryPoint();
         initialVector = site->getBoundaryInputVector();
-        agent = createAgent(site, agentType, initialPosition, &initialVector, current_time);
         rejections++;
-    } while ((agent->getInteractions()->hasCollisions() && rejections < 10000));
+        if (radius > 0 && site->getNeighbourhoodLocator()->hasCollision(initialPosition, radius)) continue;
+        agent = createAgent(site, agentType, initialPosition, &initialVector, current_time);
+    } while ((agent == nullptr || agent->getInteractions()->hasCollisions()) && rejections < 10000);
     if (rejections > 9999) {
         DEBUG_STDOUT("Could not find a position for the agent at the boundary. Agent is not added to the system.");
         if (agent != nullptr) removeAgent(site, agent, current_time);
     }
 }
 
+std::shared_ptr<Agent> &AgentManager::emplace_back(std::shared_ptr<Agent> &&value) {
+    setCounted(value.get(), true);
+    return allAgents.emplace_back(std::forward<std::shared_ptr<Agent>>(value));
+}
+
+void AgentManager::setCounted(Agent *agent, bool counted) {
+    if (agent != nullptr && agent->getComponents() != nullptr) {
+        agent->getComponents()->setCounted(agent->getComponentsHandle(), counted);
+    }
+}
+
 Agent *AgentManager::createAgent(Site *site, std::string agenttype, Coordinate3D c, Coordinate3D *prevMove, double current_time) {
     auto agent = emplace_back(site->getCellFactory()->createCell(agenttype, std::make_unique<Coordinate3D>(c), generateNewID(),
                                                       site, time_delta_, current_time));
@@ -93,6 +133,8 @@ void AgentManager::replaceAgent(Site *site,Agent *agent, std::unique_ptr<Coordin
     auto newAgent = site->getCellFactory()->createCell(agentType, std::move(newCoord), idHandling, site, time_delta_, current_time);
     if (newAgent != 0) {
         newAgent->getMovement()->setPreviousMove(prevMove);
+        setCounted(agent, false);
+        setCounted(newAgent.get(), true);
         std::replace_if(allAgents.begin(), allAgents.end(), [agent](const auto &a) { return agent == a.get(); },
                         newAgent);
         idHandling++;
@@ -106,20 +148,23 @@ AgentManager::replaceAgent(Site *site, Agent *agentToReplace, std::shared_ptr<Ag
 
     // If the new agent is the nullptr, delete the agent
     if (!newAgent) {
-        auto all_interactions = agentToReplace->getInteractions()->getAllInteractions();
+        const auto &all_interactions = agentToReplace->getInteractions()->getAllInteractions();
         for (size_t i = 0; i < all_interactions.size(); i++) {
             if (all_interactions.at(i)->getInteractionName() == "PhagocyteFungusInteraction") {
+                static const int fungal_phagocytosed = abm::util::Names::intern("FungalPhagocytosed");
                 Cell *cell1 = all_interactions.at(i)->getFirstCell();
                 Cell *cell2 = all_interactions.at(i)->getSecondCell();
-                if (cell1->getCurrentCellState()->getStateName() == "FungalPhagocytosed") {
+                if (cell1->getCurrentCellState()->getStateId() == fungal_phagocytosed) {
                     cell1->setDeleted();
-                } else if (cell2->getCurrentCellState()->getStateName() == "FungalPhagocytosed"){
+                } else if (cell2->getCurrentCellState()->getStateId() == fungal_phagocytosed){
                     cell2->setDeleted();
                 }
             }
         }
         agentToReplace->setDeleted();
     } else {
+        setCounted(agentToReplace, false);
+        setCounted(newAgent.get(), true);
         std::replace_if(allAgents.begin(),
                         allAgents.end(),
                         [agent = agentToReplace](const auto &a) { return agent == a.get(); },
@@ -135,24 +180,23 @@ void AgentManager::removeAgent(Site *site, Agent *agent, double current_time) {
         site->getNeighbourhoodLocator()->removeSphereRepresentation(sphRep);
     }
     agent->setDeleted();
-    if (abm::util::isSubstring("FungalCell", agent->getTypeName())) {
+    static const int fungal_cell = abm::util::Names::intern("FungalCell");
+    if (abm::util::Names::related(fungal_cell, agent->getTypeId())) {
         removeFungalCellFromList(agent->getId(), current_time);
     }
-    allAgents.erase(std::remove_if(allAgents.begin(),
-                                   allAgents.end(),
-                                   [agent](const auto &a) { return agent == a.get(); }), allAgents.end());
+    // Rejected agents at the boundary were the last ones added, i.e. the search from the back ends immediately
+    const auto it = std::find_if(allAgents.rbegin(), allAgents.rend(), [agent](const auto &a) { return agent == a.get(); });
+    if (it != allAgents.rend()) {
+        setCounted(agent, false);
+        allAgents.erase(std::next(it).base());
+    }
 }
 
 int AgentManager::getAgentQuantity(std::string agenttype) {
-    int count = 0;
-    for (auto agent: allAgents) {
-        if (agent->getCurrentCellState()->getStateName() != "Death" && agent != 0) {
-            if (agent->getTypeName() == agenttype) {
-                count++;
-            }
-        }
-    }
-    return count;
+    // Counters of the component store follow the agent list and every state change
+    const auto type = components_->getTypeIndex(agenttype);
+    static const int death = abm::util::Names::intern("Death");
+    return static_cast<int>(components_->getNumberOfAgents(type) - components_->getNumberOfAgents(type, death));
 }
 
 const std::vector<std::shared_ptr<Agent>> &AgentManager::getAllAgents() {
@@ -161,26 +205,33 @@ const std::vector<std::shared_ptr<Agent>> &AgentManager::getAllAgents() {
 }
 
 void AgentManager::cleanUpAgents(double current_time) {
-
-    for (auto it = allAgents.begin(); it != allAgents.end();) {
-        if (*it == 0) {
-            it = allAgents.erase(it);
-        } else {
-            if ((*it)->isDeleted()) {
-                for (const auto &sphere: (*it)->getMorphology()->getAllSpheresOfThis()) {
-                    site->getNeighbourhoodLocator()->removeSphereRepresentation(sphere);
-                    removeSphereRepresentation(sphere);
-                }
-                if (abm::util::isSubstring("FungalCell", (*it)->getTypeName())) { this->removeFungalCellFromList((*it)->getId(), current_time); }
-                it = allAgents.erase(it);
-            } else {
-                it++;
+    static const int fungal_cell = abm::util::Names::intern("FungalCell");
+
+    // Remaining agents are compacted in one pass and keep their order, deleted agents are destroyed in the order of
+    // the list as before
+    auto kept = allAgents.begin();
+    for (auto it = allAgents.begin(); it != allAgents.end(); ++it) {
+        if (*it == 0) continue;
+        if ((*it)->isDeleted()) {
+            for (const auto &sphere: (*it)->getMorphology()->getAllSpheresOfThis()) {
+                site->getNeighbourhoodLocator()->removeSphereRepresentation(sphere);
+                removeSphereRepresentation(sphere);
             }
+            if (abm::util::Names::related(fungal_cell, (*it)->getTypeId())) { this->removeFungalCellFromList((*it)->getId(), current_time); }
+            setCounted(it->get(), false);
+            it->reset();
+        } else {
+            if (kept != it) *kept = std::move(*it);
+            ++kept;
         }
     }
+    allAgents.erase(kept, allAgents.end());
+    // Interactions closed in this timestep are not held by any agent anymore
+    interaction_table_->releaseClosed();
 }
 
 int AgentManager::getNextSphereRepresentationId(SphereRepresentation *sphereRep) {
+    const auto lock = site->lockSharedStructures();
     sphereIdToCell[idHandlingSphereRepresentation] =
             sphereRep->getMorphologyElementThisBelongsTo()->getMorphologyThisBelongsTo()->getCellThisBelongsTo();
     sphereIdToSphereRep[idHandlingSphereRepresentation] = sphereRep;
@@ -189,6 +240,7 @@ int AgentManager::getNextSphereRepresentationId(SphereRepresentation *sphereRep)
 }
 
 Cell *AgentManager::getCellBySphereRepId(int sphereRepId) {
+    const auto lock = site->lockSharedStructures();
     if (sphereIdToCell.find(sphereRepId) != sphereIdToCell.end()) {
         return sphereIdToCell[sphereRepId];
     }
@@ -196,6 +248,7 @@ Cell *AgentManager::getCellBySphereRepId(int sphereRepId) {
 }
 
 SphereRepresentation *AgentManager::getSphereRepBySphereRepId(int sphereRepId) {
+    const auto lock = site->lockSharedStructures();
     if (sphereIdToSphereRep.find(sphereRepId) != sphereIdToSphereRep.end()) {
         return sphereIdToSphereRep[sphereRepId];
     }
@@ -203,6 +256,7 @@ SphereRepresentation *AgentManager::getSphereRepBySphereRepId(int sphereRepId) {
 }
 
 void AgentManager::removeSphereRepresentation(SphereRepresentation *sphereRep) {
+    const auto lock = site->lockSharedStructures();
     allSphereRepresentations.erase(sphereRep);
     sphereIdToSphereRep.erase(sphereRep->getId());
     sphereIdToCell.erase(sphereRep->getId());
@@ -251,6 +305,7 @@ double AgentManager::getOccupancyDensityOfSpace() {
 }
 
 void AgentManager::removeFungalCellFromList(int id, double current_time) {
+    const auto lock = site->lockSharedStructures();
     for (size_t i = 0; i < activeFungalCells.size(); i++) {
         if (activeFungalCells.at(i)->getId() == id) {
             activeFungalCells.erase(activeFungalCells.begin() + i);
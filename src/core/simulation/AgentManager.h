@@ -17,6 +17,9 @@
 #include <utility>
 #include <vector>
 
+#include "core/simulation/AgentComponents.h"
+#include "core/simulation/InteractionTable.h"
+#include "core/simulation/OdeEngine.h"
 #include "core/simulation/morphology/SphereRepresentation.h"
 #include "core/utils/io_util.h"
 
@@ -36,7 +39,7 @@ public:
     iterator end() { return allAgents.end(); }
     [[nodiscard]] const_iterator begin() const { return allAgents.begin(); }
     [[nodiscard]] const_iterator end() const { return allAgents.end(); }
-    std::shared_ptr<Agent> &emplace_back(std::shared_ptr<Agent> &&value) {return allAgents.emplace_back(std::forward<std::shared_ptr<Agent>>(value));}
+    std::shared_ptr<Agent> &emplace_back(std::shared_ptr<Agent> &&value);
 
     /*!
      * Exponentially distributed inputs of agents for a rate lamba which can be defined for each agent type
@@ -99,8 +102,27 @@ public:
     std::set<SphereRepresentation *> *getAllSphereRepresentations() { return &allSphereRepresentations; };
     std::vector<Agent *> getAllFungalCells() { return activeFungalCells; };
     std::vector<std::string> getAllAgentTypes();
+    /// Component store that contains the hot data of all agents of the site
+    const std::shared_ptr<AgentComponents> &getComponents() const { return components_; };
+    /// Interactions between all pairs of agents of the site
+    const std::shared_ptr<InteractionTable> &getInteractionTable() const { return interaction_table_; };
+    /// Cell states sample the number of steps until their next transition instead of drawing in every step
+    [[nodiscard]] bool usesEventDrivenTransitions() const { return event_driven_transitions_; };
+    /// Cells without pending dynamics skip their timesteps until they are woken
+    [[nodiscard]] bool usesQuiescentAgents() const { return quiescent_agents_; };
+    /// Boundary points are checked against the neighbourhood before an agent is constructed there (only agent types with
+    /// a spherical morphology, others have no spheres to check)
+    [[nodiscard]] bool usesBoundaryPlacementPrecheck() const { return boundary_placement_precheck_; };
+    /// Engine for the intracellular models of the agents (nullptr if agents integrate their dynamics themselves)
+    OdeEngine *getOdeEngine() const { return ode_engine_.get(); };
 
 protected:
+    /// Agents are counted in the component store while they are in the agent list
+    static void setCounted(Agent *agent, bool counted);
+
+    std::shared_ptr<AgentComponents> components_{std::make_shared<AgentComponents>()};
+    std::shared_ptr<InteractionTable> interaction_table_{std::make_shared<InteractionTable>()};
+    std::unique_ptr<OdeEngine> ode_engine_{};
     std::vector<std::shared_ptr<Agent>> allAgents;
     std::map<int, Cell *> sphereIdToCell;
     std::map<int, SphereRepresentation *> sphereIdToSphereRep;
@@ -119,6 +141,12 @@ protected:
     Site *site{};
     double time_delta_{};
     std::vector<std::string> agent_types_{};
+    bool event_driven_transitions_{};
+    bool quiescent_agents_{};
+    bool boundary_placement_precheck_{};
+    // Bounding radius of the spherical morphology of each agent type (0 for other morphologies, they bypass the
+    // boundary placement precheck)
+    std::vector<double> agent_radii_{};
 };
 
 #endif /* CORE_SIMULATION_AGENTMANAGER_H */
@@ -8,6 +8,8 @@
 //  This code is licensed under BSD 2-Clause
 //  See the LICENSE file provided with this code for the full license.
 
+#include <array>
+
 #include "core/simulation/Cell.h"
 
 #include "core/simulation/Agent.h"
@@ -20,13 +22,15 @@
 #include "core/simulation/movement/PersistentRandomWalk.h"
 #include "core/analyser/InSituMeasurements.h"
 #include "core/utils/macros.h"
+#include "core/utils/Names.h"
+#include "core/utils/RunArena.h"
 
 
 Cell::Cell(std::unique_ptr<Coordinate3D> c, int id, Site *site, double time_delta, double current_time)
         : Agent(std::move(c), id, site) {
 
     cellState = 0;
-    interactions = std::make_shared<Interactions>(this, site->getNeighbourhoodLocator());
+    interactions = abm::util::makeShared<Interactions>(this, site->getNeighbourhoodLocator());
     setInteractions(interactions);
 }
 
@@ -42,36 +46,37 @@ void Cell::doAllActionsForTimestep(double timestep, double current_time) {
         INTERACTIONS
     };
 
+    // Quiescent cells skip their timesteps until they are woken or their state is due for a transition
+    if (quiescent_) {
+        if (cellState->skipQuietTransition(timestep)) return;
+        quiescent_ = false;
+    }
+
     // All actions for one cell in one timestep
     if (agentTreatedInCurrentTimestep(current_time)) {
         if (!is_deleted_) move(timestep, current_time);
     } else {
-        std::vector<unsigned int>::iterator it;
-        std::vector<unsigned int> currPerm = abm::util::generateRandomPermutation(site->getRandomGenerator(), 4);
-        unsigned currentTask;
+        std::array<unsigned int, 4> currPerm{};
+        abm::util::generateRandomPermutation(site->getRandomGenerator(), currPerm.data(), currPerm.size());
 
         // Randomly ordered execution of Movement, Interaction_and_States, etc. per cell per timestep
-        for (it = currPerm.begin(); it < currPerm.end(); it++) {
-            currentTask = *it;
+        for (const auto currentTask: currPerm) {
             if (is_deleted_) break;
             switch (static_cast<Task>(currentTask)) {
                 case Task::MOVEMENT:
-                    if (!is_deleted_) {
-                        // do movement in current timestep of current cell
-                        move(timestep, current_time);
-                        if (is_deleted_) it = currPerm.end();
-                    }
+                    // do movement in current timestep of current cell
+                    move(timestep, current_time);
                     break;
                 case Task::INTERACTIONS_AND_STATES: {
-                    std::vector<unsigned int>::iterator statesIt;
-                    std::vector<unsigned int> states = abm::util::generateRandomPermutation(site->getRandomGenerator(),2);
-                    for (statesIt = states.begin(); statesIt < states.end(); statesIt++) {
-                        switch (static_cast<Change>(*statesIt)) {
+                    std::array<unsigned int, 2> states{};
+                    abm::util::generateRandomPermutation(site->getRandomGenerator(), states.data(), states.size());
+                    for (const auto change: states) {
+                        switch (static_cast<Change>(change)) {
                             case Change::STATES:
                                 if (!agentTreatedInCurrentTimestep(current_time) && !is_deleted_) {
                                     // do state transiation in current timestep of current cell
                                     cellState->stateTransition(timestep, current_time);
-                                    getSite()->stopRunForCertainState(*this, this->getCurrentCellState()->getStateName(), current_time);
+                                    getSite()->stopRunForCertainState(*this, this->getCurrentCellState()->getStateId(), current_time);
                                 }
                                 break;
                             case Change::INTERACTIONS:
@@ -95,6 +100,9 @@ void Cell::doAllActionsForTimestep(double timestep, double current_time) {
             }
         }
     }
+    quiescent_ = !is_deleted_ && site->getAgentManager()->usesQuiescentAgents() &&
+                 interactions->getAllInteractions().empty() && movement->isStatic() &&
+                 !hasPendingDynamics(timestep, current_time);
 }
 
 void Cell::move(double timestep, double current_time) {
@@ -130,6 +138,9 @@ void Cell::handleControlledAgents(double timestep) {
 
 void Cell::setState(std::shared_ptr<CellState> cstate) {
     cellState = cstate;
+    quiescent_ = false;
+    if (cellState != nullptr) cellState->restartSchedule();
+    if (components_ != nullptr && cellState != nullptr) components_->setStateId(components_handle_, cellState->getStateId());
 }
 
 Coordinate3D Cell::getEffectiveConnection(Cell *cell) {
@@ -148,19 +159,25 @@ void Cell::setInitialState(double time_delta, double current_time) {
 }
 
 void Cell::setExistingState(std::string stateName, double time_delta, double current_time) {
-    if (cellStates.find(stateName) == cellStates.end()) {
-        cellState = getSite()->getCellStateFactory()->createCellState(this, stateName);
+    const auto state_id = abm::util::Names::intern(stateName);
+    if (auto existing_state = getCellStateById(state_id); existing_state == nullptr) {
+        setState(getSite()->getCellStateFactory()->createCellState(this, state_id));
     } else {
-        cellState = cellStates[stateName];
+        setState(existing_state);
     }
     cellState->stateTransition(time_delta, current_time);
 }
 
 std::shared_ptr<CellState> Cell::getCellStateByName(std::string nameOfState) {
-    if (cellStates.find(nameOfState) == cellStates.end()) {
+    return getCellStateById(abm::util::Names::find(nameOfState));
+}
+
+std::shared_ptr<CellState> Cell::getCellStateById(int state_id) {
+    const auto slot = state_table_ != nullptr ? state_table_->getSlot(state_id) : -1;
+    if (slot < 0) {
         return nullptr;
     } else {
-        return cellStates[nameOfState];
+        return cellStates[slot];
     }
 }
 
@@ -168,7 +185,7 @@ CellState *Cell::getCurrentCellState() {
     return cellState.get();
 }
 
-double Cell::getFeatureValueByName(std::string featureName) {
+double Cell::getFeatureValueByName(const std::string &featureName) {
     double value = 0;
     if (featureName.compare("migration-bias-probability") == 0) { // =p
         double LRdiff_front_rear = cumulative_persistence_gradient.getMagnitude();
@@ -204,7 +221,7 @@ void Cell::changeState(std::string stateName) {
 void Cell::applyMethodByName(std::string mehtodName) {
 }
 
-void Cell::setVariableOnEvent(std::string variable, double value) {
+void Cell::setVariableOnEvent(const std::string &variable, double value) {
     if (variable.compare("reset-cumulative-gradient") == 0) {
         cumulative_persistence_gradient *= 0.0;
     }
@@ -214,6 +231,7 @@ void Cell::setFeatureValueByName(std::string featureName, int value) {
 }
 
 void Cell::setup(double time_delta, double current_time, abm::util::SimulationParameters::AgentParameters *parameters) {
+    attachComponents(site->getAgentManager()->getComponents());
 
     if (parameters->movement_parameters.type.empty()) {
         movement = std::make_unique<Movement>(site->getNumberOfSpatialDimensions());
@@ -259,7 +277,7 @@ void Cell::setup(double time_delta, double current_time, abm::util::SimulationPa
     passiveMovement->setCurrentPosition(position.get());
     setInputRate(parameters->input_lambda);
     setPassiveMovement(passiveMovement);
-    timestepLastTreatment = -1;
+    *timestepLastTreatment = -1;
     std::string color = parameters->morphology_parameters.color;
     surface = std::make_shared<Morphology>(color, this);
     if (parameters->morphology_parameters.type == "SphericalMorphology") {
@@ -270,16 +288,20 @@ void Cell::setup(double time_delta, double current_time, abm::util::SimulationPa
                                                                                 position,
                                                                                 radius,
                                                                                 "basic"));
+        surface->getAllSpheresOfThis().front()->bindRadius(&components_->radius(components_handle_));
     }
     setMorphology(surface);
 
-    for (const auto&[state, next_states]:getSite()->getCellStateFactory()->getStateSetup(site->getIdentifier(), parameters->type)) {
-        cellStates[state] = std::make_shared<CellState>(state, this, next_states);
+    state_table_ = &getSite()->getCellStateFactory()->getStateTable(site->getIdentifier(), parameters->type);
+    cellStates.clear();
+    for (const auto&[state, next_states]: state_table_->states) {
+        cellStates.emplace_back(std::make_shared<CellState>(state, this, next_states));
     }
-    if (cellStates.find("InitialCellState") == cellStates.end()) {
-        cellState = getSite()->getCellStateFactory()->createCellState(this, "InitialCellState");
+    static const int initial_cell_state = abm::util::Names::intern("InitialCellState");
+    if (auto initial_state = getCellStateById(initial_cell_state); initial_state == nullptr) {
+        setState(getSite()->getCellStateFactory()->createCellState(this, initial_cell_state));
     } else {
-        cellState = cellStates["InitialCellState"];
+        setState(initial_state);
     }
     cellState->stateTransition(time_delta, current_time);
 }
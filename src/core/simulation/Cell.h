@@ -35,7 +35,7 @@ public:
     void setPassive() override { passive = true; }
     void move(double timestep, double current_time) override;
     void setFeatureValueByName(std::string featureName, int value) override;
-    void setVariableOnEvent(std::string variable, double value);
+    void setVariableOnEvent(const std::string &variable, double value);
     void applyMethodByName(std::string mehtodName) override;
     void changeState(std::string stateName) override;
     void recieveInteractionEvent(InteractionEvent *ievent, double current_time);
@@ -43,15 +43,19 @@ public:
     void setExistingState(std::string stateName, double time_delta, double current_time);
     void addIngestions(int id);
 
-    double getFeatureValueByName(std::string featureName);
+    double getFeatureValueByName(const std::string &featureName);
     Coordinate3D get_gradient() final { return cumulative_persistence_gradient; }
     Coordinate3D getEffectiveConnection(Cell *cell);
     std::string getTypeName() override;
     std::string generatePovObject() final;
     CellState *getCurrentCellState() final;
     std::shared_ptr<CellState> getCellStateByName(std::string nameOfState) final;
+    std::shared_ptr<CellState> getCellStateById(int state_id) final;
     Morphology *getSurface();
     Interactions *getInteractions();
+    /// Wakes a quiescent cell, i.e. it does all actions again from the next call on
+    void wake() { quiescent_ = false; };
+    [[nodiscard]] bool isQuiescent() const { return quiescent_; };
 
     virtual void handleControlledAgents(double timestep);
     virtual void passiveMove(double timestep, double current_time);
@@ -65,12 +69,22 @@ public:
 
 protected:
     virtual void handleInteractionEvent(InteractionEvent *ievent, double current_time);
+    /*!
+     * Quiescence predicate of the agent type, evaluated after each timestep if the agent manager uses quiescent agents.
+     * Cells without interactions, movement and pending dynamics sleep until their state is due for a transition,
+     * another agent starts an interaction with them or they are woken otherwise.
+     * @return Bool that is true if the cell changes apart from its state machine (default)
+     */
+    virtual bool hasPendingDynamics(double timestep, double current_time) { return true; };
     std::vector<int> ingestionCounter{};
     std::shared_ptr<Morphology> surface{};
     std::shared_ptr<Interactions> interactions{};
-    std::map<std::string, std::shared_ptr<CellState>> cellStates{};
+    // States of the cell in the order of the compiled state table of its agent type
+    const CellStateFactory::StateTable *state_table_{};
+    std::vector<std::shared_ptr<CellState>> cellStates{};
     std::shared_ptr<CellState> cellState{};
     Coordinate3D cumulative_persistence_gradient{};
+    bool quiescent_{};
 
 };
 
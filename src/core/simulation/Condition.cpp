@@ -10,6 +10,10 @@
 
 #include "core/simulation/Condition.h"
 #include "core/simulation/Cell.h"
+#include "core/utils/Names.h"
+
+Condition::Condition(const std::string &condition)
+        : condition_(condition), condition_id_(abm::util::Names::intern(condition)) {}
 
 Cell *Condition::getCell() {
     return cell_;
@@ -23,16 +27,16 @@ bool Condition::isFulfilled(Condition *condition) {
     bool fulfilled = false;
     if (cell_ != nullptr) {
         if (condition->getCell() == nullptr) {
-            fulfilled = (condition->getStringCondition() == cell_->getTypeName());
+            fulfilled = (condition->getConditionId() == cell_->getTypeId());
         } else {
             fulfilled = (cell_ == condition->getCell());
         }
 
     } else {
         if (condition->getCell() == nullptr) {
-            fulfilled = (condition->getStringCondition() == condition_);
+            fulfilled = (condition->getConditionId() == condition_id_);
         } else {
-            fulfilled = (condition->getCell()->getTypeName() == condition_);
+            fulfilled = (condition->getCell()->getTypeId() == condition_id_);
         }
     }
     return fulfilled;
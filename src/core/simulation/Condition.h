@@ -20,15 +20,18 @@ public:
   // Class for conditioning interactions or states to environmental or cell-specific factors.
     Condition() = default;
     explicit Condition(Cell* cell) :cell_(cell) {};
-    explicit Condition(const std::string& condition) :condition_(condition) {};
+    explicit Condition(const std::string& condition);
 
     bool isFulfilled(Condition* condition);
     Cell* getCell();
     std::string getStringCondition();
+    /// Id of the string condition in abm::util::Names, string conditions are compared by their ids
+    [[nodiscard]] int getConditionId() const { return condition_id_; };
 
 private:
     Cell* cell_{};
     std::string condition_{};
+    int condition_id_{-1};
     
 };
 
@@ -16,30 +16,35 @@
 #include "core/simulation/Cell.h"
 #include "core/simulation/factories/InteractionStateFactory.h"
 #include "core/simulation/factories/InteractionFactory.h"
+#include "core/utils/Names.h"
 
 
-Interaction::Interaction(std::string identifier, Cell *cell1, Cell *cell2, double time_delta, double current_time)
+Interaction::Interaction(const std::string &identifier, Cell *cell1, Cell *cell2, double time_delta, double current_time)
         : interactionId(cell1->getSite()->getInteractionFactory()->generateInteractionId()) {
     cellOne = cell1;
     cellTwo = cell2;
-    identifier_ = identifier;
+    identifier_id_ = abm::util::Names::intern(identifier);
     isActiven = true;
     currentCondition = 0;
     setDelete = false;
 }
 
+Interaction::~Interaction() = default;
+
 void Interaction::setInitialState(double time_delta, double current_time, Cell *initiatingCell) {
 
-    interactionState = cellOne->getSite()->getInteractionStateFactory()->createInteractionState(this, "InitialInteractionState", cellOne,cellTwo);
+    static const int initial_interaction_state = abm::util::Names::intern("InitialInteractionState");
+    interactionState = cellOne->getSite()->getInteractionStateFactory()->createInteractionState(this, initial_interaction_state, cellOne,cellTwo);
     if (cellularConditions.find(initiatingCell) != cellularConditions.end()) {
         currentCondition = cellularConditions[initiatingCell].get();
     }
     interactionState->stateTransition(time_delta, current_time);
 }
 
-void Interaction::setState(std::string nameOfState) {
-    this->oldinteractionState = this->interactionState;
-    this->interactionState = cellOne->getSite()->getInteractionStateFactory()->createInteractionState(this, nameOfState, cellOne, cellTwo);
+void Interaction::setState(int state_id) {
+    // The previous state is kept until the next change, its transition may still be running
+    this->oldinteractionState = std::move(this->interactionState);
+    this->interactionState = cellOne->getSite()->getInteractionStateFactory()->createInteractionState(this, state_id, cellOne, cellTwo);
 }
 
 void Interaction::handle(Cell *cell, double timestep, double current_time) {
@@ -87,9 +92,12 @@ Condition *Interaction::getCurrentCondition() {
 
 std::shared_ptr<Collision> Interaction::getNextCollision() {
     std::shared_ptr<Collision> coll = nullptr;
-    if (!currentCollisions.empty()) {
-        coll = currentCollisions.front();
-        currentCollisions.pop();
+    if (nextCollision < currentCollisions.size()) {
+        coll = std::move(currentCollisions[nextCollision++]);
+    }
+    if (nextCollision == currentCollisions.size()) {
+        currentCollisions.clear();
+        nextCollision = 0;
     }
     return coll;
 }
\ No newline at end of file
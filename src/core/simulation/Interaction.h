@@ -13,12 +13,16 @@
 
 #include <memory>
 #include <map>
-#include <queue>
+#include <memory_resource>
+#include <vector>
 
 #include "core/simulation/Condition.h"
+#include "core/simulation/InteractionTable.h"
 #include "core/simulation/cells/interaction/InteractionEvent.h"
 #include "core/simulation/neighbourhood/Collision.h"
 #include "core/analyser/Analyser.h"
+#include "core/utils/Names.h"
+#include "core/utils/RunArena.h"
 
 class Cell;
 class InteractionState;
@@ -26,8 +30,8 @@ class InteractionState;
 class Interaction {
 public:
   // Class for providing the key functionality of an interaction.
-  Interaction(std::string identifier, Cell *cell1, Cell *cell2, double time_delta, double current_time);
-  virtual ~Interaction() = default;
+  Interaction(const std::string &identifier, Cell *cell1, Cell *cell2, double time_delta, double current_time);
+  virtual ~Interaction();
 
   virtual void handle(Cell *cell, double timestep, double current_time);
   [[nodiscard]] virtual std::string getInteractionName() const;
@@ -39,14 +43,16 @@ public:
   Cell *getOtherCell(Cell *cell);
   void setDelted() { setDelete = true; };
   void setInitialState(double time_delta, double current_time, Cell *cell = nullptr);
-  void setState(std::string nameOfState);
+  void setState(int state_id);
   void fireInteractionEvent(InteractionEvent *ievent, double current_time);
   void addCurrentCollision(std::shared_ptr<Collision> collision) {
-    this->currentCollisions.push(std::move(collision));
+    this->currentCollisions.push_back(std::move(collision));
   };
   bool isActive();
   bool isDelted() const { return setDelete; };
-  std::string getIdentifier(){return identifier_;}
+  [[nodiscard]] const std::string &getIdentifier() const {return abm::util::Names::get(identifier_id_);}
+  /// Id of the identifier in abm::util::Names
+  [[nodiscard]] int getIdentifierId() const {return identifier_id_;}
   void close();
 
 protected:
@@ -55,15 +61,20 @@ protected:
   Cell *cellTwo;
   std::map<Cell *, std::shared_ptr<Condition>> cellularConditions;
   std::map<std::string, std::shared_ptr<Condition>> cellularStringConditions;
-  std::queue<std::shared_ptr<Collision>> currentCollisions;
-  std::shared_ptr<InteractionState> interactionState;
-  std::shared_ptr<InteractionState> oldinteractionState;
+  // Queue of the collisions that are not handled yet (from nextCollision on), it is cleared when it is empty
+  std::pmr::vector<std::shared_ptr<Collision>> currentCollisions{abm::util::RunArena::currentResource()};
+  size_t nextCollision{};
+  std::unique_ptr<InteractionState> interactionState;
+  std::unique_ptr<InteractionState> oldinteractionState;
   Condition *currentCondition;
 
 private:
   bool isActiven;
   bool setDelete;
-  std::string identifier_;
+  int identifier_id_;
+  // Position of the interaction in the interaction table of the site (npos if it is not in the table)
+  friend class InteractionTable;
+  size_t table_index_{InteractionTable::npos};
 };
 
 #endif /* CORE_SIMULATION_INTERACTION_H */
@@ -0,0 +1,124 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#include <algorithm>
+
+#include "core/simulation/InteractionTable.h"
+#include "core/simulation/Cell.h"
+#include "core/simulation/Interaction.h"
+
+namespace {
+    constexpr size_t min_slots = 16;
+
+    // Fibonacci hashing of a key onto a power of two number of slots
+    size_t home(InteractionTable::Key key, size_t number_of_slots) {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & (number_of_slots - 1);
+    }
+}
+
+InteractionTable::Key InteractionTable::key(const Cell *cell1, const Cell *cell2) {
+    const auto id1 = static_cast<std::uint32_t>(cell1->getId());
+    const auto id2 = static_cast<std::uint32_t>(cell2->getId());
+    return (Key{std::min(id1, id2)} << 32) | std::max(id1, id2);
+}
+
+Interaction *InteractionTable::find(const Cell *cell1, const Cell *cell2) const {
+    const auto slot = findSlot(key(cell1, cell2));
+    return slot == npos ? nullptr : entries_[slots_[slot]].interaction.get();
+}
+
+void InteractionTable::insert(const std::shared_ptr<Interaction> &interaction) {
+    const auto key = InteractionTable::key(interaction->getFirstCell(), interaction->getSecondCell());
+    if (interaction->table_index_ == npos) {
+        interaction->table_index_ = entries_.size();
+        entries_.push_back({key, interaction});
+    }
+    if (const auto slot = findSlot(key); slot != npos) {
+        slots_[slot] = static_cast<std::int32_t>(interaction->table_index_);
+    } else {
+        insertIntoIndex(key, static_cast<std::int32_t>(interaction->table_index_));
+    }
+}
+
+void InteractionTable::erase(const Cell *cell1, const Cell *cell2) {
+    if (const auto slot = findSlot(key(cell1, cell2)); slot != npos) eraseSlot(slot);
+}
+
+void InteractionTable::close(Interaction *interaction) {
+    const auto index = interaction->table_index_;
+    if (index == npos) return;
+    const auto key = entries_[index].key;
+    if (const auto slot = findSlot(key); slot != npos && slots_[slot] == static_cast<std::int32_t>(index)) {
+        eraseSlot(slot);
+    }
+    closed_.push_back(std::move(entries_[index].interaction));
+    interaction->table_index_ = npos;
+
+    // The last entry is moved into the gap and its slot follows it
+    const auto last = entries_.size() - 1;
+    if (index != last) {
+        entries_[index] = std::move(entries_[last]);
+        entries_[index].interaction->table_index_ = index;
+        if (const auto slot = findSlot(entries_[index].key);
+                slot != npos && slots_[slot] == static_cast<std::int32_t>(last)) {
+            slots_[slot] = static_cast<std::int32_t>(index);
+        }
+    }
+    entries_.pop_back();
+}
+
+void InteractionTable::releaseClosed() {
+    closed_.clear();
+}
+
+size_t InteractionTable::findSlot(Key key) const {
+    if (used_slots_ == 0) return npos;
+    const auto mask = slots_.size() - 1;
+    for (auto slot = home(key, slots_.size());; slot = (slot + 1) & mask) {
+        if (slots_[slot] == empty_slot) return npos;
+        if (entries_[slots_[slot]].key == key) return slot;
+    }
+}
+
+void InteractionTable::insertIntoIndex(Key key, std::int32_t entry) {
+    if (2 * (used_slots_ + 1) > slots_.size()) rehash(std::max(min_slots, 2 * slots_.size()));
+    const auto mask = slots_.size() - 1;
+    auto slot = home(key, slots_.size());
+    while (slots_[slot] != empty_slot) slot = (slot + 1) & mask;
+    slots_[slot] = entry;
+    ++used_slots_;
+}
+
+void InteractionTable::eraseSlot(size_t slot) {
+    // Backward shift deletion: entries of the probe sequence behind the gap are moved into it if their home allows it
+    const auto mask = slots_.size() - 1;
+    auto gap = slot;
+    for (auto next = (gap + 1) & mask; slots_[next] != empty_slot; next = (next + 1) & mask) {
+        const auto next_home = home(entries_[slots_[next]].key, slots_.size());
+        if (((next - next_home) & mask) >= ((next - gap) & mask)) {
+            slots_[gap] = slots_[next];
+            gap = next;
+        }
+    }
+    slots_[gap] = empty_slot;
+    --used_slots_;
+}
+
+void InteractionTable::rehash(size_t number_of_slots) {
+    std::vector<std::int32_t> previous_slots(number_of_slots, empty_slot);
+    previous_slots.swap(slots_);
+    const auto mask = number_of_slots - 1;
+    for (const auto entry: previous_slots) {
+        if (entry == empty_slot) continue;
+        auto slot = home(entries_[entry].key, number_of_slots);
+        while (slots_[slot] != empty_slot) slot = (slot + 1) & mask;
+        slots_[slot] = entry;
+    }
+}
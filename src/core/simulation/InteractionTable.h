@@ -0,0 +1,75 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#ifndef CORE_SIMULATION_INTERACTIONTABLE_H
+#define CORE_SIMULATION_INTERACTIONTABLE_H
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+class Cell;
+class Interaction;
+
+class InteractionTable {
+public:
+    // Interactions of all agents of a site. The table owns the interactions and stores them contiguously (a removed
+    // entry is replaced by the last one), an open-addressed hash index with linear probing maps the ordered pair of
+    // agent ids to the current interaction of the pair. Closed interactions stay alive until the end of the timestep,
+    // agents may still hold them while they are handled.
+    using Key = std::uint64_t;
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    struct Entry {
+        Key key;
+        std::shared_ptr<Interaction> interaction;
+    };
+
+    using const_iterator = std::vector<Entry>::const_iterator;
+    [[nodiscard]] const_iterator begin() const { return entries_.begin(); }
+    [[nodiscard]] const_iterator end() const { return entries_.end(); }
+    [[nodiscard]] size_t size() const { return entries_.size(); }
+
+    /// Key of a pair of agents, it does not depend on the order of the agents
+    static Key key(const Cell *cell1, const Cell *cell2);
+
+    /// Current interaction of a pair of agents (nullptr if there is none)
+    [[nodiscard]] Interaction *find(const Cell *cell1, const Cell *cell2) const;
+
+    /// Adds an interaction (if it is not in the table yet) and makes it the current interaction of its agents
+    void insert(const std::shared_ptr<Interaction> &interaction);
+
+    /// Removes the current interaction of a pair of agents from the index, the interaction itself stays in the table
+    void erase(const Cell *cell1, const Cell *cell2);
+
+    /// Removes an interaction from the table, it is kept alive until releaseClosed is called
+    void close(Interaction *interaction);
+
+    /// Destroys the closed interactions (at the end of a timestep)
+    void releaseClosed();
+
+private:
+    static constexpr std::int32_t empty_slot = -1;
+
+    /// Slot of a key in the index (npos if the key is not in the index)
+    [[nodiscard]] size_t findSlot(Key key) const;
+    void insertIntoIndex(Key key, std::int32_t entry);
+    void eraseSlot(size_t slot);
+    void rehash(size_t number_of_slots);
+
+    std::vector<Entry> entries_{};
+    // Index of the entries (power of two slots, at most half of them used)
+    std::vector<std::int32_t> slots_{};
+    size_t used_slots_{};
+    std::vector<std::shared_ptr<Interaction>> closed_{};
+};
+
+#endif /* CORE_SIMULATION_INTERACTIONTABLE_H */
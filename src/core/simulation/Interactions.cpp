@@ -23,6 +23,10 @@
 Interactions::Interactions(Cell *cell, NeighbourhoodLocator *nhLocator) {
     this->cell = cell;
     neighbourhoodLocator = nhLocator;
+    // Room for the usual number of contacts, the buffers only grow with the interactions of crowded cells
+    interactions.reserve(initial_capacity);
+    interaction_order_.reserve(initial_capacity);
+    collisions_.reserve(initial_capacity);
 }
 
 Interactions::~Interactions() {
@@ -31,13 +35,17 @@ Interactions::~Interactions() {
 
 void Interactions::doWholeProcess(double time_delta, double current_time, InSituMeasurements *measurments) {
     if (cell->getSite()->getInteractionFactory()->isInteractionsOn()) {
-        const auto collisions = neighbourhoodLocator->getCollisions(cell);
+        auto &collisions = collisions_;
+        neighbourhoodLocator->getCollisions(cell, collisions);
         for (const auto &collision: collisions) {
-            if (auto itCellInteraction = interactionPartners.find(collision->getCollisionCell()); itCellInteraction
-                                                                                                  !=
-                                                                                                  interactionPartners.end()) {
+            Interaction *existing_interaction;
+            {
+                const auto lock = cell->getSite()->lockSharedStructures();
+                existing_interaction = interactionTable().find(cell, collision->getCollisionCell());
+            }
+            if (existing_interaction != nullptr) {
                 collision->type = MeasurementType::EXISTING_INTERACTION;
-                itCellInteraction->second->addCurrentCollision(collision);
+                existing_interaction->addCurrentCollision(collision);
             } else if (auto interaction = cell->getSite()->getInteractionFactory()->createInteraction(time_delta, current_time, collision,
                                                                                 measurments); interaction
                                                                                               != nullptr) {
@@ -46,19 +54,19 @@ void Interactions::doWholeProcess(double time_delta, double current_time, InSitu
                 collision->getCollisionCell()->getInteractions()->addInteraction(interaction);
             }
         }
+        collisions.clear();
         executeAllInteractions(time_delta, current_time);
     }
 }
 
 void Interactions::removeCollisionsOfExistingInteractions(std::vector<std::shared_ptr<Collision>> &collisions) {
-
+    const auto lock = cell->getSite()->lockSharedStructures();
     auto itCollisions = collisions.begin();
     while (itCollisions != collisions.end()) {
 
         auto collision = *itCollisions;
         Cell *collCell = collision->getCollisionCell();
-        if (auto itCellInteraction = interactionPartners.find(collCell);itCellInteraction !=
-                                                                        interactionPartners.end()) {
+        if (interactionTable().find(cell, collCell) != nullptr) {
 
             collisions.erase(itCollisions);
         } else {
@@ -68,21 +76,27 @@ void Interactions::removeCollisionsOfExistingInteractions(std::vector<std::share
 }
 
 void Interactions::addInteraction(std::shared_ptr<Interaction> interaction) {
-    interactions.push_back(interaction);
-    Cell *otherCell = interaction->getOtherCell(cell);
-    interactionPartners[otherCell] = interaction;
+    interactions.push_back(interaction.get());
+    // The execution order grows with the interactions, i.e. in the timestep of the new contact
+    interaction_order_.reserve(interactions.capacity());
+    {
+        const auto lock = cell->getSite()->lockSharedStructures();
+        interactionTable().insert(interaction);
+    }
+    // A contact from the neighbourhood of another agent wakes a quiescent cell
+    cell->wake();
 }
 
 void Interactions::executeAllInteractions(double timestep, double current_time) {
     size_t numberOfInteractions = interactions.size();
     if (numberOfInteractions > 0) {
-        std::vector<unsigned int> currentPermutation =
-                abm::util::generateRandomPermutation(cell->getSite()->getRandomGenerator(), numberOfInteractions);
+        interaction_order_.resize(numberOfInteractions);
+        abm::util::generateRandomPermutation(cell->getSite()->getRandomGenerator(), interaction_order_.data(),
+                                             numberOfInteractions);
 
-        for (unsigned int currentInteraction : currentPermutation) {
+        for (unsigned int currentInteraction : interaction_order_) {
             auto interaction = interactions.at(currentInteraction);
             if (!(interaction->isDelted())) {
-                std::string intName = interaction->getInteractionName();
                 interaction->handle(cell, timestep, current_time);
                 if (interaction->getOtherCell(cell)->getCurrentCellState()->checkForDeath(current_time)) {
                     continue;
@@ -104,9 +118,8 @@ void Interactions::removeClosedInteractions() {
         auto interaction = *it;
         if (!interaction->isActive()) {
             Cell *otherCell = interaction->getOtherCell(cell);
-            otherCell->getInteractions()->removeInteraction(interaction.get());
-            removeInteraction(interaction.get());
-            interaction = nullptr;
+            otherCell->getInteractions()->removeInteraction(interaction);
+            removeInteraction(interaction);
         } else {
             it++;
         }
@@ -115,16 +128,11 @@ void Interactions::removeClosedInteractions() {
 
 void Interactions::removeInteraction(Interaction *interaction) {
     Cell *otherCell = interaction->getOtherCell(cell);
-
-    if (!interactionPartners.empty()) {
-        if (interactionPartners.count(otherCell) > 0) {
-            interactionPartners.erase(interactionPartners.find(otherCell));
-        }
-    }
-    interactions.erase(std::remove_if(interactions.begin(),
-                                      interactions.end(),
-                                      [interaction](const auto &i) { return i.get() == interaction; }),
-                       interactions.end());
+    interactions.erase(std::remove(interactions.begin(), interactions.end(), interaction), interactions.end());
+    // The interaction leaves the table with its first cell, the other cell still holds it until it is removed there
+    const auto lock = cell->getSite()->lockSharedStructures();
+    interactionTable().erase(cell, otherCell);
+    interactionTable().close(interaction);
 }
 
 void Interactions::removeAllInteractions() {
@@ -132,9 +140,8 @@ void Interactions::removeAllInteractions() {
     while (it != interactions.end()) {
         auto interaction = *it;
         Cell *otherCell = interaction->getOtherCell(cell);
-        otherCell->getInteractions()->removeInteraction(interaction.get());
-        removeInteraction(interaction.get());
-        interaction = nullptr;
+        otherCell->getInteractions()->removeInteraction(interaction);
+        removeInteraction(interaction);
     }
 }
 
@@ -177,9 +184,11 @@ bool Interactions::hasCollisions() {
 
 void Interactions::avoidNewInteractions(double time_delta, double current_time) {
     if (cell->getSite()->getInteractionFactory()->isInteractionsOn()) {
-        auto collisions = neighbourhoodLocator->getCollisions(cell);
+        auto &collisions = collisions_;
+        neighbourhoodLocator->getCollisions(cell, collisions);
         removeCollisionsOfExistingInteractions(collisions);
         doAvoidanceInteractions(collisions, time_delta, current_time);
+        collisions.clear();
     }
 }
 
@@ -201,12 +210,13 @@ void Interactions::doAvoidanceInteractions(std::vector<std::shared_ptr<Collision
     removeClosedInteractions();
 }
 
-const std::vector<std::shared_ptr<Interaction>> &Interactions::getAllInteractions() {
+const std::vector<Interaction *> &Interactions::getAllInteractions() {
     return interactions;
 }
 
-const std::map<Cell *, std::shared_ptr<Interaction>> &Interactions::getAllInteractionPartners() {
-    return interactionPartners;
+InteractionTable &Interactions::interactionTable() {
+    if (interaction_table_ == nullptr) interaction_table_ = cell->getSite()->getAgentManager()->getInteractionTable();
+    return *interaction_table_;
 }
 
 
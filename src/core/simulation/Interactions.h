@@ -16,8 +16,10 @@
 #include <list>
 #include <map>
 #include <vector>
+#include <utility>
 
 #include "core/basic/Coordinate3D.h"
+#include "core/simulation/InteractionTable.h"
 #include "core/simulation/neighbourhood/NeighbourhoodLocator.h"
 
 
@@ -48,14 +50,20 @@ public:
     bool hasCollisions();
     void avoidNewInteractions(double time_delta, double current_time);
     void displayInteractions();
-    const std::vector<std::shared_ptr<Interaction>> &getAllInteractions();
-    const std::map<Cell *, std::shared_ptr<Interaction>> &getAllInteractionPartners();
+    const std::vector<Interaction *> &getAllInteractions();
 
 private:
+    static constexpr size_t initial_capacity = 8;
+    /// Interaction table of the site, it is taken from the agent manager on first use
+    InteractionTable &interactionTable();
     Cell *cell;
     NeighbourhoodLocator *neighbourhoodLocator;
-    std::vector<std::shared_ptr<Interaction>> interactions;
-    std::map<Cell *, std::shared_ptr<Interaction>> interactionPartners;
+    // Interactions of this cell in the order of their creation, they are owned by the interaction table of the site
+    std::vector<Interaction *> interactions;
+    std::shared_ptr<InteractionTable> interaction_table_{};
+    // Scratch buffers of a timestep that keep their capacity between timesteps
+    std::vector<std::shared_ptr<Collision>> collisions_{};
+    std::vector<unsigned int> interaction_order_{};
 };
 
 #endif /* CORE_SIMULATION_INTERACTIONS_H */
@@ -0,0 +1,205 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "core/simulation/OdeEngine.h"
+#include "core/utils/macros.h"
+
+namespace {
+    // Butcher tableau of Dormand and Prince, the weights of the 5th order solution are the last row of a and the
+    // error weights are the differences to the embedded 4th order solution
+    constexpr std::array<std::array<double, 6>, 7> a{{
+            {},
+            {1.0 / 5.0},
+            {3.0 / 40.0, 9.0 / 40.0},
+            {44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0},
+            {19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0},
+            {9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0},
+            {35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0}
+    }};
+    constexpr std::array<double, 7> e{71.0 / 57600.0, 0.0, -71.0 / 16695.0, 71.0 / 1920.0, -17253.0 / 339200.0,
+                                      22.0 / 525.0, -1.0 / 40.0};
+    constexpr unsigned int number_of_stages = 7;
+    // Bounds of the change of the step size and the smallest step relative to the timestep
+    constexpr double safety = 0.9;
+    constexpr double min_factor = 0.2;
+    constexpr double max_factor = 5.0;
+    constexpr double min_relative_step = 1e-12;
+}
+
+OdeModel::Instance::Instance(Instance &&other) noexcept {
+    *this = std::move(other);
+}
+
+OdeModel::Instance &OdeModel::Instance::operator=(Instance &&other) noexcept {
+    if (this != &other) {
+        reset();
+        model_ = std::move(other.model_);
+        index_ = other.index_;
+        state_ = other.state_;
+        parameters_ = other.parameters_;
+        inputs_ = other.inputs_;
+        other.model_ = nullptr;
+    }
+    return *this;
+}
+
+OdeModel::Instance::~Instance() {
+    reset();
+}
+
+void OdeModel::Instance::reset() {
+    if (model_ != nullptr) model_->removeInstance(index_);
+    model_ = nullptr;
+    state_ = parameters_ = inputs_ = nullptr;
+}
+
+OdeModel::OdeModel(unsigned int dimension, unsigned int number_of_parameters, unsigned int number_of_inputs)
+        : dimension_(dimension), number_of_parameters_(number_of_parameters), number_of_inputs_(number_of_inputs) {}
+
+OdeModel::Instance OdeModel::addInstance(std::initializer_list<double> initial_state,
+                                         std::initializer_list<double> parameters) {
+    if (initial_state.size() != dimension_ || parameters.size() != number_of_parameters_) {
+        ERROR_STDERR("Instance of an ODE model with " << initial_state.size() << " states and " << parameters.size()
+                                                      << " parameters instead of " << dimension_ << " and "
+                                                      << number_of_parameters_);
+        exit(1);
+    }
+    const std::lock_guard<std::mutex> lock(mutex_);
+    unsigned int index;
+    if (free_instances_.empty()) {
+        if (chunks_.empty() || chunks_.back()->size == chunk_size) {
+            auto &chunk = chunks_.emplace_back(std::make_unique<Chunk>());
+            chunk->states.resize(chunk_size * dimension_);
+            chunk->parameters.resize(chunk_size * number_of_parameters_);
+            chunk->inputs.resize(chunk_size * number_of_inputs_);
+            chunk->step_sizes.resize(chunk_size);
+        }
+        index = (chunks_.size() - 1) * chunk_size + chunks_.back()->size++;
+    } else {
+        index = free_instances_.back();
+        free_instances_.pop_back();
+    }
+    auto &chunk = *chunks_[index / chunk_size];
+    const auto slot = index % chunk_size;
+    chunk.step_sizes[slot] = 0.0;
+
+    Instance instance;
+    instance.model_ = shared_from_this();
+    instance.index_ = index;
+    instance.state_ = &chunk.states[slot * dimension_];
+    instance.parameters_ = &chunk.parameters[slot * number_of_parameters_];
+    instance.inputs_ = &chunk.inputs[slot * number_of_inputs_];
+    std::copy(initial_state.begin(), initial_state.end(), instance.state_);
+    std::copy(parameters.begin(), parameters.end(), instance.parameters_);
+    return instance;
+}
+
+void OdeModel::removeInstance(unsigned int index) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    auto &chunk = *chunks_[index / chunk_size];
+    const auto slot = index % chunk_size;
+    std::fill_n(&chunk.states[slot * dimension_], dimension_, 0.0);
+    std::fill_n(&chunk.parameters[slot * number_of_parameters_], number_of_parameters_, 0.0);
+    std::fill_n(&chunk.inputs[slot * number_of_inputs_], number_of_inputs_, 0.0);
+    free_instances_.push_back(index);
+}
+
+OdeEngine::OdeEngine(double relative_tolerance, double absolute_tolerance)
+        : relative_tolerance_(relative_tolerance), absolute_tolerance_(absolute_tolerance),
+          stages_(number_of_stages) {}
+
+void OdeEngine::integrate(double timestep) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &[type, model]: models_) {
+        for (auto &chunk: model->chunks_) {
+            if (chunk->size == 0) continue;
+            if (model->hasClosedForm()) {
+                model->solve(timestep, chunk->states.data(), chunk->parameters.data(), chunk->inputs.data(),
+                             chunk->size);
+            } else {
+                integrateChunk(*model, *chunk, timestep);
+            }
+            std::fill(chunk->inputs.begin(), chunk->inputs.end(), 0.0);
+        }
+    }
+}
+
+void OdeEngine::integrateChunk(const OdeModel &model, OdeModel::Chunk &chunk, double timestep) {
+    const size_t n = chunk.size;
+    const unsigned int dimension = model.getDimension();
+    const size_t length = n * dimension;
+    for (auto &stage: stages_) stage.resize(length);
+    trial_state_.resize(length);
+    next_state_.resize(length);
+    times_.assign(n, 0.0);
+    steps_.resize(n);
+    double *y = chunk.states.data();
+    const double *p = chunk.parameters.data();
+    const double *u = chunk.inputs.data();
+    double *h = chunk.step_sizes.data();
+    for (size_t k = 0; k < n; ++k) {
+        if (h[k] <= 0) h[k] = timestep;
+    }
+
+    // Instances that reached the end of the timestep take steps of length zero, i.e. they keep their state
+    size_t unfinished = n;
+    while (unfinished > 0) {
+        for (size_t k = 0; k < n; ++k) steps_[k] = std::min(h[k], timestep - times_[k]);
+
+        // Stages 1-6, the 7th stage is evaluated at the 5th order solution
+        model.rightHandSide(y, p, u, stages_[0].data(), n);
+        for (unsigned int s = 1; s < number_of_stages; ++s) {
+            double *target = s + 1 < number_of_stages ? trial_state_.data() : next_state_.data();
+            for (size_t i = 0; i < length; ++i) {
+                double sum = 0;
+                for (unsigned int j = 0; j < s; ++j) sum += a[s][j] * stages_[j][i];
+                target[i] = y[i] + steps_[i / dimension] * sum;
+            }
+            model.rightHandSide(target, p, u, stages_[s].data(), n);
+        }
+
+        unfinished = 0;
+        for (size_t k = 0; k < n; ++k) {
+            if (times_[k] >= timestep) continue;
+            const double step = steps_[k];
+            const bool last = step == timestep - times_[k];
+
+            // Largest error of the states of the instance scaled by the tolerances
+            double error = 0;
+            for (size_t i = k * dimension; i < (k + 1) * dimension; ++i) {
+                double estimate = 0;
+                for (unsigned int j = 0; j < number_of_stages; ++j) estimate += e[j] * stages_[j][i];
+                const double scale =
+                        absolute_tolerance_ + relative_tolerance_ * std::max(std::abs(y[i]), std::abs(next_state_[i]));
+                error = std::max(error, std::abs(step * estimate) / scale);
+            }
+            if (!std::isfinite(error)) error = std::numeric_limits<double>::max();
+
+            const double factor = error > 0 ? std::clamp(safety * std::pow(error, -0.2), min_factor, max_factor)
+                                             : max_factor;
+            if (error <= 1.0 || step <= min_relative_step * timestep) {
+                std::copy(&next_state_[k * dimension], &next_state_[(k + 1) * dimension], &y[k * dimension]);
+                times_[k] = last ? timestep : times_[k] + step;
+                ++accepted_steps_;
+                // A step that was shortened to the end of the timestep does not shrink the step size
+                h[k] = last ? std::max(h[k], step * factor) : step * factor;
+            } else {
+                ++rejected_steps_;
+                h[k] = step * std::min(factor, 1.0);
+            }
+            if (times_[k] < timestep) ++unfinished;
+        }
+    }
+}
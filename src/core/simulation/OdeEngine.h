@@ -0,0 +1,147 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#ifndef CORE_SIMULATION_ODEENGINE_H
+#define CORE_SIMULATION_ODEENGINE_H
+
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <vector>
+
+class OdeModel : public std::enable_shared_from_this<OdeModel> {
+public:
+    // Intracellular model of an agent type (system of autonomous ODEs). States, parameters and inputs of all instances
+    // are stored in contiguous arrays (instance after instance) that are split into chunks of fixed capacity, i.e.
+    // instances keep their address and the engine integrates a whole chunk in one batch. Inputs couple the model to the
+    // environment (e.g. molecules), they are set by the agents during a timestep and reset after the integration.
+    static constexpr unsigned int chunk_size = 256;
+
+    class Instance {
+    public:
+        // Handle of an agent to its instance, the instance is removed when the handle is destroyed or reset
+        Instance() = default;
+        Instance(Instance &&other) noexcept;
+        Instance &operator=(Instance &&other) noexcept;
+        Instance(const Instance &) = delete;
+        Instance &operator=(const Instance &) = delete;
+        ~Instance();
+
+        [[nodiscard]] bool isValid() const { return model_ != nullptr; };
+        double *state() const { return state_; };
+        double *parameters() const { return parameters_; };
+        double *inputs() const { return inputs_; };
+        void reset();
+
+    private:
+        friend class OdeModel;
+        std::shared_ptr<OdeModel> model_{};
+        unsigned int index_{};
+        double *state_{};
+        double *parameters_{};
+        double *inputs_{};
+    };
+
+    OdeModel(unsigned int dimension, unsigned int number_of_parameters, unsigned int number_of_inputs);
+    virtual ~OdeModel() = default;
+
+    /*!
+     * Right-hand side of the model for a batch of instances, has to vanish for instances with zero parameters
+     * @param y Array with the states of n instances
+     * @param parameters Array with the parameters of n instances
+     * @param inputs Array with the inputs of n instances
+     * @param dydt Array for the derivatives of n instances
+     * @param n Number of instances
+     */
+    virtual void rightHandSide(const double *y, const double *parameters, const double *inputs, double *dydt,
+                               size_t n) const = 0;
+
+    /// Models with a closed-form solution are advanced exactly by solve instead of being integrated
+    [[nodiscard]] virtual bool hasClosedForm() const { return false; };
+    virtual void solve(double dt, double *y, const double *parameters, const double *inputs, size_t n) const {};
+
+    /// Adds an instance with an initial state and its parameters, inputs are zero
+    Instance addInstance(std::initializer_list<double> initial_state, std::initializer_list<double> parameters);
+
+    [[nodiscard]] unsigned int getDimension() const { return dimension_; };
+    [[nodiscard]] unsigned int getNumberOfParameters() const { return number_of_parameters_; };
+    [[nodiscard]] unsigned int getNumberOfInputs() const { return number_of_inputs_; };
+
+private:
+    friend class OdeEngine;
+
+    struct Chunk {
+        std::vector<double> states{};
+        std::vector<double> parameters{};
+        std::vector<double> inputs{};
+        // Used slots (removed instances are zero until they are reused) and the last accepted step size per instance
+        unsigned int size{};
+        std::vector<double> step_sizes{};
+    };
+
+    void removeInstance(unsigned int index);
+
+    unsigned int dimension_;
+    unsigned int number_of_parameters_;
+    unsigned int number_of_inputs_;
+    std::mutex mutex_{};
+    std::vector<std::unique_ptr<Chunk>> chunks_{};
+    std::vector<unsigned int> free_instances_{};
+};
+
+class OdeEngine {
+public:
+    // Integrates the intracellular models of all agents of a site once per timestep. Models with a closed-form solution
+    // are solved exactly, all others are integrated chunk by chunk with the embedded Runge-Kutta pair of Dormand and
+    // Prince (5th order, error estimate of 4th order). Every instance has its own step size, controlled by its largest
+    // scaled error and kept for the next timestep, but a single step never exceeds the timestep of the site (the last
+    // step of a timestep is shortened to its end). The instances of a chunk are evaluated together, but an instance
+    // does not depend on the others in its chunk, i.e. not on the order in which the instances were added.
+    OdeEngine(double relative_tolerance, double absolute_tolerance);
+
+    /// Model of a type, it is created on first use
+    template<typename Model>
+    Model &model() {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        auto &model = models_[std::type_index(typeid(Model))];
+        if (model == nullptr) model = std::make_shared<Model>();
+        return static_cast<Model &>(*model);
+    }
+
+    /*!
+     * Advances all instances of all models by a timestep, the inputs are reset afterwards
+     * @param timestep Double that contains the timestep
+     */
+    void integrate(double timestep);
+
+    /// Number of accepted and rejected Runge-Kutta steps of all instances since the start
+    [[nodiscard]] size_t getAcceptedSteps() const { return accepted_steps_; };
+    [[nodiscard]] size_t getRejectedSteps() const { return rejected_steps_; };
+
+private:
+    void integrateChunk(const OdeModel &model, OdeModel::Chunk &chunk, double timestep);
+
+    double relative_tolerance_;
+    double absolute_tolerance_;
+    std::mutex mutex_{};
+    std::map<std::type_index, std::shared_ptr<OdeModel>> models_{};
+    size_t accepted_steps_{};
+    size_t rejected_steps_{};
+    // Stages, trial state and error estimate of the chunk that is integrated, time and step of its instances
+    std::vector<std::vector<double>> stages_{};
+    std::vector<double> trial_state_{};
+    std::vector<double> next_state_{};
+    std::vector<double> times_{};
+    std::vector<double> steps_{};
+};
+
+#endif /* CORE_SIMULATION_ODEENGINE_H */
@@ -8,6 +8,7 @@
 //  This code is licensed under BSD 2-Clause
 //  See the LICENSE file provided with this code for the full license.
 
+#include <algorithm>
 #include <chrono>
 #include <omp.h>
 #include <string>
@@ -19,6 +20,7 @@
 #include "core/simulation/site/CuboidSite.h"
 #include "core/utils/macros.h"
 #include "core/utils/misc_util.h"
+#include "core/utils/RunArena.h"
 #include "core/utils/time_util.h"
 #include "core/visualisation/Visualizer.h"
 
@@ -56,12 +58,16 @@ void Simulator::executeRuns(int runs, int seed, const std::string& output_dir, c
     const auto analyser = createAnalyser(config_path_, project_dir);
     std::vector<std::pair<std::string, std::vector<std::string>>> api_output;
 
-    // Start parallelized for-loop over all runs for one parameter configuration
-#pragma omp parallel for schedule(dynamic)
+    // Start parallelized for-loop over all runs for one parameter configuration. The team is not larger than the number
+    // of runs, i.e. a single run is not inside of an active parallel region and may use the threads itself.
+#pragma omp parallel for schedule(dynamic) num_threads(std::max(1, std::min(runs, omp_get_max_threads())))
     for (int current_run = 1; current_run <= runs; ++current_run) {
         SYSTEM_STDOUT("Thread " << omp_get_thread_num() << ": Start Run " << current_run << "/" << runs);
 
-        // Setup environment for each run, e.g. each run has its own random number generator.
+        // Setup environment for each run, e.g. each run has its own random number generator. Agents, spheres,
+        // interactions and collisions of the run are allocated in its arena, which is released after the site.
+        abm::util::RunArena arena;
+        const abm::util::RunArena::Scope arena_scope(&arena);
         int const run_seed = current_run + current_sim_seed;
         const auto random_generator = std::make_unique<Randomizer>(run_seed);
         const auto site = createSites(current_run, random_generator.get(), analyser.get());
@@ -84,6 +90,10 @@ void Simulator::executeRuns(int runs, int seed, const std::string& output_dir, c
 
         auto hash = abm::util::generateHashFromAgents(time.getCurrentTime(), site->getAgentManager()->getAllAgents());
         SYSTEM_STDOUT("Hash for run " + std::to_string(current_run) + " of " + parameter_string + ": "+ hash);
+        const auto counters = arena.getCounters();
+        DEBUG_STDOUT("Arena of run " << current_run << ": " << counters.allocations << " allocations, "
+                     << counters.deallocations << " deallocations, peak " << counters.peak_bytes_in_use
+                     << " bytes in objects, peak " << counters.peak_bytes_from_system << " bytes from the system");
     }
 
     // Write outputs
@@ -16,11 +16,14 @@
 #include "core/simulation/boundary-condition/ReflectingBoundaries.h"
 #include "core/simulation/AgentManager.h"
 #include "core/utils/macros.h"
+#include "core/utils/Names.h"
 #include "external/json.hpp"
 #include "core/utils/macros.h"
 
 using json = nlohmann::json;
 
+thread_local Site::ThreadContext *Site::thread_context_ = nullptr;
+
 Site::Site(Randomizer *random_generator,
            std::shared_ptr<InSituMeasurements> measurements,
            std::string config_path, std::unordered_map<std::string, std::string> cmd_input_args,
@@ -49,7 +52,9 @@ void Site::doAgentDynamics(Randomizer *random_generator, SimulationTime &time) {
     const auto &all_agents = agent_manager_->getAllAgents();
     if (!all_agents.empty()) {
         // Loop over all agents (random order)
-        const auto current_order = abm::util::generateRandomPermutation(random_generator, all_agents.size());
+        agent_order_.resize(all_agents.size());
+        abm::util::generateRandomPermutation(random_generator, agent_order_.data(), agent_order_.size());
+        const auto &current_order = agent_order_;
         for (auto agent_idx = current_order.begin(); agent_idx < current_order.end(); ++agent_idx) {
             auto curr_agent = all_agents[*agent_idx];
             if (nullptr != curr_agent) {
@@ -66,6 +71,9 @@ void Site::doAgentDynamics(Randomizer *random_generator, SimulationTime &time) {
             }
         }
 
+        // Intracellular models of all agents are integrated in one batch per model
+        if (auto *ode_engine = agent_manager_->getOdeEngine()) ode_engine->integrate(dt);
+
         // Clean up agents
         agent_manager_->cleanUpAgents(current_time);
         agent_manager_->inputOfAgents(current_time, random_generator);
@@ -83,17 +91,26 @@ void Site::setStoppingCondition(const std::vector<std::string> &stopping_crit) {
     }
 }
 
-void Site::stopRunForCertainState(Cell &cell, std::string state, double current_time) {
+void Site::stopRunForCertainState(Cell &cell, int state_id, double current_time) {
+    static const int fungal_cell = abm::util::Names::intern("FungalCell");
+    static const int fungal_phagocytosed = abm::util::Names::intern("FungalPhagocytosed");
+    static const int death = abm::util::Names::intern("Death");
+    static const int death_by_aec = abm::util::Names::intern("DeathByAEC");
     // Ends a simulation if all fungi were touched at least once (FTP)
     // Cumulated first passage time (FTP) is clearance time (CT)
-    if (abm::util::isSubstring("FungalCell", cell.getTypeName())) {
-        if (state == "FungalPhagocytosed" or state == "Death" or state == "DeathByAEC") {
+    if (abm::util::Names::related(fungal_cell, cell.getTypeId())) {
+        // Room for all initial fungal cells before the first one is detected, detections do not reallocate the list
+        if (detected_fungi_id.capacity() < agent_manager_->getInitFungalQuantity()) {
+            const auto lock = lockSharedStructures();
+            detected_fungi_id.reserve(agent_manager_->getInitFungalQuantity());
+        }
+        if (state_id == fungal_phagocytosed or state_id == death or state_id == death_by_aec) {
+            const auto lock = lockSharedStructures();
             int cellid = cell.getId();
-            int number_of_previously_found_fungal_cells = detected_fungi_id.size();
-            detected_fungi_id.emplace_back(cellid);
-            std::sort(detected_fungi_id.begin(), detected_fungi_id.end());
-            detected_fungi_id.erase(std::unique(detected_fungi_id.begin(), detected_fungi_id.end()), detected_fungi_id.end());
-            if (number_of_previously_found_fungal_cells < detected_fungi_id.size()) {
+            // Sorted list of the detected fungal cells, only new cells are inserted
+            const auto position = std::lower_bound(detected_fungi_id.begin(), detected_fungi_id.end(), cellid);
+            if (position == detected_fungi_id.end() || *position != cellid) {
+                detected_fungi_id.insert(position, cellid);
                 DEBUG_STDOUT("FungalCell with id=" << cellid << " was detected by ImmuneCell at " << current_time);
                 int fungal_cells_remaining = agent_manager_->getInitFungalQuantity() - detected_fungi_id.size();
                 bool stopping_FPT = find(stopping_criteria.begin(), stopping_criteria.end(), "FirstPassageTime") != stopping_criteria.end();
@@ -12,6 +12,7 @@
 #define CORE_SIMULATION_SITE_H
 
 #include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 #include <algorithm>
@@ -64,9 +65,11 @@ public:
 
     /*!
      * Terminates Simulation for certain interactions (i.e. all phagocytes were touched)
-     * @param interaction Interaction object that contains an interaction
+     * @param cell Cell that changed its state
+     * @param state_id Int that contains the id of the new state in abm::util::Names
+     * @param current_time Double for current time
      */
-    void stopRunForCertainState(Cell &cell, std::string state, double current_time);
+    void stopRunForCertainState(Cell &cell, int state_id, double current_time);
 
     virtual void handleCmdInputArgs(std::unordered_map<std::string, std::string> cmd_input_args);
     void addOutputPath(const std::string& path) {visualizer_output_paths_.emplace_back(path);};
@@ -76,7 +79,26 @@ public:
     std::vector<std::string> getOutputPaths() {return visualizer_output_paths_;};
     std::vector<std::string> getOutputCommands() {return output_commands_;};
     [[nodiscard]] bool checkForStopping(const SimulationTime &time) const;
-    Randomizer *getRandomGenerator() { return random_generator_; }
+    Randomizer *getRandomGenerator() { return thread_context_ != nullptr ? thread_context_->random_generator : random_generator_; }
+
+    // State of a thread that updates the agents of one tile while other tiles are updated in parallel. Agents draw
+    // from the generator of their tile, such that results do not depend on the number of threads.
+    struct ThreadContext {
+        Randomizer *random_generator{};
+        double alpha_2d_turning_angle{};
+    };
+    /// Sets the context of the calling thread for all sites, nullptr restores the state of the site
+    static void setThreadContext(ThreadContext *context) { thread_context_ = context; }
+
+    /*!
+     * Locks the structures that are shared by all agents of the site (neighbourhood, sphere registry, measurements)
+     * while agents are updated in parallel, otherwise the returned lock is empty
+     * @return Lock that is held until it is destroyed
+     */
+    std::unique_lock<std::recursive_mutex> lockSharedStructures() {
+        return updating_agents_in_parallel_ ? std::unique_lock<std::recursive_mutex>(shared_structures_mutex_)
+                                            : std::unique_lock<std::recursive_mutex>();
+    }
     NeighbourhoodLocator *getNeighbourhoodLocator() { return neighbourhood_locator_.get(); }
     AgentManager *getAgentManager() const { return agent_manager_.get(); }
     InSituMeasurements *getMeasurments() const { return measurements_.get(); }
@@ -92,8 +114,9 @@ public:
     abm::util::VisualizerParameters getOverwrittenVisParameters() {return parameters_.visualizer_to_overwrite;};
     [[nodiscard]] int getState() const { return state_; }
     [[nodiscard]] unsigned int getNumberOfSpatialDimensions() const { return dimensions; }
-    [[nodiscard]] double getLatestAlpha2dTurningAngle() const { return alpha2dTurningAngle; }
-    [[nodiscard]] double getInputRate(std::string agent_name) { return input_rates_[agent_name]; }
+    [[nodiscard]] double getLatestAlpha2dTurningAngle() const { return thread_context_ != nullptr ? thread_context_->alpha_2d_turning_angle : alpha2dTurningAngle; }
+    void setLatestAlpha2dTurningAngle(double alpha) { (thread_context_ != nullptr ? thread_context_->alpha_2d_turning_angle : alpha2dTurningAngle) = alpha; }
+    [[nodiscard]] double getInputRate(const std::string &agent_name) { return input_rates_[agent_name]; }
     [[nodiscard]] std::string getIdentifier() const { return identifier_; }
 
     friend void InSituMeasurements::observeMeasurements(const SimulationTime &time);
@@ -114,7 +137,7 @@ public:
     virtual Coordinate3D generateBackShiftOnContacting(SphereRepresentation *activeSphere,
                                                        SphereRepresentation *passiveSphere,
                                                        double mustOverhead) = 0;
-    virtual double getFeatureValueByName(std::string name) { return {}; }
+    virtual double getFeatureValueByName(const std::string &name) { return {}; }
     [[nodiscard]] virtual double getRadius() const { return 0.0; }
     virtual Coordinate3D generateDirectedVector(Coordinate3D position,
                                                 SphericCoordinate3D posOfGoal,
@@ -143,6 +166,11 @@ protected:
     Coordinate3D boundary_input_vector_{};
     std::vector<std::pair<std::string, long>> stopping_cell_states;
     Randomizer *random_generator_;
+    static thread_local ThreadContext *thread_context_;
+    bool updating_agents_in_parallel_{};
+    // Random order of the agents in a timestep, the buffer is reused in every timestep
+    std::vector<unsigned int> agent_order_{};
+    std::recursive_mutex shared_structures_mutex_{};
     std::shared_ptr<InSituMeasurements> measurements_;
     std::unique_ptr<BoundaryCondition> boundary_condition_;
     std::unique_ptr<NeighbourhoodLocator> neighbourhood_locator_;
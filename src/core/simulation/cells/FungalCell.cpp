@@ -14,6 +14,7 @@
 #include "core/simulation/morphology/SphericalMorphology.h"
 
 #include "core/utils/macros.h"
+#include "core/utils/Names.h"
 
 
 std::string FungalCell::getTypeName() {
@@ -21,9 +22,13 @@ std::string FungalCell::getTypeName() {
 }
 
 void FungalCell::handleInteractionEvent(InteractionEvent *ievent, double current_time) {
+    static const int phagocytose = abm::util::Names::intern("Phagocytose");
+    static const int lysis = abm::util::Names::intern("Lysis");
+    static const int fungal_phagocytosed = abm::util::Names::intern("FungalPhagocytosed");
+    static const int death = abm::util::Names::intern("Death");
 
-    if (ievent->getNextState() == "Phagocytose") {
-        auto fState = getCellStateByName("FungalPhagocytosed");
+    if (ievent->getNextStateId() == phagocytose) {
+        auto fState = getCellStateById(fungal_phagocytosed);
         if (fState != 0) {
             setState(fState);
             INFO_STDOUT("Phagocytose: FungalCell was phagocytosed");
@@ -31,8 +36,8 @@ void FungalCell::handleInteractionEvent(InteractionEvent *ievent, double current
             getSite()->getAgentManager()->removeFungalCellFromList(this->getId(), current_time);
         }
     }
-    if (ievent->getNextState() == "Lysis") {
-        auto fState = getCellStateByName("Death");
+    if (ievent->getNextStateId() == lysis) {
+        auto fState = getCellStateById(death);
         if (fState != 0) {
             setState(fState);
             INFO_STDOUT("Lysis: Death of FungalCell");
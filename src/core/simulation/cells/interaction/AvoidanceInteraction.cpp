@@ -12,7 +12,7 @@
 #include "core/simulation/states/InteractionState.h"
 
 
-AvoidanceInteraction::AvoidanceInteraction(std::string identifier, Cell *cell1, Cell *cell2, double time_delta,
+AvoidanceInteraction::AvoidanceInteraction(const std::string &identifier, Cell *cell1, Cell *cell2, double time_delta,
                                            double current_time) : Interaction(identifier, cell1, cell2, time_delta,
                                                                               current_time) {
     setInitialState(time_delta, current_time);
@@ -18,7 +18,7 @@
 class AvoidanceInteraction : public Interaction {
 public:
     // Class for interaction type by which cell are separated after interaction
-    AvoidanceInteraction(std::string identifier, Cell *cell1, Cell *cell2, double time_delta, double current_time);
+    AvoidanceInteraction(const std::string &identifier, Cell *cell1, Cell *cell2, double time_delta, double current_time);
     [[nodiscard]] std::string getInteractionName() const final;
 };
 
@@ -11,7 +11,7 @@
 #include "IdenticalCellsInteraction.h"
 
 
-IdenticalCellsInteraction::IdenticalCellsInteraction(std::string identifier,
+IdenticalCellsInteraction::IdenticalCellsInteraction(const std::string &identifier,
                                                      Cell *cell1,
                                                      Cell *cell2,
                                                      double time_delta,
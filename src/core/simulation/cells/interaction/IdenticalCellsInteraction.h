@@ -19,7 +19,7 @@
 class IdenticalCellsInteraction : public Interaction {
 public:
     // Class for default interaction after collision between two identical cell types.
-    IdenticalCellsInteraction(std::string identifier, Cell *cell1, Cell *cell2, double time_delta, double current_time);
+    IdenticalCellsInteraction(const std::string &identifier, Cell *cell1, Cell *cell2, double time_delta, double current_time);
     [[nodiscard]] std::string getInteractionName() const final;
 };
 
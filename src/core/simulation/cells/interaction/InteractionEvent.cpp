@@ -10,15 +10,16 @@
 //  See the LICENSE file provided with this code for the full license.
 
 #include "InteractionEvent.h"
+#include "core/utils/Names.h"
 
 
-InteractionEvent::InteractionEvent(std::string previousState, std::string nextState) {
+InteractionEvent::InteractionEvent(int previousState, int nextState) {
     this->previousState = previousState;
     this->nextState = nextState;
     setDescriptiveName();
 }
 
-InteractionEvent::InteractionEvent(std::string previousState, std::string nextState, Interaction *interaction) {
+InteractionEvent::InteractionEvent(int previousState, int nextState, Interaction *interaction) {
     this->previousState = previousState;
     this->nextState = nextState;
     this->interaction = interaction;
@@ -33,12 +34,12 @@ std::string InteractionEvent::getDescriptiveName() {
     return descriptiveName;
 }
 
-std::string InteractionEvent::getNextState() {
-    return nextState;
+const std::string &InteractionEvent::getNextState() const {
+    return abm::util::Names::get(nextState);
 }
 
-std::string InteractionEvent::getPreviousState() {
-    return previousState;
+const std::string &InteractionEvent::getPreviousState() const {
+    return abm::util::Names::get(previousState);
 }
 
 Interaction *InteractionEvent::getInteraction() {
@@ -18,20 +18,23 @@ class Interaction;
 class InteractionEvent {
 public:
   // Class for handling for default actions an interaction undertakes after being triggered.
-    InteractionEvent(std::string previousState, std::string nextState);
-    InteractionEvent(std::string previousState, std::string nextState, Interaction *interaction);
+    // States are passed as ids of their names in abm::util::Names
+    InteractionEvent(int previousState, int nextState);
+    InteractionEvent(int previousState, int nextState, Interaction *interaction);
 
     void setDescriptiveName();
     std::string getDescriptiveName();
-    std::string getNextState();
-    std::string getPreviousState();
+    const std::string &getNextState() const;
+    const std::string &getPreviousState() const;
+    [[nodiscard]] int getNextStateId() const { return nextState; };
+    [[nodiscard]] int getPreviousStateId() const { return previousState; };
     Interaction *getInteraction();
 
 private:
-    std::string previousState;
-    std::string nextState;
+    int previousState;
+    int nextState;
     std::string descriptiveName;
-    Interaction *interaction;
+    Interaction *interaction{};
 
 };
 
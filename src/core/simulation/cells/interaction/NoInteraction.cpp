@@ -10,7 +10,7 @@
 
 #include "NoInteraction.h"
 
-NoInteraction::NoInteraction(std::string identifier, Cell *cell1, Cell *cell2, double time_delta, double current_time)
+NoInteraction::NoInteraction(const std::string &identifier, Cell *cell1, Cell *cell2, double time_delta, double current_time)
         : Interaction(identifier, cell1, cell2, time_delta, current_time) {
     setInitialState(time_delta, current_time, cell1);
 }
@@ -18,7 +18,7 @@
 class NoInteraction : public Interaction {
 public:
     // Class for default interaction after collision.
-    NoInteraction(std::string identifier, Cell *cell1, Cell *cell2, double time_delta, double current_time);
+    NoInteraction(const std::string &identifier, Cell *cell1, Cell *cell2, double time_delta, double current_time);
     [[nodiscard]] std::string getInteractionName() const override;
 };
 
@@ -12,9 +12,10 @@
 #include "PhagocyteFungusInteraction.h"
 #include "core/analyser/Analyser.h"
 #include "core/simulation/Cell.h"
+#include "core/utils/Names.h"
 
 
-PhagocyteFungusInteraction::PhagocyteFungusInteraction(std::string identifier,
+PhagocyteFungusInteraction::PhagocyteFungusInteraction(const std::string &identifier,
                                                        Cell *cell1,
                                                        Cell *cell2,
                                                        double time_delta,
@@ -23,20 +24,21 @@ PhagocyteFungusInteraction::PhagocyteFungusInteraction(std::string identifier,
                                                                                           cell2,
                                                                                           time_delta,
                                                                                           current_time) {
-    auto phagoCond = std::make_shared<Condition>(cellOne);
-    auto fungusCond = std::make_shared<Condition>(cellTwo);
+    auto phagoCond = abm::util::makeShared<Condition>(cellOne);
+    auto fungusCond = abm::util::makeShared<Condition>(cellTwo);
     cellularConditions[cellOne] = phagoCond;
     cellularConditions[cellTwo] = fungusCond;
     cellularStringConditions[cellOne->getTypeName()] = phagoCond;
     cellularStringConditions[cellTwo->getTypeName()] = fungusCond;
-    interactionState = cellOne->getSite()->getInteractionStateFactory()->createInteractionState(this, "InitialInteractionState", cellOne,
+    static const int initial_interaction_state = abm::util::Names::intern("InitialInteractionState");
+    interactionState = cellOne->getSite()->getInteractionStateFactory()->createInteractionState(this, initial_interaction_state, cellOne,
                                                                        cellTwo);
     if (cellularConditions.find(cell1) != cellularConditions.end()) {
         currentCondition = cellularConditions[cell1].get();
     }
 }
 
-PhagocyteFungusInteraction::PhagocyteFungusInteraction(std::string identifier,
+PhagocyteFungusInteraction::PhagocyteFungusInteraction(const std::string &identifier,
                                                        Cell *cell1,
                                                        Cell *cell2,
                                                        bool noInitialSetup,
@@ -46,8 +48,8 @@ PhagocyteFungusInteraction::PhagocyteFungusInteraction(std::string identifier,
                                                                                           cell2,
                                                                                           time_delta,
                                                                                           current_time) {
-    auto phagoCond = std::make_shared<Condition>(cellOne);
-    auto fungusCond = std::make_shared<Condition>(cellTwo);
+    auto phagoCond = abm::util::makeShared<Condition>(cellOne);
+    auto fungusCond = abm::util::makeShared<Condition>(cellTwo);
     cellularConditions[cellOne] = phagoCond;
     cellularConditions[cellTwo] = fungusCond;
     cellularStringConditions[cellOne->getTypeName()] = phagoCond;
@@ -20,12 +20,12 @@ class PhagocyteFungusInteraction : public Interaction {
 
 public:
   // Class for phagocytosis interaction. This class provides the main functionality if a phagocytosis event is triggered in a event chain.
-    PhagocyteFungusInteraction(std::string identifier,
+    PhagocyteFungusInteraction(const std::string &identifier,
                                Cell *cellOne,
                                Cell *cellTwo,
                                double time_delta,
                                double current_time);
-    PhagocyteFungusInteraction(std::string identifier,
+    PhagocyteFungusInteraction(const std::string &identifier,
                                Cell *cell1,
                                Cell *cell2,
                                bool noInitialSetup,
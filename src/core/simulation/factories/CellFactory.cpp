@@ -12,6 +12,7 @@
 #include "core/simulation/cells/ImmuneCell.h"
 #include "core/simulation/cells/FungalCell.h"
 #include "core/simulation/Site.h"
+#include "core/utils/RunArena.h"
 
 
 CellFactory::CellFactory(const std::unique_ptr<abm::util::SimulationParameters::SiteParameters> &site_parameters) {
@@ -29,11 +30,11 @@ std::shared_ptr<Cell> CellFactory::createCell(const std::string &agenttype,
     std::shared_ptr<Cell> agent{};
     auto site_tag = site->getIdentifier();
     if (agenttype == "Cell") {
-        agent = std::make_shared<Cell>(std::move(c), id, site, time_delta, current_time);
+        agent = abm::util::makeShared<Cell>(std::move(c), id, site, time_delta, current_time);
     } else if (agenttype == "ImmuneCell") {
-        agent = std::make_shared<ImmuneCell>(std::move(c), id, site, time_delta, current_time);
+        agent = abm::util::makeShared<ImmuneCell>(std::move(c), id, site, time_delta, current_time);
     } else if (agenttype == "FungalCell") {
-        agent = std::make_shared<FungalCell>(std::move(c), id, site, time_delta, current_time);
+        agent = abm::util::makeShared<FungalCell>(std::move(c), id, site, time_delta, current_time);
     }
     agent->setup(time_delta, current_time, agent_configurations_[site_tag + agenttype].get());
     return agent;
@@ -12,47 +12,48 @@
 
 #include "RateFactory.h"
 #include "core/utils/macros.h"
+#include "core/utils/Names.h"
 #include "core/simulation/Cell.h"
 
 CellStateFactory::CellStateFactory(const std::unique_ptr<abm::util::SimulationParameters::SiteParameters> &site_parameters,
                                    RateFactory *rate_factory) {
     for (const auto &agent : site_parameters->agent_manager_parameters.agents) {
-        StateSetup state_setup{};
+        std::map<std::string, std::map<std::string, const Rate *>> state_setup{};
         for (const auto &state : agent->states) {
             state_setup[state.name] = {};
             for (const auto&[next_state, rate_name] : state.next_states) {
                 state_setup[state.name].emplace(next_state, rate_factory->getRate(rate_name));
             }
         }
-        next_states[std::make_pair(site_parameters->identifier, agent->type)] = state_setup;
-    }
-}
 
-std::shared_ptr<CellState> CellStateFactory::createCellState(Cell *cell, const std::string &state_name) {
-    return std::make_shared<CellState>(state_name,
-                                       cell,
-                                       CellStateFactory::getNextStates(state_name, cell->getSite()->getIdentifier(),
-                                                                       cell->getTypeName()));
+        // Names are interned once, the transitions keep the order of the names (i.e. random draws stay the same)
+        StateTable table{};
+        for (const auto&[state, next_states] : state_setup) {
+            StateTransitions transitions{};
+            for (const auto&[next_state, rate] : next_states) {
+                transitions.emplace_back(abm::util::Names::intern(next_state), rate);
+            }
+            const auto state_id = abm::util::Names::intern(state);
+            if (state_id >= static_cast<int>(table.slots.size())) table.slots.resize(state_id + 1, -1);
+            table.slots[state_id] = static_cast<int>(table.states.size());
+            table.states.emplace_back(state_id, std::move(transitions));
+        }
+        state_tables_[std::make_pair(site_parameters->identifier, agent->type)] = std::move(table);
+    }
 }
 
-std::map<std::string, const Rate *> CellStateFactory::getNextStates(const std::string &state_name,
-                                                                    const std::string &site_identifier,
-                                                                    const std::string &agent_type) {
-    if (auto result_pair = next_states.find(std::make_pair(site_identifier, agent_type)); result_pair !=
-                                                                                          next_states.end()) {
-        if (auto state_pair = result_pair->second.find(state_name); state_pair != result_pair->second.end()) {
-            return state_pair->second;
-        }
-        return {};
+std::shared_ptr<CellState> CellStateFactory::createCellState(Cell *cell, int state_id) {
+    const auto &table = getStateTable(cell->getSite()->getIdentifier(), cell->getTypeName());
+    if (const auto slot = table.getSlot(state_id); slot >= 0) {
+        return std::make_shared<CellState>(state_id, cell, table.states[slot].second);
     }
-    ERROR_STDERR("Agent Type " << agent_type << " does not exist.");
-    exit(1);
+    return std::make_shared<CellState>(state_id, cell, StateTransitions{});
 }
 
-CellStateFactory::StateSetup &
-CellStateFactory::getStateSetup(const std::string &site_identifier, const std::string &agent_type) {
-    if (auto result_pair = next_states.find(std::make_pair(site_identifier, agent_type)); result_pair !=
-                                                                                          next_states.end()) {
+const CellStateFactory::StateTable &
+CellStateFactory::getStateTable(const std::string &site_identifier, const std::string &agent_type) {
+    if (auto result_pair = state_tables_.find(std::make_pair(site_identifier, agent_type)); result_pair !=
+                                                                                            state_tables_.end()) {
         return result_pair->second;
     }
     ERROR_STDERR("Agent Type " << agent_type << " does not exist.");
@@ -18,21 +18,31 @@ class CellState;
 class Cell;
 class Rate;
 
+/// Transitions of a state as pairs of the name id of the next state and its rate, ordered by the next state name
+using StateTransitions = std::vector<std::pair<int, const Rate *>>;
+
 class CellStateFactory {
-    using StateSetup = std::map<std::string, std::map<std::string, const Rate *>>;
 public:
     // Factory class for initializing all possible cell states according to the simulator configuration
+    struct StateTable {
+        // Compiled states of an agent type in order of their names, the slot of a state is found by its name id
+        std::vector<std::pair<int, StateTransitions>> states{};
+        std::vector<int> slots{};
+
+        /// Returns the index of a state in states (-1 if the agent type has no such state)
+        [[nodiscard]] int getSlot(int state_id) const {
+            return state_id >= 0 && state_id < static_cast<int>(slots.size()) ? slots[state_id] : -1;
+        }
+    };
+
     CellStateFactory(const std::unique_ptr<abm::util::SimulationParameters::SiteParameters> &site_parameters,
                      RateFactory *rate_factory);
 
-    std::shared_ptr<CellState> createCellState(Cell *cell, const std::string &state_name);
-    StateSetup &getStateSetup(const std::string &site_identifier, const std::string &agent_type);
+    std::shared_ptr<CellState> createCellState(Cell *cell, int state_id);
+    const StateTable &getStateTable(const std::string &site_identifier, const std::string &agent_type);
 
 private:
-    std::map<std::string, const Rate *> getNextStates(const std::string &stae_name,
-                                                             const std::string &site_identifier,
-                                                             const std::string &agent_type);
-    std::map<std::pair<std::string, std::string>, StateSetup> next_states;
+    std::map<std::pair<std::string, std::string>, StateTable> state_tables_;
 
 };
 
@@ -19,22 +19,64 @@
 #include "core/simulation/cells/interaction/PhagocyteFungusInteraction.h"
 
 #include "core/utils/macros.h"
+#include "core/utils/RunArena.h"
 
 InteractionFactory::InteractionFactory(
         const std::vector<std::unique_ptr<abm::util::SimulationParameters::InteractionParameters>> &interaction_parameters, bool use_interactions) {
 
+    std::map<std::string, std::string> interaction_types;
+    std::map<std::string, std::vector<std::pair<std::string, std::vector<std::string>>>> interaction_conditions;
+    std::map<std::pair<std::string, std::string>, std::string> interaction_pair_types;
     if (use_interactions) {
         for (const auto &interaction: interaction_parameters) {
             if (!interaction->cell_conditions.empty()) {
                 const auto &cell1 = interaction->cell_conditions[0].first;
                 const auto &cell2 = interaction->cell_conditions[1].first;
-                interaction_pair_types_[std::make_pair(cell1, cell2)] = interaction->name;
-                interaction_pair_types_[std::make_pair(cell2, cell1)] = interaction->name;
-                interaction_conditions_[interaction->name] = interaction->cell_conditions;
+                interaction_pair_types[std::make_pair(cell1, cell2)] = interaction->name;
+                interaction_pair_types[std::make_pair(cell2, cell1)] = interaction->name;
+                interaction_conditions[interaction->name] = interaction->cell_conditions;
             }
-            interaction_types_[interaction->name] = interaction->type;
+            interaction_types[interaction->name] = interaction->type;
         }
     }
+    interactions_on_ = !(interaction_types.empty() && interaction_pair_types.empty());
+
+    const auto kind = [](const std::string &type) {
+        if (type == "IdenticalCellsInteraction") return InteractionKind::IdenticalCells;
+        if (type == "NoInteraction") return InteractionKind::NoInteraction;
+        if (type == "PhagocyteFungusInteraction") return InteractionKind::PhagocyteFungus;
+        return InteractionKind::Unknown;
+    };
+    const auto type_slot = [this](const std::string &type) {
+        const auto type_id = abm::util::Names::intern(type);
+        if (type_id >= static_cast<int>(type_slots_.size())) type_slots_.resize(type_id + 1, -1);
+        if (type_slots_[type_id] < 0) type_slots_[type_id] = number_of_types_++;
+        return type_slots_[type_id];
+    };
+
+    identical_cells_rule_.identifier = abm::util::Names::intern("IdenticalCellsInteraction");
+    identical_cells_rule_.kind = InteractionKind::IdenticalCells;
+    std::map<std::string, int> rule_indices;
+    for (const auto &[name, conditions]: interaction_conditions) {
+        InteractionRule rule{abm::util::Names::intern(name), kind(interaction_types[name]), {}};
+        for (const auto &[cell_type, states]: conditions) {
+            StateCondition condition{abm::util::Names::intern(cell_type), !states.empty(), {}};
+            for (const auto &state: states) {
+                condition.states.set(abm::util::Names::intern(state));
+            }
+            rule.conditions.emplace_back(std::move(condition));
+        }
+        rule_indices[name] = static_cast<int>(rules_.size());
+        rules_.emplace_back(std::move(rule));
+    }
+    std::vector<std::tuple<int, int, int>> pairs;
+    for (const auto &[types, name]: interaction_pair_types) {
+        pairs.emplace_back(type_slot(types.first), type_slot(types.second), rule_indices.at(name));
+    }
+    pair_rules_.assign(number_of_types_ * number_of_types_, -1);
+    for (const auto &[slot_1, slot_2, rule]: pairs) {
+        pair_rules_[slot_1 * number_of_types_ + slot_2] = rule;
+    }
 }
 
 std::shared_ptr<Interaction> InteractionFactory::createInteraction(double time_delta,
@@ -45,15 +87,22 @@ std::shared_ptr<Interaction> InteractionFactory::createInteraction(double time_d
     const auto &cell_1 = collision->getCell();
     const auto &cell_2 = collision->getCollisionCell();
     if (!(cell_2->isDeleted())) {
-        const auto[interaction_name, identifier] = retrieveInteractionIdentifier(cell_1, cell_2);
-        if (interaction_name == "IdenticalCellsInteraction") {
-            interaction = std::make_shared<IdenticalCellsInteraction>(identifier, cell_1, cell_2, time_delta,
-                                                                      current_time);
-        } else if (interaction_name == "NoInteraction") {
-            interaction = std::make_shared<NoInteraction>(identifier, cell_1, cell_2, time_delta, current_time);
-        } else if (interaction_name == "PhagocyteFungusInteraction") {
-            interaction = std::make_shared<PhagocyteFungusInteraction>(identifier, cell_1, cell_2, time_delta,
-                                                                       current_time);
+        const auto &rule = retrieveInteractionRule(cell_1, cell_2);
+        const auto &identifier = abm::util::Names::get(rule.identifier);
+        switch (rule.kind) {
+            case InteractionKind::IdenticalCells:
+                interaction = abm::util::makeShared<IdenticalCellsInteraction>(identifier, cell_1, cell_2, time_delta,
+                                                                          current_time);
+                break;
+            case InteractionKind::NoInteraction:
+                interaction = abm::util::makeShared<NoInteraction>(identifier, cell_1, cell_2, time_delta, current_time);
+                break;
+            case InteractionKind::PhagocyteFungus:
+                interaction = abm::util::makeShared<PhagocyteFungusInteraction>(identifier, cell_1, cell_2, time_delta,
+                                                                           current_time);
+                break;
+            case InteractionKind::Unknown:
+                break;
         }
         if (interaction != nullptr) {
             interaction->addCurrentCollision(collision);
@@ -66,10 +115,11 @@ std::shared_ptr<Interaction> InteractionFactory::createAvoidanceInteraction(Cell
                                                                             std::shared_ptr<Collision> collision,
                                                                             double time_delta,
                                                                             double current_time) {
+    static const std::string avoidance_interaction = "AvoidanceInteraction";
     std::shared_ptr<Interaction> interaction = nullptr;
     const auto &cell_2 = collision->getCollisionCell();
     if (!(cell_2->isDeleted())) {
-        interaction = std::make_shared<AvoidanceInteraction>("AvoidanceInteraction",
+        interaction = abm::util::makeShared<AvoidanceInteraction>(avoidance_interaction,
                                                              cell_1,
                                                              cell_2,
                                                              time_delta,
@@ -80,47 +130,37 @@ std::shared_ptr<Interaction> InteractionFactory::createAvoidanceInteraction(Cell
     return interaction;
 }
 
-std::tuple<std::string, std::string> InteractionFactory::retrieveInteractionIdentifier(Cell *cell_1, Cell *cell_2) {
-    std::string interaction_identifier{};
-    std::string interaction_type{};
+int InteractionFactory::getTypeSlot(int type_id) const {
+    return type_id >= 0 && type_id < static_cast<int>(type_slots_.size()) ? type_slots_[type_id] : -1;
+}
 
-    std::string type_cell_1 = cell_1->getTypeName();
-    std::string type_cell_2 = cell_2->getTypeName();
-    if (const auto &pair = interaction_pair_types_.find(std::make_pair(type_cell_1, type_cell_2)); pair !=
-                                                                                                   interaction_pair_types_.end()) {
-        bool condition_cell_1 = true;
-        bool condition_cell_2 = true;
-        for (const auto &condition : interaction_conditions_[pair->second]) {
-            if (type_cell_1 == condition.first) {
-                if (!condition.second.empty()) {
-                    condition_cell_1 = false;
-                    for (const auto &state: condition.second) {
-                        if (cell_1->getCurrentCellState()->getStateName() == state) {
-                            condition_cell_1 = true;
-                        }
+const InteractionFactory::InteractionRule &InteractionFactory::retrieveInteractionRule(Cell *cell_1, Cell *cell_2) const {
+    const auto type_cell_1 = cell_1->getTypeId();
+    const auto type_cell_2 = cell_2->getTypeId();
+    const auto slot_1 = getTypeSlot(type_cell_1);
+    const auto slot_2 = getTypeSlot(type_cell_2);
+    if (slot_1 >= 0 && slot_2 >= 0) {
+        if (const auto rule_index = pair_rules_[slot_1 * number_of_types_ + slot_2]; rule_index >= 0) {
+            const auto &rule = rules_[rule_index];
+            bool condition_cell_1 = true;
+            bool condition_cell_2 = true;
+            for (const auto &condition : rule.conditions) {
+                if (type_cell_1 == condition.cell_type) {
+                    if (condition.restricted) {
+                        condition_cell_1 = condition.states.test(cell_1->getCurrentCellState()->getStateId());
                     }
-                }
-            } else if (type_cell_2 == condition.first) {
-                if (!condition.second.empty()) {
-                    condition_cell_2 = false;
-                    for (const auto &state: condition.second) {
-                        if (cell_2->getCurrentCellState()->getStateName() == state) {
-                            condition_cell_2 = true;
-                        }
+                } else if (type_cell_2 == condition.cell_type) {
+                    if (condition.restricted) {
+                        condition_cell_2 = condition.states.test(cell_2->getCurrentCellState()->getStateId());
                     }
                 }
             }
+            if (condition_cell_1 && condition_cell_2) {
+                return rule;
+            }
         }
-        if (condition_cell_1 && condition_cell_2) {
-            interaction_identifier = pair->second;
-            interaction_type = interaction_types_[pair->second];
-        }
-    }
-    if (interaction_identifier.empty()) {
-        interaction_identifier = "IdenticalCellsInteraction";
-        interaction_type = "IdenticalCellsInteraction";
     }
-    return std::forward_as_tuple(interaction_type, interaction_identifier);
+    return identical_cells_rule_;
 }
 
 unsigned int InteractionFactory::generateInteractionId() {
@@ -128,5 +168,5 @@ unsigned int InteractionFactory::generateInteractionId() {
 }
 
 bool InteractionFactory::isInteractionsOn() {
-    return !(InteractionFactory::interaction_types_.empty() && InteractionFactory::interaction_pair_types_.empty());
+    return interactions_on_;
 }
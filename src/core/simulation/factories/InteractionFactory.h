@@ -11,12 +11,14 @@
 #ifndef CORE_SIMULATION_INTERACTIONFACTORY_H
 #define CORE_SIMULATION_INTERACTIONFACTORY_H
 
+#include <bitset>
 #include <memory>
 #include <utility>
 #include <map>
 
 #include "core/simulation/Interaction.h"
 #include "core/analyser/Analyser.h"
+#include "core/utils/Names.h"
 
 class Collision;
 class Cell;
@@ -28,6 +30,8 @@ public:
             const std::vector<std::unique_ptr<abm::util::SimulationParameters::InteractionParameters>> &interaction_parameters, bool use_interactions);
 
     unsigned int generateInteractionId();
+    /// Id of the next interaction, it changes whenever an interaction is created
+    [[nodiscard]] unsigned int getNextInteractionId() const { return interaction_id_; };
 
     std::shared_ptr<Interaction> createInteraction(double time_delta,
                                                           double current_time,
@@ -40,11 +44,31 @@ public:
     bool isInteractionsOn();
 
 private:
-    std::tuple<std::string, std::string> retrieveInteractionIdentifier(Cell *cell_1, Cell *cell_2);
+    // Interactions of the configuration compiled at setup, the rule of a pair of agent types is found by the name ids
+    // of the types and the allowed states of a cell are a bitset over the name ids
+    enum class InteractionKind {
+        IdenticalCells, NoInteraction, PhagocyteFungus, Unknown
+    };
+    struct StateCondition {
+        int cell_type{};
+        bool restricted{};
+        std::bitset<abm::util::Names::max_number_of_names> states{};
+    };
+    struct InteractionRule {
+        int identifier{};
+        InteractionKind kind{};
+        std::vector<StateCondition> conditions{};
+    };
+
+    const InteractionRule &retrieveInteractionRule(Cell *cell_1, Cell *cell_2) const;
+    int getTypeSlot(int type_id) const;
     unsigned int interaction_id_;
-    std::map<std::string, std::string> interaction_types_;
-    std::map<std::string, std::vector<std::pair<std::string, std::vector<std::string>>>> interaction_conditions_;
-    std::map<std::pair<std::string, std::string>, std::string> interaction_pair_types_;
+    bool interactions_on_{};
+    std::vector<InteractionRule> rules_;
+    InteractionRule identical_cells_rule_;
+    std::vector<int> type_slots_;
+    int number_of_types_{};
+    std::vector<int> pair_rules_;
 };
 
 #endif /* CORE_SIMULATION_INTERACTIONFACTORY_H */
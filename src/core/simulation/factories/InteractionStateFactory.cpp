@@ -18,11 +18,18 @@
 #include "core/simulation/Interaction.h"
 #include "core/simulation/rates/Rate.h"
 #include "core/utils/macros.h"
+#include "core/utils/Names.h"
 #include "RateFactory.h"
 #include "apps/alveolus/interactiontypes/PiercingOfImmuneCell.h"
 
+struct InteractionStateFactory::StateSetup {
+    InteractionTypeVariant type;
+    StateTransitions next_states;
+};
+
 InteractionStateFactory::InteractionStateFactory(const std::vector<std::unique_ptr<abm::util::SimulationParameters::InteractionParameters>> &interaction_parameters,
                                                  RateFactory *rate_factory) {
+    std::map<std::string, std::map<std::string, std::pair<InteractionTypeVariant, std::map<std::string, const Rate *>>>> state_parameters;
     for (const auto &parameters: interaction_parameters) {
         for (const auto &state: parameters->states) {
             std::map<std::string, const Rate *> state_setup;
@@ -30,35 +37,59 @@ InteractionStateFactory::InteractionStateFactory(const std::vector<std::unique_p
                 state_setup.emplace(next_state, rate_factory->getRate(rate_name));
             }
             if (state.interaction_type == "InteractionType") {
-                state_parameters_[parameters->name].emplace(state.name, std::make_pair(InteractionType(),
-                                                                                       std::move(state_setup)));
+                state_parameters[parameters->name].emplace(state.name, std::make_pair(InteractionType(),
+                                                                                      std::move(state_setup)));
             } else if (state.interaction_type == "Contacting") {
-                state_parameters_[parameters->name].emplace(state.name,
-                                                            std::make_pair(
-                                                                    Contacting(state.adhere, state.must_overhead),
-                                                                    std::move(state_setup)));
+                state_parameters[parameters->name].emplace(state.name,
+                                                           std::make_pair(
+                                                                   Contacting(state.adhere, state.must_overhead),
+                                                                   std::move(state_setup)));
             } else if (state.interaction_type == "RigidContacting") {
-                state_parameters_[parameters->name].emplace(state.name,
-                                                            std::make_pair(RigidContacting(state.must_overhead),
-                                                                           std::move(state_setup)));
+                state_parameters[parameters->name].emplace(state.name,
+                                                           std::make_pair(RigidContacting(state.must_overhead),
+                                                                          std::move(state_setup)));
             } else if (state.interaction_type == "Ingestion") {
-                state_parameters_[parameters->name].emplace(state.name,
-                                                            std::make_pair(Ingestion(), std::move(state_setup)));
+                state_parameters[parameters->name].emplace(state.name,
+                                                           std::make_pair(Ingestion(), std::move(state_setup)));
             } else if (state.interaction_type == "PiercingOfImmuneCell") {
-                state_parameters_[parameters->name].emplace(state.name,
-                                                            std::make_pair(PiercingOfImmuneCell(), std::move(state_setup)));
+                state_parameters[parameters->name].emplace(state.name,
+                                                           std::make_pair(PiercingOfImmuneCell(), std::move(state_setup)));
             }
         }
     }
 
+    // Names are interned once, the transitions keep the order of the names (i.e. random draws stay the same)
+    for (const auto &[identifier, states]: state_parameters) {
+        const auto identifier_id = abm::util::Names::intern(identifier);
+        if (identifier_id >= static_cast<int>(state_setups_.size())) state_setups_.resize(identifier_id + 1);
+        for (const auto &[state, setup]: states) {
+            const auto &[type, next_states] = setup;
+            StateTransitions transitions{};
+            for (const auto &[next_state, rate]: next_states) {
+                transitions.emplace_back(abm::util::Names::intern(next_state), rate);
+            }
+            const auto state_id = abm::util::Names::intern(state);
+            auto &setups = state_setups_[identifier_id];
+            if (state_id >= static_cast<int>(setups.size())) setups.resize(state_id + 1);
+            setups[state_id] = std::make_shared<const StateSetup>(StateSetup{type, std::move(transitions)});
+        }
+    }
 }
 
 std::unique_ptr<InteractionState> InteractionStateFactory::createInteractionState(Interaction *interaction,
-                                                                                  std::string interactionStateType,
+                                                                                  int interaction_state,
                                                                                   Cell *cell1,
                                                                                   Cell *cell2) {
-    std::string identifier = interaction->getIdentifier();
-    const auto&[type, next_states] = state_parameters_.at(identifier).at(interactionStateType);
+    static const int immune_cell = abm::util::Names::intern("ImmuneCell");
+    const auto identifier = interaction->getIdentifierId();
+    if (identifier < 0 || identifier >= static_cast<int>(state_setups_.size()) || interaction_state < 0 ||
+        interaction_state >= static_cast<int>(state_setups_[identifier].size()) ||
+        state_setups_[identifier][interaction_state] == nullptr) {
+        ERROR_STDERR("Interaction state " << abm::util::Names::get(interaction_state) << " of "
+                                          << interaction->getIdentifier() << " does not exist.");
+        exit(1);
+    }
+    const auto&[type, next_states] = *state_setups_[identifier][interaction_state];
     const auto clone = abm::util::overloaded{
             [&](InteractionType type) -> std::unique_ptr<InteractionType> {
                 return std::make_unique<InteractionType>(type);
@@ -72,16 +103,15 @@ std::unique_ptr<InteractionState> InteractionStateFactory::createInteractionStat
 
     };
 
-    std::unique_ptr<InteractionState>
-            intState = std::make_unique<InteractionState>(interactionStateType, interaction, std::visit(clone, type),
-                                                          next_states.empty());
+    // Ingestions are never end states
+    const bool ingestion = std::holds_alternative<Ingestion>(type);
+    auto intState = std::make_unique<InteractionState>(interaction_state, interaction, std::visit(clone, type),
+                                                       next_states.empty() && !ingestion);
 
-    if (intState->getInteractionType() == "Ingestion") {
-        intState = std::make_unique<InteractionState>(interactionStateType, interaction, std::visit(clone, type),
-                                                      false);
-        if (abm::util::isSubstring("ImmuneCell", interaction->getFirstCell()->getTypeName())) {
+    if (ingestion) {
+        if (abm::util::Names::related(immune_cell, interaction->getFirstCell()->getTypeId())) {
             interaction->getFirstCell()->addIngestions(interaction->getSecondCell()->getId());
-        } else if (abm::util::isSubstring("ImmuneCell", interaction->getSecondCell()->getTypeName())) {
+        } else if (abm::util::Names::related(immune_cell, interaction->getSecondCell()->getTypeId())) {
             interaction->getSecondCell()->addIngestions(interaction->getFirstCell()->getId());
         }
     }
@@ -90,4 +120,3 @@ std::unique_ptr<InteractionState> InteractionStateFactory::createInteractionStat
 
     return intState;
 }
-
@@ -23,7 +23,8 @@ class RigidContacting;
 
 class InteractionStateFactory {
 
-    using StateSetup = std::map<std::string, std::pair<std::variant<InteractionType, Contacting, RigidContacting, Ingestion, PiercingOfImmuneCell>, std::map<std::string, const Rate *>>>;
+    using InteractionTypeVariant = std::variant<InteractionType, Contacting, RigidContacting, Ingestion, PiercingOfImmuneCell>;
+    struct StateSetup;
 
 public:
   // Factory class for all interactions states between cells.  These can either be: Contacting, Ingestion, RigidContacting or InteractionType (Default).
@@ -32,12 +33,12 @@ public:
                             RateFactory *rate_factory);
 
     std::unique_ptr<InteractionState> createInteractionState(Interaction *interaction,
-                                                                    std::string interactionStateType,
+                                                                    int interaction_state,
                                                                     Cell *cell1, Cell *cell2);
 
 private:
-
-    std::map<std::string, StateSetup> state_parameters_;
+    // Compiled states indexed by the name ids of the interaction identifier and of the state
+    std::vector<std::vector<std::shared_ptr<const StateSetup>>> state_setups_;
 };
 
 #endif /* CORE_SIMULATION_INTERACTIONSTATEFACTORY_H */
@@ -13,6 +13,7 @@
 #include "core/simulation/Cell.h"
 #include "core/simulation/Site.h"
 #include "core/simulation/Interactions.h"
+#include "core/utils/Names.h"
 
 
 void Ingestion::handleInteraction(Interaction *interaction, Cell *cell, double timestep, double current_time) {
@@ -56,9 +57,10 @@ void Ingestion::handleInteraction(Interaction *interaction, Cell *cell, double t
 }
 
 bool Ingestion::isIngestingType(Cell *cell) {
+    static const int immune_cell = abm::util::Names::intern("ImmuneCell");
     bool result = false;
 
-    if (abm::util::isSubstring("ImmuneCell", cell->getTypeName())) { result = true; }
+    if (abm::util::Names::related(immune_cell, cell->getTypeId())) { result = true; }
 
     return result;
 }
@@ -13,10 +13,12 @@
 
 #include <string>
 
+#include "core/utils/RunArena.h"
+
 class Cell;
 class Interaction;
 
-class InteractionType {
+class InteractionType : public abm::util::RunPooled {
 public:
   //  Default class for describing the interaction type of a cell-cell interaction.
     InteractionType() = default;
@@ -45,44 +45,27 @@ void Morphology::setColorRGB(std::unique_ptr<ColorRGB> col) {
 }
 
 void Morphology::appendAssociatedCellpart(std::unique_ptr<MorphologyElement> morphElement) {
-    morphologyElements.emplace_back(std::move(morphElement));
-}
-
-std::vector<SphereRepresentation *> Morphology::getAllSpheresOfThis() {
-    std::vector<SphereRepresentation *> allSpheresOfThisCell;
-
-    auto it = morphologyElements.begin();
-
-    while (it != morphologyElements.end()) {
-        std::vector<std::shared_ptr<SphereRepresentation>> sphereReps = (*it)->getSphereRepresentation();
-        for (const auto &ptr: sphereReps) {
-            allSpheresOfThisCell.emplace_back(ptr.get());
+    // Spheres of an element are generated on its construction, i.e. the lists only change when an element is appended
+    for (const auto &ptr: morphElement->getSphereRepresentation()) {
+        all_spheres_.emplace_back(ptr.get());
+        if (basic_sphere_ == nullptr && morphElement->getDescription() == "basic") {
+            basic_sphere_ = ptr.get();
         }
-        it++;
     }
-
-    return allSpheresOfThisCell;
+    morphologyElements.emplace_back(std::move(morphElement));
 }
 
-SphereRepresentation *Morphology::getBasicSphereOfThis() {
-    std::vector<SphereRepresentation *> allSpheresOfThisCell = getAllSpheresOfThis();
-    auto it = allSpheresOfThisCell.begin();
-    SphereRepresentation *basicSphere = 0;
-    while (it != allSpheresOfThisCell.end()) {
-        if ((*it)->getMorphologyElementThisBelongsTo()->getDescription() == "basic") {
-            basicSphere = *it;
-            break;
-        }
-        it++;
-    }
+const std::vector<SphereRepresentation *> &Morphology::getAllSpheresOfThis() const {
+    return all_spheres_;
+}
 
-    return basicSphere;
+SphereRepresentation *Morphology::getBasicSphereOfThis() const {
+    return basic_sphere_;
 }
 
 double Morphology::getVolume() {
     double volume = 0;
-    std::vector<SphereRepresentation *> spheres = getAllSpheresOfThis();
-    for (auto &sphere : spheres) {
+    for (auto &sphere : all_spheres_) {
         volume += (4 / 3) * M_PI * pow(sphere->getRadius(), 3);
     }
     return volume;
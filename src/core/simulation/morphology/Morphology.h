@@ -33,14 +33,17 @@ public:
     void setColorRGB(std::unique_ptr<ColorRGB> col);
     Cell *getCellThisBelongsTo() { return cell_this_belongs_to_; };
     void appendAssociatedCellpart(std::unique_ptr<MorphologyElement> morphElement);
-    std::vector<SphereRepresentation *> getAllSpheresOfThis();
-    SphereRepresentation *getBasicSphereOfThis();
+    /// Spheres of all elements in the order of their elements (the list is kept and only changes when appending)
+    const std::vector<SphereRepresentation *> &getAllSpheresOfThis() const;
+    SphereRepresentation *getBasicSphereOfThis() const;
     double getVolume();
 
 protected:
     std::unique_ptr<ColorRGB> color_rgb_{};
     std::list<std::unique_ptr<MorphologyElement>> morphologyElements;
     Cell *cell_this_belongs_to_{};
+    std::vector<SphereRepresentation *> all_spheres_{};
+    SphereRepresentation *basic_sphere_{};
 
 };
 
@@ -20,7 +20,7 @@ SphereRepresentation::SphereRepresentation(std::shared_ptr<Coordinate3D> coord,
                                            MorphologyElement *morphologyElement, std::string description, double creation_time) {
     this->position = coord;
     this->morphologyElementThisBelongsTo = morphologyElement;
-    this->radius = radius;
+    *this->radius = radius;
     this->radius_at_t0 = radius;
     this->description_ = description;
     this->creation_time_ = creation_time;
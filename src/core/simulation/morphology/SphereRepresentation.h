@@ -16,10 +16,11 @@
 
 #include "core/basic/Coordinate3D.h"
 #include "core/basic/ColorRGB.h"
+#include "core/utils/RunArena.h"
 
 class MorphologyElement;
 
-class SphereRepresentation {
+class SphereRepresentation : public abm::util::RunPooled {
 public:
   // Class for a spherical representation based on a spherical morphology.
     SphereRepresentation();
@@ -28,10 +29,12 @@ public:
 
     virtual ~SphereRepresentation();
     Coordinate3D getPosition() { return *position; };
-    double getRadius() { return radius; };
+    double getRadius() { return *radius; };
     double getRadiusAtT0() { return radius_at_t0; }
     double getCreationTime() { return creation_time_; }
-    void setRadius(double r) { radius = r; };
+    void setRadius(double r) { *radius = r; };
+    /// Moves the radius into external storage (the component store for the basic sphere of an agent)
+    void bindRadius(double *storage) { *storage = *radius; radius = storage; };
     void setRadiusAtT0(double r) { radius_at_t0 = r; };
     int getId() { return id; };
     std::string getDescription() { return description_; };
@@ -42,7 +45,8 @@ public:
 
 private:
     std::shared_ptr<Coordinate3D> position;
-    double radius;
+    double *radius{&detached_radius_};
+    double detached_radius_{};
     double radius_at_t0;
     double creation_time_;
     std::string description_;
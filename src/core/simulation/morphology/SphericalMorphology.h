@@ -13,8 +13,9 @@
 
 #include "MorphologyElement.h"
 #include "SphereRepresentation.h"
+#include "core/utils/RunArena.h"
 
-class SphericalMorphology : public MorphologyElement {
+class SphericalMorphology : public MorphologyElement, public abm::util::RunPooled {
 public:
   // Class for a spherical morphology
     SphericalMorphology();
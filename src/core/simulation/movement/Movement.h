@@ -12,9 +12,11 @@
 #define CORE_SIMULATION_MOVEMENT_H
 
 #include <memory>
+#include <typeinfo>
 
 #include "core/basic/Coordinate3D.h"
 #include "core/basic/Randomizer.h"
+#include "core/simulation/AgentComponents.h"
 
 
 class Site;
@@ -34,8 +36,12 @@ public:
     virtual double getSpeed() { return 0; }
     virtual double getStartingTime();
     virtual std::string getMovementName();
+    /// True for the plain movement of agents without a movement type, i.e. the agent is never shifted by it
+    [[nodiscard]] bool isStatic() const { return typeid(*this) == typeid(Movement); }
     virtual Coordinate3D *move(double, double diffusion_constant);
     virtual void annulatePersistence() {}
+    /// Moves the persistence (direction and time left) into the slot of the agent in the component store
+    virtual void attachComponents(AgentComponents &components, const AgentComponents::Handle &handle) {}
 
 protected:
     unsigned int spatial_dimensions_;
@@ -26,15 +26,14 @@ PersistentRandomWalk::PersistentRandomWalk(Agent* agent, double persistenceTime
 
   if (agent->getInitialTime() > 0.0) {
     persistence_time_start_ = 0;
-    persistence_time_left_ = site_->getRandomGenerator()->generateDouble() * persistenceTime;
+    *persistence_time_left_ = site_->getRandomGenerator()->generateDouble() * persistenceTime;
   } else {
     persistence_time_start_ = site_->getRandomGenerator()->generateDouble() * persistenceTime;
-    persistence_time_left_ = persistence_time_start_;
+    *persistence_time_left_ = persistence_time_start_;
   }
 
   current_velocity_ = std::make_unique<Coordinate3D>();
   this->speed_ = speed;
-  persistence_direction_ = std::make_unique<Coordinate3D>();
 }
 
 
@@ -63,7 +62,7 @@ Coordinate3D* PersistentRandomWalk::movePersistent(double timestep){
 
   }
 
-  return persistence_direction_.get();
+  return persistence_direction_;
 }
 
 Coordinate3D *PersistentRandomWalk::moveRandomly(double timestep) {
@@ -76,16 +75,16 @@ Coordinate3D *PersistentRandomWalk::moveRandomly(double timestep) {
 }
 
 void PersistentRandomWalk::decrementLeftTime(double timestep){
-  persistence_time_left_ -= timestep;
+  *persistence_time_left_ -= timestep;
 }
 
 void PersistentRandomWalk::setNewPersistence() {
   *persistence_direction_ = *current_velocity_;
-  persistence_time_left_ += persistence_time_;
+  *persistence_time_left_ += persistence_time_;
 }
 
 bool PersistentRandomWalk::persistentMove() const {
-  return (persistence_time_left_ > 0);
+  return (*persistence_time_left_ > 0);
 }
 
 double PersistentRandomWalk::getStartingTime(){
@@ -95,4 +94,11 @@ double PersistentRandomWalk::getStartingTime(){
 void PersistentRandomWalk::setPreviousMove(Coordinate3D *prevMove) {
   *persistence_direction_ = *prevMove;
   persistent_angle_alpha_2_d_ = site_->getLatestAlpha2dTurningAngle();
-}
\ No newline at end of file
+}
+
+void PersistentRandomWalk::attachComponents(AgentComponents &components, const AgentComponents::Handle &handle) {
+  components.direction(handle) = *persistence_direction_;
+  components.persistenceTimeLeft(handle) = *persistence_time_left_;
+  persistence_direction_ = &components.direction(handle);
+  persistence_time_left_ = &components.persistenceTimeLeft(handle);
+}
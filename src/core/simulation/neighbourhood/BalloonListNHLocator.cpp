@@ -8,6 +8,7 @@
 //  This code is licensed under BSD 2-Clause
 //  See the LICENSE file provided with this code for the full license.
 
+#include <array>
 #include <cmath>
 #include <cstdlib>
 
@@ -16,6 +17,7 @@
 #include "core/utils/macros.h"
 #include "core/simulation/AgentManager.h"
 #include "core/simulation/Site.h"
+#include "core/utils/RunArena.h"
 
 BalloonListNHLocator::BalloonListNHLocator(std::vector<std::shared_ptr<abm::util::SimulationParameters::AgentParameters>> agent_parameters, Coordinate3D lowerValues, Coordinate3D upperValues,
                                            Site *site) : NeighbourhoodLocator(site) {
@@ -44,51 +46,39 @@ void BalloonListNHLocator::instantiate(Site *site) {
     initialGridCreation();
 }
 
-std::vector<std::shared_ptr<Collision> > BalloonListNHLocator::getCollisions(Agent *agent) {
+void BalloonListNHLocator::getCollisions(Agent *agent, std::vector<std::shared_ptr<Collision>> &collisions) {
+    const auto lock = site_->lockSharedStructures();
+    collisions.clear();
 
-    std::vector<SphereRepresentation *>::iterator itCellsSpheres;
-    std::vector<SphereRepresentation *> currentCellsSpheres;
-    currentCellsSpheres.push_back(agent->getMorphology()->getBasicSphereOfThis());
-    itCellsSpheres = currentCellsSpheres.begin();
-    std::vector<std::shared_ptr<Collision>> neighbours;
-    SphereRepresentation *currentCellsSphere;
-
-    while (itCellsSpheres != currentCellsSpheres.end()) {
-
-        currentCellsSphere = *itCellsSpheres;
-        std::vector<int> agentGridPoint(3);
-        int u, v, w;
-
-        agentGridPoint = sphereRepresentationAllocator[currentCellsSphere];
+    SphereRepresentation *currentCellsSphere = agent->getMorphology()->getBasicSphereOfThis();
+    const auto &agentGridPoint = sphereRepresentationAllocator[currentCellsSphere];
+    int u, v, w;
 
-        u = agentGridPoint[0];
-        v = agentGridPoint[1];
-        w = agentGridPoint[2];
+    u = agentGridPoint[0];
+    v = agentGridPoint[1];
+    w = agentGridPoint[2];
 
-        int nHSize = 1; // check next nHSize neighbouring grid points
-        for (int i = u - nHSize; i <= u + nHSize; i++) {
-            if (i >= 0 && i < (gridSize[0])) {
-                for (int j = v - nHSize; j <= v + nHSize; j++) {
-                    if (j >= 0 && j < (gridSize[1])) {
-                        for (int k = w - nHSize; k <= w + nHSize; k++) {
-                            if (k >= 0 && k < (gridSize[2])) {
-                                checkCollisions(&neighbours, agent, currentCellsSphere, i, j, k);
-                            }
+    int nHSize = 1; // check next nHSize neighbouring grid points
+    for (int i = u - nHSize; i <= u + nHSize; i++) {
+        if (i >= 0 && i < (gridSize[0])) {
+            for (int j = v - nHSize; j <= v + nHSize; j++) {
+                if (j >= 0 && j < (gridSize[1])) {
+                    for (int k = w - nHSize; k <= w + nHSize; k++) {
+                        if (k >= 0 && k < (gridSize[2])) {
+                            checkCollisions(&collisions, agent, currentCellsSphere, i, j, k);
                         }
                     }
                 }
             }
         }
-        itCellsSpheres++;
     }
-    return neighbours;
 }
 
 void BalloonListNHLocator::updateDataStructures(SphereRepresentation *sphereRep) {
+    const auto lock = site_->lockSharedStructures();
 
-    if (sphereRepresentationAllocator.find(sphereRep) != sphereRepresentationAllocator.end()) {
-        std::vector<int> sphereGridPoint(3);
-        sphereGridPoint = sphereRepresentationAllocator[sphereRep];
+    if (auto itSphere = sphereRepresentationAllocator.find(sphereRep); itSphere != sphereRepresentationAllocator.end()) {
+        const auto &sphereGridPoint = itSphere->second;
         unsigned int uOld, vOld, wOld;
         uOld = sphereGridPoint[0];
         vOld = sphereGridPoint[1];
@@ -104,8 +94,16 @@ void BalloonListNHLocator::updateDataStructures(SphereRepresentation *sphereRep)
         if (uOld == u && vOld == v && wOld == w) {
             //do nothing
         } else {
-            removeSphereRepresentation(sphereRep);
-            addSphereRepresentation(sphereRep);
+            // Moves the sphere to the end of the list of its new grid point, its entry in the allocator is kept
+            auto &oldList = balloonList[uOld][vOld][wOld];
+            oldList.erase(remove(oldList.begin(), oldList.end(), sphereRep), oldList.end());
+            std::array<int, 3> position{};
+            if (getGridPoint(sphereRep, position)) {
+                balloonList[position[0]][position[1]][position[2]].push_back(sphereRep);
+                itSphere->second = position;
+            } else {
+                sphereRepresentationAllocator.erase(itSphere);
+            }
         }
     } else {
         DEBUG_STDOUT("The sphere is not yet in the system, can not do update");
@@ -113,11 +111,11 @@ void BalloonListNHLocator::updateDataStructures(SphereRepresentation *sphereRep)
 }
 
 void BalloonListNHLocator::removeSphereRepresentation(SphereRepresentation *sphereRep) {
+    const auto lock = site_->lockSharedStructures();
     std::vector<SphereRepresentation *>::iterator toDelete;
 
-    std::vector<int> sphereGridPoint(3);
-    if (sphereRepresentationAllocator.find(sphereRep) != sphereRepresentationAllocator.end()) {
-        sphereGridPoint = sphereRepresentationAllocator[sphereRep];
+    if (auto itSphere = sphereRepresentationAllocator.find(sphereRep); itSphere != sphereRepresentationAllocator.end()) {
+        const auto sphereGridPoint = itSphere->second;
         unsigned int u, v, w;
         u = sphereGridPoint[0];
         v = sphereGridPoint[1];
@@ -132,44 +130,47 @@ void BalloonListNHLocator::removeSphereRepresentation(SphereRepresentation *sphe
 }
 
 void BalloonListNHLocator::addSphereRepresentation(SphereRepresentation *sphereRep) {
+    const auto lock = site_->lockSharedStructures();
     if (sphereRepresentationAllocator.find(sphereRep) == sphereRepresentationAllocator.end()) {
-        std::vector<int> position(3);
+        std::array<int, 3> position{};
+        if (getGridPoint(sphereRep, position)) {
+            balloonList[position[0]][position[1]][position[2]].push_back(sphereRep);
 
-        int u, v, w;
-        Coordinate3D pos = sphereRep->getPosition();
-
-        u = (int) round((pos.x - lowerPoint.x) / gridConstant);
-        v = (int) round((pos.y - lowerPoint.y) / gridConstant);
-        w = (int) round((pos.z - lowerPoint.z) / gridConstant);
-
-        position[0] = u;
-        position[1] = v;
-        position[2] = w;
+            sphereRepresentationAllocator[sphereRep] = position;
+        }
+    }
+}
 
-        if (site_->getNumberOfSpatialDimensions() == 2) {
-            if (u >= gridSize[0] || v >= gridSize[1] || u < 0 || v < 0) {
-                ERROR_STDERR("Sphere's position is out of balloonlist-boundary area. "
-                             "Position: " << pos.printCoordinates());
-                exit(1);
-            } else {
-                balloonList[u][v][w].push_back(sphereRep);
+bool BalloonListNHLocator::getGridPoint(SphereRepresentation *sphereRep, std::array<int, 3> &position) {
+    int u, v, w;
+    Coordinate3D pos = sphereRep->getPosition();
 
-                sphereRepresentationAllocator[sphereRep] = position;
-            }
-        } else if (site_->getNumberOfSpatialDimensions() == 3) {
-            if (u >= gridSize[0] || v >= gridSize[1] || w >= gridSize[2] ||
-                u < 0 || v < 0 || w < 0) {
-                ERROR_STDERR("Sphere's position is out of balloonlist-boundary area. "
-                             "Position: (" << pos.x << ", " << pos.y << ", " << pos.z << ")");
+    u = (int) round((pos.x - lowerPoint.x) / gridConstant);
+    v = (int) round((pos.y - lowerPoint.y) / gridConstant);
+    w = (int) round((pos.z - lowerPoint.z) / gridConstant);
 
-                exit(1);
-            } else {
-                balloonList[u][v][w].push_back(sphereRep);
+    position[0] = u;
+    position[1] = v;
+    position[2] = w;
 
-                sphereRepresentationAllocator[sphereRep] = position;
-            }
+    if (site_->getNumberOfSpatialDimensions() == 2) {
+        if (u >= gridSize[0] || v >= gridSize[1] || u < 0 || v < 0) {
+            ERROR_STDERR("Sphere's position is out of balloonlist-boundary area. "
+                         "Position: " << pos.printCoordinates());
+            exit(1);
         }
+        return true;
+    } else if (site_->getNumberOfSpatialDimensions() == 3) {
+        if (u >= gridSize[0] || v >= gridSize[1] || w >= gridSize[2] ||
+            u < 0 || v < 0 || w < 0) {
+            ERROR_STDERR("Sphere's position is out of balloonlist-boundary area. "
+                         "Position: (" << pos.x << ", " << pos.y << ", " << pos.z << ")");
+
+            exit(1);
+        }
+        return true;
     }
+    return false;
 }
 
 void BalloonListNHLocator::initialGridCreation() {
@@ -190,11 +191,12 @@ void BalloonListNHLocator::initialGridCreation() {
             for (int k = 0; k < nz; k++) {
                 std::vector<SphereRepresentation *> currZVector;
                 currZVector.reserve(10);
-                currYVector.push_back(currZVector);
+                // Moved instead of copied, a copy would drop the reserved capacity
+                currYVector.push_back(std::move(currZVector));
             }
-            currXVector.push_back(currYVector);
+            currXVector.push_back(std::move(currYVector));
         }
-        balloonList.push_back(currXVector);
+        balloonList.push_back(std::move(currXVector));
     }
 }
 
@@ -217,7 +219,7 @@ bool BalloonListNHLocator::checkCollisions(std::vector<std::shared_ptr<Collision
                 if (distance <= minDistance) {
                     returnVal = true;
                     if (!justCheck) {
-                        collisions->push_back(std::make_shared<Collision>(collisionCell, sphereRep, currNeighbour,
+                        collisions->push_back(abm::util::makeShared<Collision>(collisionCell, sphereRep, currNeighbour,
                                                             (minDistance - distance)));
                     }
                 }
@@ -228,64 +230,65 @@ bool BalloonListNHLocator::checkCollisions(std::vector<std::shared_ptr<Collision
 }
 
 bool BalloonListNHLocator::hasCollision(Agent *agent) {
-    bool hasOneCollision = false;
-    std::string agentName = agent->getTypeName();
-    std::vector<SphereRepresentation *>::iterator itCellsSpheres;
-    std::vector<SphereRepresentation *> currentCellsSpheres;
-    currentCellsSpheres.push_back(agent->getMorphology()->getBasicSphereOfThis());
-    itCellsSpheres = currentCellsSpheres.begin();
-    std::vector<std::shared_ptr<Collision>> neighbours;
-    SphereRepresentation *currentCellsSphere;
-
-    while (itCellsSpheres != currentCellsSpheres.end()) {
-
-        currentCellsSphere = *itCellsSpheres;
-        std::vector<int> agentGridPoint(3);
-        int u, v, w;
-
-        agentGridPoint = sphereRepresentationAllocator[currentCellsSphere];
+    const auto lock = site_->lockSharedStructures();
+    SphereRepresentation *currentCellsSphere = agent->getMorphology()->getBasicSphereOfThis();
+    const auto &agentGridPoint = sphereRepresentationAllocator[currentCellsSphere];
+    int u, v, w;
 
-        u = agentGridPoint[0];
-        v = agentGridPoint[1];
-        w = agentGridPoint[2];
+    u = agentGridPoint[0];
+    v = agentGridPoint[1];
+    w = agentGridPoint[2];
 
-        int nHSize = 1; // check next nHSize neighbouring grid points
-        for (int i = u - nHSize; i <= u + nHSize; i++) {
-            if (i >= 0 && i < ((int) gridSize[0])) {
-                for (int j = v - nHSize; j <= v + nHSize; j++) {
-                    if (j >= 0 && j < ((int) gridSize[1])) {
-                        for (int k = w - nHSize; k <= w + nHSize; k++) {
-                            if (k >= 0 && k < ((int) gridSize[2])) {
-                                if ((hasOneCollision = checkCollisions(&neighbours, agent, currentCellsSphere, i, j, k, true))) {
-                                    break;
-                                }
+    int nHSize = 1; // check next nHSize neighbouring grid points
+    for (int i = u - nHSize; i <= u + nHSize; i++) {
+        if (i >= 0 && i < ((int) gridSize[0])) {
+            for (int j = v - nHSize; j <= v + nHSize; j++) {
+                if (j >= 0 && j < ((int) gridSize[1])) {
+                    for (int k = w - nHSize; k <= w + nHSize; k++) {
+                        if (k >= 0 && k < ((int) gridSize[2])) {
+                            if (checkCollisions(nullptr, agent, currentCellsSphere, i, j, k, true)) {
+                                return true;
                             }
                         }
                     }
-                    if (hasOneCollision) {
-                        break;
-                    }
                 }
             }
-            if (hasOneCollision) {
-                break;
-            }
-        }
-        if (hasOneCollision) {
-            break;
         }
-        itCellsSpheres++;
     }
+    return false;
+}
 
-    return hasOneCollision;
+bool BalloonListNHLocator::hasCollision(const Coordinate3D &position, double radius) {
+    const auto lock = site_->lockSharedStructures();
+    // The grid constant is the largest bounding diameter of the agent types, i.e. spheres in reach of the candidate are
+    // at most (radius + largest bounding radius) away from it. Positions outside of the grid are not checked here.
+    const int u = (int) round((position.x - lowerPoint.x) / gridConstant);
+    const int v = (int) round((position.y - lowerPoint.y) / gridConstant);
+    const int w = (int) round((position.z - lowerPoint.z) / gridConstant);
+    const auto agent_manager = site_->getAgentManager();
+    const int nHSize = std::max(1, (int) ceil((radius + 0.5 * gridConstant) / gridConstant));
+    for (int i = std::max(u - nHSize, 0); i <= std::min(u + nHSize, gridSize[0] - 1); i++) {
+        for (int j = std::max(v - nHSize, 0); j <= std::min(v + nHSize, gridSize[1] - 1); j++) {
+            for (int k = std::max(w - nHSize, 0); k <= std::min(w + nHSize, gridSize[2] - 1); k++) {
+                for (auto neighbour: balloonList[i][j][k]) {
+                    const Cell *cell = agent_manager->getCellBySphereRepId(neighbour->getId());
+                    if (cell != nullptr && !cell->isDeleted() &&
+                        position.calculateEuclidianDistance(neighbour->getPosition()) <= radius + neighbour->getRadius()) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
 }
 
 std::vector<Coordinate3D>
 BalloonListNHLocator::getCollisionSpheres(SphereRepresentation *sphereRep, Coordinate3D dirVec) {
+    const auto lock = site_->lockSharedStructures();
     std::vector<Coordinate3D> collisionPositions;
     std::vector<std::shared_ptr<Collision>> neighbours;
     SphereRepresentation *currentCellsSphere = sphereRep;
-    std::vector<int> agentGridPoint(3);
 
     double newl = ((currentCellsSphere->getRadius()) / dirVec.getMagnitude());
     Coordinate3D sphpos = currentCellsSphere->getPosition();
@@ -293,7 +296,7 @@ BalloonListNHLocator::getCollisionSpheres(SphereRepresentation *sphereRep, Coord
 
     int u, v, w;
 
-    agentGridPoint = sphereRepresentationAllocator[currentCellsSphere];
+    const auto &agentGridPoint = sphereRepresentationAllocator[currentCellsSphere];
 
     u = (int) agentGridPoint[0];
     v = (int) agentGridPoint[1];
@@ -339,6 +342,7 @@ std::string BalloonListNHLocator::getTypeName() {
 }
 
 int BalloonListNHLocator::getNumberOfAgentTypeInBalloonList(std::string agentType) {
+    const auto lock = site_->lockSharedStructures();
     int count = 0;
     for (size_t i1 = 0; i1 < balloonList.size(); i1++) {
         for (size_t i2 = 0; i2 < balloonList[i1].size(); i2++) {
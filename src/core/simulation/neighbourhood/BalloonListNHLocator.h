@@ -11,6 +11,7 @@
 #ifndef CORE_SIMULATION_BALLOONLISTNHLOCATOR_H
 #define CORE_SIMULATION_BALLOONLISTNHLOCATOR_H
 
+#include <array>
 #include <map>
 #include <boost/thread/condition_variable.hpp>
 
@@ -41,7 +42,8 @@ public:
 
     int controlFunction() final;
     bool hasCollision(Agent *agent) final;
-    std::vector<std::shared_ptr<Collision>> getCollisions(Agent *agent) final;
+    bool hasCollision(const Coordinate3D &position, double radius) final;
+    void getCollisions(Agent *agent, std::vector<std::shared_ptr<Collision>> &collisions) final;
     std::vector<Coordinate3D> getCollisionSpheres(SphereRepresentation *sphereRep, Coordinate3D dirVec) final;
     std::string getTypeName() final;
     double getGridConstant() {return gridConstant;};
@@ -50,7 +52,7 @@ public:
 private:
     double gridConstant;
     std::vector<std::vector<std::vector<std::vector<SphereRepresentation *> > > > balloonList;
-    std::map<SphereRepresentation *, std::vector<int> > sphereRepresentationAllocator;
+    std::map<SphereRepresentation *, std::array<int, 3> > sphereRepresentationAllocator;
     Coordinate3D lowerPoint;
     Coordinate3D upperPoint;
     int gridSize[3];
@@ -58,6 +60,8 @@ private:
     boost::condition_variable m_cond;
     int checksum;
     void initialGridCreation();
+    /// Grid point of a sphere, exits if it is outside of the grid (false if the site has no 2 or 3 dimensions)
+    bool getGridPoint(SphereRepresentation *sphereRep, std::array<int, 3> &position);
     bool checkCollisions(std::vector<std::shared_ptr<Collision> > *neighbours,Agent *agent,SphereRepresentation *sphereRep,
                          int u, int v, int w, bool justCheck = false);
 };
@@ -23,8 +23,8 @@ NeighbourhoodLocator::~NeighbourhoodLocator() {
 void NeighbourhoodLocator::instantiate() {
 }
 
-std::vector<std::shared_ptr<Collision>> NeighbourhoodLocator::getCollisions(Agent *agent) {
-    return {};
+void NeighbourhoodLocator::getCollisions(Agent *agent, std::vector<std::shared_ptr<Collision>> &collisions) {
+    collisions.clear();
 }
 
 void NeighbourhoodLocator::updateDataStructures(SphereRepresentation *sphereRep) {
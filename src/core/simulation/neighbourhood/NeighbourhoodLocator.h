@@ -29,8 +29,11 @@ public:
     NeighbourhoodLocator(Site *Site);
     virtual ~NeighbourhoodLocator();
     virtual void instantiate();
-    virtual std::vector<std::shared_ptr<Collision>> getCollisions(Agent *agent);
+    /// Writes the collisions of an agent into a buffer of the caller (it is cleared, its capacity is reused)
+    virtual void getCollisions(Agent *agent, std::vector<std::shared_ptr<Collision>> &collisions);
     virtual bool hasCollision(Agent *agent) { return false; };
+    /// Checks a candidate sphere that does not belong to an agent yet (e.g. before an agent is placed at a position)
+    virtual bool hasCollision(const Coordinate3D &position, double radius) { return false; };
     virtual std::vector<Coordinate3D> getCollisionSpheres(SphereRepresentation *sphereRep, Coordinate3D dirVec);
     virtual void updateDataStructures(SphereRepresentation *sphereRep);
     virtual void removeSphereRepresentation(SphereRepresentation *sphereRep);
@@ -13,14 +13,17 @@
 #include "ConditionalRate.h"
 #include "core/utils/macros.h"
 #include "apps/alveolus/cells/FungalCellAlveolus.h"
+#include "core/utils/Names.h"
 
 
 double ConditionalRate::calculateProbability(double timestep, double current_time, Condition *cond,  Cell* cell, Site* site) const{
+  static const int fungal_cell_alveolus = abm::util::Names::intern("FungalCellAlveolus");
+  static const int swelling = abm::util::Names::intern("Swelling");
   double p = 0;
   if (cond != nullptr) {
     if (condition_->isFulfilled(cond)) {
         // If in the fungus is the ode swelling model is applied, then the uptake depends on the radius increase!
-        if (cell->getTypeName() == "FungalCellAlveolus" && abm::util::isSubstring(cell->getCurrentCellState()->getStateName(), "Swelling")) {
+        if (cell->getTypeId() == fungal_cell_alveolus && abm::util::Names::related(cell->getCurrentCellState()->getStateId(), swelling)) {
             double r = cell->getSurface()->getBasicSphereOfThis()->getRadius();
             double rAtT0 = cell->getSurface()->getBasicSphereOfThis()->getRadiusAtT0();
             double rel_size_change = (r * r) / (rAtT0 * rAtT0);
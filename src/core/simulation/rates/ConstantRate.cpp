@@ -10,10 +10,19 @@
 
 #include "ConstantRate.h"
 #include "apps/alveolus/cells/FungalCellAlveolus.h"
+#include "core/utils/Names.h"
 
-double ConstantRate::calculateProbability(double timestep, double current_time, Condition *cond,  Cell* cell, Site* site)  const{
+namespace {
     // If in the fungus is the ode swelling model is applied, then the uptake depends on the radius increase!
-    if (cell->getTypeName() == "FungalCellAlveolus" && abm::util::isSubstring(cell->getCurrentCellState()->getStateName(), "Swelling")) {
+    bool scalesWithSwelling(Cell *cell, int state_id) {
+        static const int fungal_cell_alveolus = abm::util::Names::intern("FungalCellAlveolus");
+        static const int swelling = abm::util::Names::intern("Swelling");
+        return cell->getTypeId() == fungal_cell_alveolus && abm::util::Names::related(state_id, swelling);
+    }
+}
+
+double ConstantRate::calculateProbability(double timestep, double current_time, Condition *cond,  Cell* cell, Site* site)  const{
+    if (scalesWithSwelling(cell, cell->getCurrentCellState()->getStateId())) {
         double r = cell->getSurface()->getBasicSphereOfThis()->getRadius();
         double rAtT0 = cell->getSurface()->getBasicSphereOfThis()->getRadiusAtT0();
         double rel_size_change = (r * r) / (rAtT0 * rAtT0);
@@ -23,3 +32,6 @@ double ConstantRate::calculateProbability(double timestep, double current_time,
     }
 }
 
+bool ConstantRate::dependsOnlyOnTimestep(Cell *cell, int state_id) const {
+    return !scalesWithSwelling(cell, state_id);
+}
@@ -21,6 +21,7 @@ public:
     [[nodiscard]] double calculateProbability(double timestep, double current_time, Condition *cond, Cell *cell, Site *site) const final;
     [[nodiscard]] double getRateValue() const final { return constant_rate_; }
     [[nodiscard]] std::string_view getRateType() const final { return "ConstantRate"; }
+    [[nodiscard]] bool dependsOnlyOnTimestep(Cell *cell, int state_id) const final;
 
 private:
     double constant_rate_;
@@ -26,6 +26,8 @@ class Rate {
     calculateProbability(double timestep, double current_time, Condition *cond, Cell *cell, Site *site) const = 0;
     [[nodiscard]] virtual double getRateValue() const = 0;
     [[nodiscard]] virtual std::string_view getRateType() const = 0;
+    /// True if the probability of the rate for a cell in a state only depends on the timestep (i.e. can be tabulated)
+    [[nodiscard]] virtual bool dependsOnlyOnTimestep(Cell *cell, int state_id) const { return false; }
     virtual void adjustRate(const std::string &, double timestep_size) {};
 };
 
@@ -8,36 +8,43 @@
 //  This code is licensed under BSD 2-Clause
 //  See the LICENSE file provided with this code for the full license.
 
+#include <algorithm>
+#include <cmath>
+
 #include "CellState.h"
 #include "core/simulation/Cell.h"
+#include "core/simulation/AgentManager.h"
 #include "core/utils/macros.h"
+#include "core/utils/Names.h"
 #include "core/basic/Randomizer.h"
 
 
-CellState::CellState(const std::string &state_name, Cell *cell, std::map<std::string, const Rate *> next_states) {
-    current_state_ = state_name;
+CellState::CellState(int state_id, Cell *cell, StateTransitions next_states) {
+    current_state_ = state_id;
+    next_state_ = abm::util::Names::no_name;
     next_states_rates_ = std::move(next_states);
     end_state_ = false;
     cell_ = cell;
 }
 
-std::string CellState::getStateName() {
-    return current_state_;
+const std::string &CellState::getStateName() const {
+    return abm::util::Names::get(current_state_);
 }
 
 void CellState::stateTransition(double timestep, double current_time) {
+    static const int self = abm::util::Names::intern("self");
     selectNextState(timestep, current_time, cell_->getSite()->getRandomGenerator());
 
-    if (next_state_ == "self") {
+    if (next_state_ == self) {
         //in principle do nothing
     } else {
         //change the state and fire event
-        auto nextCellState = cell_->getCellStateByName(next_state_);
+        auto nextCellState = cell_->getCellStateById(next_state_);
         if (nextCellState != 0) {
             cell_->setState(nextCellState);
         } else {
             ERROR_STDERR("there is a problem with CellState changes->" +
-                         getStateName() + " ns->" + next_state_);
+                         getStateName() + " ns->" + abm::util::Names::get(next_state_));
         }
         cell_->setTimestepLastTreatment(current_time);
     }
@@ -45,7 +52,7 @@ void CellState::stateTransition(double timestep, double current_time) {
     if (end_state_) {
         checkForDeath(current_time);
     }
-    next_state_ = "";
+    next_state_ = abm::util::Names::no_name;
 }
 
 void CellState::handleInteractionEvent(InteractionEvent *interactionEvent) {
@@ -53,35 +60,68 @@ void CellState::handleInteractionEvent(InteractionEvent *interactionEvent) {
 }
 
 bool CellState::checkForDeath(double current_time) {
-    return current_state_ == "Death";
+    static const int death = abm::util::Names::intern("Death");
+    return current_state_ == death;
 }
 
 void CellState::selectNextState(double timestep, double current_time, Randomizer *randomizer) {
+    static const int self = abm::util::Names::intern("self");
+
+    if (!tabulation_checked_) {
+        tabulated_ = !next_states_rates_.empty() &&
+                     std::all_of(next_states_rates_.begin(), next_states_rates_.end(), [this](const auto &transition) {
+                         return transition.second->dependsOnlyOnTimestep(cell_, current_state_);
+                     });
+        event_driven_ = tabulated_ && cell_->getSite()->getAgentManager()->usesEventDrivenTransitions();
+        tabulation_checked_ = true;
+    }
 
     if (next_states_rates_.empty()) {
-        next_state_ = "self";
+        next_state_ = self;
+    } else if (tabulated_) {
+        if (timestep != table_timestep_) buildTransitionTable(timestep, current_time);
+        bool draw = true;
+        double scale = 1.0;
+        if (event_driven_) {
+            if (trials_until_transition_ == 0) trials_until_transition_ = sampleTrialsUntilTransition(randomizer);
+            draw = trials_until_transition_ != never && --trials_until_transition_ == 0;
+            // Next state conditioned on a transition
+            scale = transition_probability_;
+        }
+        auto next = cumulative_probabilities_.end();
+        if (draw) {
+            double p = randomizer->generateDouble() * scale;
+            // First upper bound above p, i.e. the same state as the sequential search over the rates
+            next = std::upper_bound(cumulative_probabilities_.begin(), cumulative_probabilities_.end(), p,
+                                    [](double p, const auto &entry) { return p < entry.first; });
+        }
+        if (next != cumulative_probabilities_.end()) {
+            next_state_ = next->second;
+        } else if (next_state_ == abm::util::Names::no_name) {
+            next_state_ = table_backup_ == abm::util::Names::no_name ? self : table_backup_;
+        }
     } else {
         double bottom = 0;
         double top = 0;
-        std::string backup{};
+        int backup = abm::util::Names::no_name;
         double p = randomizer->generateDouble();
-        for (const auto&[kRateName, kCurRate]: next_states_rates_) {
+        for (const auto&[kNextState, kCurRate]: next_states_rates_) {
             double cur_prob = kCurRate->calculateProbability(timestep, current_time, nullptr, cell_, this->cell_->getSite());
             if (cur_prob < 0) {
-                backup = kRateName;
+                backup = kNextState;
             } else {
                 top += cur_prob;
                 if (p >= bottom && p < top) {
-                    next_state_ = kRateName;
+                    next_state_ = kNextState;
                     break;
                     //next state was successfully found
                 }
                 bottom = top;
             }
         }
-        if (next_state_.empty()) {
-            if (backup.empty()) {
-                next_state_ = "self";
+        if (next_state_ == abm::util::Names::no_name) {
+            if (backup == abm::util::Names::no_name) {
+                next_state_ = self;
             } else {
                 next_state_ = backup;
             }
@@ -89,15 +129,62 @@ void CellState::selectNextState(double timestep, double current_time, Randomizer
     }
 }
 
+void CellState::buildTransitionTable(double timestep, double current_time) {
+    cumulative_probabilities_.clear();
+    table_backup_ = abm::util::Names::no_name;
+    double top = 0;
+    for (const auto&[kNextState, kCurRate]: next_states_rates_) {
+        double cur_prob = kCurRate->calculateProbability(timestep, current_time, nullptr, cell_, this->cell_->getSite());
+        if (cur_prob < 0) {
+            table_backup_ = kNextState;
+        } else {
+            top += cur_prob;
+            cumulative_probabilities_.emplace_back(top, kNextState);
+        }
+    }
+    table_timestep_ = timestep;
+    // A backup state is taken whenever no other state is, i.e. the state is left in every step
+    transition_probability_ = table_backup_ == abm::util::Names::no_name ? std::min(top, 1.0) : 1.0;
+    trials_until_transition_ = 0;
+}
+
+bool CellState::skipQuietTransition(double timestep) {
+    if (next_states_rates_.empty()) return true;
+    if (!tabulation_checked_ || !event_driven_ || timestep != table_timestep_ || trials_until_transition_ <= 1) {
+        return false;
+    }
+    if (trials_until_transition_ != never) --trials_until_transition_;
+    return true;
+}
+
+unsigned long CellState::sampleTrialsUntilTransition(Randomizer *randomizer) const {
+    if (transition_probability_ >= 1.0) return 1;
+    if (transition_probability_ <= 0.0) return never;
+    const double u = std::max(1.0 - randomizer->generateDouble(), std::numeric_limits<double>::min());
+    const double trials = std::floor(std::log(u) / std::log1p(-transition_probability_)) + 1.0;
+    return trials < static_cast<double>(never) ? static_cast<unsigned long>(trials) : never;
+}
+
 void CellState::addNextStateWithRate(const std::string &nameNextState, const double rateOfNextState) {
     const auto &rate = own_rates_.emplace_back(std::make_unique<ConstantRate>(rateOfNextState));
-    next_states_rates_[nameNextState] = rate.get();
+    addNextStateWithRate(nameNextState, rate.get());
 }
 
 void CellState::addNextStateWithRate(const std::string &nameNextState, const Rate *rate) {
-    next_states_rates_[nameNextState] = rate;
+    // Keeps the transitions in order of the names of the next states
+    const auto next_state = abm::util::Names::intern(nameNextState);
+    auto it = std::find_if(next_states_rates_.begin(), next_states_rates_.end(), [&](const auto &transition) {
+        return abm::util::Names::get(transition.first) >= nameNextState;
+    });
+    if (it != next_states_rates_.end() && it->first == next_state) {
+        it->second = rate;
+    } else {
+        next_states_rates_.emplace(it, next_state, rate);
+    }
+    tabulation_checked_ = false;
+    table_timestep_ = -1.0;
 }
 
-void CellState::setNextState(std::string stateName) {
-    next_state_ = stateName;
+void CellState::setNextState(const std::string &stateName) {
+    next_state_ = abm::util::Names::intern(stateName);
 }
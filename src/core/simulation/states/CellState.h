@@ -11,10 +11,10 @@
 #ifndef CORE_SIMULATION_CELLSTATE_H
 #define CORE_SIMULATION_CELLSTATE_H
 
+#include <limits>
 #include <string>
 #include <memory>
 #include <vector>
-#include <map>
 
 #include "core/simulation/factories/CellStateFactory.h"
 #include "core/simulation/cells/interaction/InteractionEvent.h"
@@ -25,29 +25,59 @@ class Randomizer;
 
 class CellState {
 public:
-  // Class for wrapping cell states functionality
-    CellState(const std::string &state_name, Cell *cell, std::map<std::string, const Rate *> next_states);
+  // Class for wrapping cell states functionality. States are identified by the ids of their names in
+  // abm::util::Names, the transitions are a flat list in order of the names of the next states.
+    CellState(int state_id, Cell *cell, StateTransitions next_states);
 
     ~CellState() = default;
 
     void handleInteractionEvent(InteractionEvent *interactionEvent);
     void stateTransition(double timestep, double current_time);
-    std::string getStateName();
+    [[nodiscard]] const std::string &getStateName() const;
+    [[nodiscard]] int getStateId() const { return current_state_; };
     bool checkForDeath(double current_time);
     void changeState(std::string stateName) {};
-    void setNextState(std::string stateName);
+    void setNextState(const std::string &stateName);
     void addNextStateWithRate(const std::string &nameNextState, const Rate *rate);
     void addNextStateWithRate(const std::string &nameNextState, double rateOfNextState);
+    /// Called when the cell enters the state, the number of steps until the next transition is sampled again
+    void restartSchedule() { trials_until_transition_ = 0; };
+    /*!
+     * Skips the transition of a timestep in which the state is certainly kept without a random draw, i.e. the state
+     * has no transitions or the sampled step of its next transition is not reached yet
+     * @param timestep Double that contains the timestep
+     * @return Bool that is false if the transition has to be done in this timestep
+     */
+    bool skipQuietTransition(double timestep);
+    /// Number of steps until the sampled transition in event driven mode (the maximum if the state is never left)
+    [[nodiscard]] unsigned long getTrialsUntilTransition() const { return trials_until_transition_; };
 
 protected:
     void selectNextState(double timestep, double current_time, Randomizer *randomizer);
+    void buildTransitionTable(double timestep, double current_time);
+    unsigned long sampleTrialsUntilTransition(Randomizer *randomizer) const;
 
     Cell *cell_;
     bool end_state_{};
-    std::string next_state_;
-    std::string current_state_;
+    int next_state_;
+    int current_state_;
     std::vector<std::unique_ptr<Rate>> own_rates_;
-    std::map<std::string, const Rate *> next_states_rates_;
+    StateTransitions next_states_rates_;
+
+    // If all rates only depend on the timestep, the transition is drawn from a cumulative distribution (upper bounds
+    // and next states) that is rebuilt when the timestep changes, the remaining mass is no transition
+    bool tabulated_{};
+    bool tabulation_checked_{};
+    double table_timestep_{-1.0};
+    std::vector<std::pair<double, int>> cumulative_probabilities_;
+    int table_backup_{-1};
+
+    // Event driven mode of the agent manager: the step in which a tabulated state is left is sampled once on entry
+    // (geometric distribution of the transition probability per step), only then the next state is drawn
+    static constexpr unsigned long never = std::numeric_limits<unsigned long>::max();
+    bool event_driven_{};
+    double transition_probability_{};
+    unsigned long trials_until_transition_{};
 };
 
 #endif /* CORE_SIMULATION_CELLSTATE_H */
@@ -14,6 +14,7 @@
 #include "core/simulation/cells/interaction/InteractionEvent.h"
 #include "core/analyser/InSituMeasurements.h"
 #include "core/simulation/Site.h"
+#include "core/utils/Names.h"
 
 
 void InteractionState::handleInteraction(Cell *cell, double timestep, double current_time) {
@@ -24,36 +25,37 @@ void InteractionState::handleInteraction(Cell *cell, double timestep, double cur
 }
 
 void InteractionState::stateTransition(double timestep, double current_time) {
+    static const int self = abm::util::Names::intern("self");
+    static const int no_interplay = abm::util::Names::intern("NoInterplay");
+    static const int avoidance = abm::util::Names::intern("Avoidance");
+    static const int phagocytose = abm::util::Names::intern("Phagocytose");
     Cell *cell1 = interaction_->getFirstCell();
     Cell *cell2 = interaction_->getSecondCell();
     Condition *curCondition = interaction_->getCurrentCondition();
     selectNextState(timestep, current_time, cell1->getSite()->getRandomGenerator(), curCondition);
 
     if (cell1->agentTreatedInCurrentTimestep(current_time) || cell2->agentTreatedInCurrentTimestep(current_time)) {
-        if (next_state_ != "NoInterplay" && next_state_.compare("self") != 0 && next_state_.compare("Avoidance") != 0) {
-            auto iterNextStates = next_states_rates_.begin();
-            while (iterNextStates != next_states_rates_.end()) {
-                std::string nextStateName = iterNextStates->first;
-                if (nextStateName == "NoInterplay") {
-                    next_state_ = "NoInterplay";
+        if (next_state_ != no_interplay && next_state_ != self && next_state_ != avoidance) {
+            for (const auto &[next_state, rate]: *next_states_rates_) {
+                if (next_state == no_interplay) {
+                    next_state_ = no_interplay;
                     break;
                 }
-                iterNextStates++;
             }
-            if (next_state_ != "NoInterplay") {
-                next_state_ = "self";
+            if (next_state_ != no_interplay) {
+                next_state_ = self;
             }
         }
     }
 
-    if (next_state_.compare("self") != 0 && next_state_ != "NoInterplay" && next_state_.compare("Avoidance") != 0) {
+    if (next_state_ != self && next_state_ != no_interplay && next_state_ != avoidance) {
         cell1->setTimestepLastTreatment(current_time);
         cell2->setTimestepLastTreatment(current_time);
     }
 
-    if (next_state_ != "self") {
+    if (next_state_ != self) {
         interaction_->setState(next_state_);
-        if (interaction_->getCurrentState()->getStateName() == "Phagocytose") {
+        if (interaction_->getCurrentState()->getStateId() == phagocytose) {
             //                cout << "[InteractionState] next state is
             //                Phagocytose" << '\n';
             Cell *cell1 = interaction_->getFirstCell();
@@ -61,62 +63,60 @@ void InteractionState::stateTransition(double timestep, double current_time) {
             cell1->getSite()->getMeasurments()->increment<PairMeasurement>("Phagocytosis-NC", "NCPhag", 1);
             cell1->getSite()->getMeasurments()->increment<PairMeasurement>("Phagocytosis-MC", "MCPhag", 1);
         }
-        const auto ievent = std::make_unique<InteractionEvent>(getStateName(), next_state_, interaction_);
-        interaction_->fireInteractionEvent(ievent.get(), current_time);
+        InteractionEvent ievent(current_state_, next_state_, interaction_);
+        interaction_->fireInteractionEvent(&ievent, current_time);
     }
 
     if (interaction_->getCurrentState()->isEndState()) {
         interaction_->close();
     }
-    next_state_ = "";
+    next_state_ = abm::util::Names::no_name;
 }
 
-void InteractionState::fireInteractionEvent(const std::string &nextState, double current_time) {
-    const auto ievent = std::make_unique<InteractionEvent>(getStateName(), nextState, interaction_);
-    interaction_->fireInteractionEvent(ievent.get(), current_time);
+void InteractionState::fireInteractionEvent(int nextState, double current_time) {
+    InteractionEvent ievent(current_state_, nextState, interaction_);
+    interaction_->fireInteractionEvent(&ievent, current_time);
 }
 
-void InteractionState::addNextStateWithRate(const std::string &nameNextState, const Rate *rate) {
-    next_states_rates_[nameNextState] = rate;
-}
-
-void InteractionState::addNextStateWithRate(std::map<std::string, const Rate *> next_states_rates) {
-    next_states_rates_ = next_states_rates;
+void InteractionState::addNextStateWithRate(const StateTransitions &next_states_rates) {
+    next_states_rates_ = &next_states_rates;
 }
 
 bool InteractionState::isEndState() const { return end_state_; }
 
 void InteractionState::selectNextState(double timestep, double current_time, Randomizer *randomizer, Condition *condition) {
+    static const int self = abm::util::Names::intern("self");
+    static const int fungal_cell_type = abm::util::Names::intern("FungalCell");
     Cell *fungal_cell;
-    if (abm::util::isSubstring(interaction_->getSecondCell()->getTypeName(), "FungalCell")) {
+    if (abm::util::Names::related(interaction_->getSecondCell()->getTypeId(), fungal_cell_type)) {
         fungal_cell = interaction_->getSecondCell();
     } else {
         fungal_cell = interaction_->getFirstCell();
     }
 
-    if (next_states_rates_.empty()) {
-        next_state_ = "self";
+    if (next_states_rates_ == nullptr || next_states_rates_->empty()) {
+        next_state_ = self;
     } else {
         double bottom = 0;
         double top = 0;
-        std::string backup{};
+        int backup = abm::util::Names::no_name;
         double p = randomizer->generateDouble();
-        for (const auto&[kRateName, kCurRate]: next_states_rates_) {
+        for (const auto&[kNextState, kCurRate]: *next_states_rates_) {
             double cur_prob = kCurRate->calculateProbability(timestep, current_time, condition, fungal_cell, fungal_cell->getSite());
             if (cur_prob < 0) {
-                backup = kRateName;
+                backup = kNextState;
             } else {
                 top += cur_prob;
                 if (p >= bottom && p < top) {
-                    next_state_ = kRateName;
+                    next_state_ = kNextState;
                     break;
                 }
                 bottom = top;
             }
         }
-        if (next_state_.empty()) {
-            if (backup.empty()) {
-                next_state_ = "self";
+        if (next_state_ == abm::util::Names::no_name) {
+            if (backup == abm::util::Names::no_name) {
+                next_state_ = self;
             } else {
                 next_state_ = backup;
             }
@@ -125,7 +125,7 @@ void InteractionState::selectNextState(double timestep, double current_time, Ran
 }
 
 const std::string &InteractionState::getStateName() const {
-    return current_state_;
+    return abm::util::Names::get(current_state_);
 }
 
 std::string InteractionState::getInteractionType() const {
@@ -15,35 +15,38 @@
 
 #include "core/simulation/interactiontypes/InteractionType.h"
 #include "core/simulation/Cell.h"
+#include "core/utils/RunArena.h"
 
 class Analyser;
 class Interaction;
 
-class InteractionState {
+class InteractionState : public abm::util::RunPooled {
 public:
-  // Class for handling the interactions specified in the simulator-config
-    InteractionState(std::string state_name, Interaction *interaction,
+  // Class for handling the interactions specified in the simulator-config. States are identified by the ids of their
+  // names in abm::util::Names, the transitions are a flat list in order of the names of the next states.
+    InteractionState(int state_id, Interaction *interaction,
                      std::unique_ptr<InteractionType> interaction_type, bool end_state)
-            : current_state_(std::move(state_name)), interaction_(interaction), end_state_(end_state),
+            : current_state_(state_id), interaction_(interaction), end_state_(end_state),
               interaction_type_(std::move(interaction_type)) {}
 
-    void addNextStateWithRate(const std::string &name_next_state, const Rate *rate);
-    void addNextStateWithRate(std::map<std::string, const Rate *> next_states_rates);
+    /// Transitions of the state, they are owned by the InteractionStateFactory and shared by all interactions
+    void addNextStateWithRate(const StateTransitions &next_states_rates);
 
-    void fireInteractionEvent(const std::string &next_state, double current_time);
+    void fireInteractionEvent(int next_state, double current_time);
     void handleInteraction(Cell *cell, double timestep, double current_time);
     void stateTransition(double timestep, double current_time);
     [[nodiscard]] bool isEndState() const;
     [[nodiscard]] const std::string &getStateName() const;
+    [[nodiscard]] int getStateId() const { return current_state_; };
     [[nodiscard]] std::string getInteractionType() const;
 
 protected:
     void selectNextState(double timestep, double current_time, Randomizer *randomizer, Condition *condition);
     bool end_state_{};
-    std::string current_state_;
-    std::string next_state_;
+    int current_state_;
+    int next_state_{abm::util::Names::no_name};
     Interaction *interaction_;
-    std::map<std::string, const Rate *> next_states_rates_;
+    const StateTransitions *next_states_rates_{};
     std::unique_ptr<InteractionType> interaction_type_;
 };
 #endif /* CORE_SIMULATION_INTERACTIONSTATE_H */
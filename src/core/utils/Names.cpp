@@ -0,0 +1,76 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <mutex>
+#include <unordered_map>
+
+#include "core/utils/Names.h"
+#include "core/utils/macros.h"
+#include "core/utils/misc_util.h"
+
+namespace abm::util {
+
+    namespace {
+        // Entries are written once before they are published by the size, the relation of a name is only stored for
+        // names with smaller ids, i.e. entries never change after publication
+        struct Entry {
+            std::string name{};
+            std::bitset<Names::max_number_of_names> related_to_previous{};
+        };
+
+        std::mutex names_mutex;
+        std::unordered_map<std::string, int> name_ids;
+        std::array<Entry, Names::max_number_of_names> entries;
+        std::atomic<unsigned int> number_of_names{0};
+    }
+
+    int Names::intern(const std::string &name) {
+        std::lock_guard<std::mutex> lock(names_mutex);
+        if (const auto it = name_ids.find(name); it != name_ids.end()) {
+            return it->second;
+        }
+        const auto id = number_of_names.load(std::memory_order_relaxed);
+        if (id == max_number_of_names) {
+            ERROR_STDERR("More than " << max_number_of_names << " names of states, agent types and interactions");
+            exit(1);
+        }
+        auto &entry = entries[id];
+        entry.name = name;
+        for (unsigned int previous = 0; previous < id; ++previous) {
+            entry.related_to_previous[previous] = isSubstring(entries[previous].name, name);
+        }
+        name_ids.emplace(name, id);
+        number_of_names.store(id + 1, std::memory_order_release);
+        return static_cast<int>(id);
+    }
+
+    int Names::find(const std::string &name) {
+        std::lock_guard<std::mutex> lock(names_mutex);
+        const auto it = name_ids.find(name);
+        return it != name_ids.end() ? it->second : no_name;
+    }
+
+    const std::string &Names::get(int id) {
+        return entries[id].name;
+    }
+
+    unsigned int Names::size() {
+        return number_of_names.load(std::memory_order_acquire);
+    }
+
+    bool Names::related(int id_1, int id_2) {
+        if (id_1 < 0 || id_2 < 0) return false;
+        if (id_1 == id_2) return true;
+        return id_1 > id_2 ? entries[id_1].related_to_previous[id_2] : entries[id_2].related_to_previous[id_1];
+    }
+}
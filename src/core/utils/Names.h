@@ -0,0 +1,44 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#ifndef CORE_UTILS_NAMES_H
+#define CORE_UTILS_NAMES_H
+
+#include <string>
+
+namespace abm::util {
+
+    class Names {
+    public:
+        // Process wide table of the names of states, agent types and interactions. Names are interned at setup into
+        // dense ids (shared by all runs) and the relation of isSubstring between all names is precomputed as bitsets,
+        // i.e. per step logic compares integers instead of strings. Lookups are lock free, interning is synchronised.
+        static constexpr unsigned int max_number_of_names = 1024;
+        static constexpr int no_name = -1;
+
+        /// Returns the id of a name, the name is added if it is not known yet
+        static int intern(const std::string &name);
+        /// Returns the id of a name without adding it (no_name if it is not known)
+        static int find(const std::string &name);
+        static const std::string &get(int id);
+        /// Number of interned names, all ids are smaller
+        static unsigned int size();
+
+        /*!
+         * Precomputed isSubstring of two names, i.e. true if one name contains the other
+         * @param id_1 Int that contains the id of the first name
+         * @param id_2 Int that contains the id of the second name
+         * @return Bool that is false if one of the ids is no_name
+         */
+        static bool related(int id_1, int id_2);
+    };
+}
+
+#endif //CORE_UTILS_NAMES_H
@@ -0,0 +1,78 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#include <new>
+
+#include "core/utils/RunArena.h"
+
+namespace abm::util {
+
+    namespace {
+        // Header in front of objects derived from RunPooled, keeps the alignment of new
+        struct alignas(alignof(std::max_align_t)) PooledHeader {
+            std::pmr::memory_resource *resource;
+            size_t bytes;
+        };
+    }
+
+    thread_local RunArena *RunArena::current_ = nullptr;
+
+    RunArena::Scope::Scope(RunArena *arena) : previous_(current_) {
+        current_ = arena;
+    }
+
+    RunArena::Scope::~Scope() {
+        current_ = previous_;
+    }
+
+    RunArena *RunArena::current() {
+        return current_;
+    }
+
+    std::pmr::memory_resource *RunArena::currentResource() {
+        return current_ != nullptr ? current_->getResource() : std::pmr::get_default_resource();
+    }
+
+    RunArena::Counters RunArena::getCounters() const {
+        return {objects_.allocations, objects_.deallocations, objects_.bytes_in_use, objects_.peak_bytes_in_use,
+                system_.bytes_in_use, system_.peak_bytes_in_use};
+    }
+
+    void *RunArena::CountingResource::do_allocate(size_t bytes, size_t alignment) {
+        void *p = target_->allocate(bytes, alignment);
+        ++allocations;
+        const size_t in_use = bytes_in_use += bytes;
+        size_t peak = peak_bytes_in_use;
+        while (in_use > peak && !peak_bytes_in_use.compare_exchange_weak(peak, in_use)) {}
+        return p;
+    }
+
+    void RunArena::CountingResource::do_deallocate(void *p, size_t bytes, size_t alignment) {
+        target_->deallocate(p, bytes, alignment);
+        ++deallocations;
+        bytes_in_use -= bytes;
+    }
+
+    void *RunPooled::operator new(size_t bytes) {
+        auto *arena = RunArena::current();
+        auto *resource = arena != nullptr ? arena->getResource() : std::pmr::new_delete_resource();
+        const size_t total = sizeof(PooledHeader) + bytes;
+        auto *header = static_cast<PooledHeader *>(resource->allocate(total, alignof(PooledHeader)));
+        header->resource = resource;
+        header->bytes = total;
+        return header + 1;
+    }
+
+    void RunPooled::operator delete(void *p) {
+        if (p == nullptr) return;
+        auto *header = static_cast<PooledHeader *>(p) - 1;
+        header->resource->deallocate(header, header->bytes, alignof(PooledHeader));
+    }
+}
@@ -0,0 +1,104 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#ifndef CORE_UTILS_RUNARENA_H
+#define CORE_UTILS_RUNARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace abm::util {
+
+    class RunArena {
+    public:
+        // Memory of one simulation run. Agents, morphologies, spheres, interactions and collisions are taken from the
+        // size class pools of the arena of the run that is executed on the current thread, all pools are returned to
+        // the system at once when the arena is destroyed. Without an active arena objects are allocated as before.
+        struct Counters {
+            size_t allocations{};
+            size_t deallocations{};
+            size_t bytes_in_use{};
+            size_t peak_bytes_in_use{};
+            size_t bytes_from_system{};
+            size_t peak_bytes_from_system{};
+        };
+
+        class Scope {
+        public:
+            /// Makes the arena the active arena of the current thread until the scope ends
+            explicit Scope(RunArena *arena);
+            ~Scope();
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+
+        private:
+            RunArena *previous_{};
+        };
+
+        RunArena() = default;
+        RunArena(const RunArena &) = delete;
+        RunArena &operator=(const RunArena &) = delete;
+
+        /// Active arena of the current thread (nullptr if none)
+        static RunArena *current();
+        /// Resource of the active arena for containers of run objects (the default resource if there is no arena)
+        static std::pmr::memory_resource *currentResource();
+
+        std::pmr::memory_resource *getResource() { return &objects_; };
+        Counters getCounters() const;
+
+    private:
+        class CountingResource : public std::pmr::memory_resource {
+        public:
+            explicit CountingResource(std::pmr::memory_resource *target) : target_(target) {};
+
+            std::atomic<size_t> allocations{};
+            std::atomic<size_t> deallocations{};
+            std::atomic<size_t> bytes_in_use{};
+            std::atomic<size_t> peak_bytes_in_use{};
+
+        private:
+            void *do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; };
+
+            std::pmr::memory_resource *target_;
+        };
+
+        static thread_local RunArena *current_;
+
+        // Objects -> size class pools -> system, the pools release all their chunks when they are destroyed
+        CountingResource system_{std::pmr::new_delete_resource()};
+        std::pmr::synchronized_pool_resource pools_{&system_};
+        CountingResource objects_{&pools_};
+    };
+
+    /// Creates a shared object in the active arena, control block and object share one pool block
+    template<typename T, typename... Args>
+    std::shared_ptr<T> makeShared(Args &&... args) {
+        if (auto *arena = RunArena::current()) {
+            return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(arena->getResource()),
+                                           std::forward<Args>(args)...);
+        }
+        return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+
+    class RunPooled {
+    public:
+        // Base class for objects owned by unique pointers, new takes them from the active arena. The resource is kept
+        // in front of the object, i.e. they can be deleted on any thread and after the arena has been deactivated.
+        static void *operator new(size_t bytes);
+        static void operator delete(void *p);
+    };
+}
+
+#endif //CORE_UTILS_RUNARENA_H
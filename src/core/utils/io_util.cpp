@@ -87,6 +87,17 @@ namespace abm::util {
                                          site["NeighbourhoodLocator"].value("interaction_check_interval", 1)};
 
             // load agent manager
+            site_para->agent_manager_parameters.event_driven_transitions = site["AgentManager"].value(
+                    "event_driven_transitions", false);
+            site_para->agent_manager_parameters.quiescent_agents = site["AgentManager"].value("quiescent_agents", false);
+            site_para->agent_manager_parameters.boundary_placement_precheck = site["AgentManager"].value(
+                    "boundary_placement_precheck", false);
+            if (site["AgentManager"].find("OdeEngine") != site["AgentManager"].end()) {
+                const auto &ode_engine = site["AgentManager"]["OdeEngine"];
+                site_para->agent_manager_parameters.ode_engine = {ode_engine.value("activated", false),
+                                                                  ode_engine.value("relative_tolerance", 1e-6),
+                                                                  ode_engine.value("absolute_tolerance", 1e-9)};
+            }
             // we need to keep an ordering for reproducing simulations, changing it leads to agents get differently initialized due to random values
             for (const auto &agent_type:site["AgentManager"]["Types"]) {
                 std::shared_ptr<SimulationParameters::AgentParameters> agent_parameters{};
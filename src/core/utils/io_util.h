@@ -99,9 +99,19 @@ namespace abm::util {
         struct FungalParameters : public AgentParameters {
         };
 
+        struct OdeEngineParameters {
+            bool activated{};
+            double relative_tolerance{1e-6};
+            double absolute_tolerance{1e-9};
+        };
+
         struct AgentManagerParameters {
             std::string site_identifier{};
             std::vector<std::shared_ptr<AgentParameters>> agents;
+            bool event_driven_transitions{};
+            bool quiescent_agents{};
+            bool boundary_placement_precheck{};
+            OdeEngineParameters ode_engine{};
         };
 
         struct NHLParameters {
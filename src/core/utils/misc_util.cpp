@@ -325,17 +325,20 @@ namespace abm::util {
     }
 
     std::vector<unsigned int> generateRandomPermutation(Randomizer *randomizer, unsigned int size) {
-        std::vector<unsigned int> permutationVector;
+        std::vector<unsigned int> permutationVector(size);
+        generateRandomPermutation(randomizer, permutationVector.data(), size);
+        return permutationVector;
+    }
+
+    void generateRandomPermutation(Randomizer *randomizer, unsigned int *permutation, unsigned int size) {
         if (size > 0) {
-            //initialize the vector
             for (unsigned int k = 0; k < size; k++) {
-                permutationVector.push_back(k);
+                permutation[k] = k;
             }
             for (unsigned int k = 0; k < size - 1; k++) {
-                swap(&permutationVector, k, randomizer->generateInt(k, size - 1));
+                std::swap(permutation[k], permutation[randomizer->generateInt(k, size - 1)]);
             }
         }
-        return permutationVector;
     }
 
     void swap(std::vector<unsigned int> *vectorToSwap, unsigned int i, unsigned int j) {
@@ -121,6 +121,9 @@ namespace abm::util {
 
     std::vector<unsigned int> generateRandomPermutation(Randomizer *randomizer, unsigned int size);
 
+    /// Same permutation as above written into an existing array of at least size elements (no allocation)
+    void generateRandomPermutation(Randomizer *randomizer, unsigned int *permutation, unsigned int size);
+
     void swap(std::vector<unsigned int> *vectorToSwap, unsigned int i, unsigned int j);
 
     bool isSubstring(const std::string& str1, const std::string& str2);
@@ -0,0 +1,138 @@
+//  Copyright by Christoph Saffer, Paul Rudolph, Sandra Timme, Marco Blickensdorf, Johannes Pollmächer
+//  Research Group Applied Systems Biology - Head: Prof. Dr. Marc Thilo Figge
+//  https://www.leibniz-hki.de/en/applied-systems-biology.html
+//  HKI-Center for Systems Biology of Infection
+//  Leibniz Institute for Natural Product Research and Infection Biology - Hans Knöll Insitute (HKI)
+//  Adolf-Reichwein-Straße 23, 07745 Jena, Germany
+//
+//  This code is licensed under BSD 2-Clause
+//  See the LICENSE file provided with this code for the full license.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "core/analyser/Analyser.h"
+#include "core/simulation/Simulator.h"
+#include "core/simulation/Site.h"
+#include "core/simulation/factories/InteractionFactory.h"
+#include "core/utils/RunArena.h"
+#include "external/doctest/doctest.h"
+#include "apps/alveolus/SimulatorAlveolus.h"
+
+using boost::filesystem::path;
+using boost::filesystem::exists;
+
+namespace {
+    // Calls of the global operator new (plain and aligned) while counting is active, they are replaced for the whole
+    // test executable
+    std::atomic<bool> counting{false};
+    std::atomic<size_t> allocations{0};
+
+    struct AllocationStatistics {
+        size_t steady_steps{};
+        size_t steady_allocations{};
+        size_t max_steady_allocations{};
+    };
+
+    void *allocate(size_t size, size_t alignment) {
+        if (counting.load(std::memory_order_relaxed)) allocations.fetch_add(1, std::memory_order_relaxed);
+        size = size == 0 ? 1 : size;
+        void *p = alignment <= alignof(std::max_align_t) ? std::malloc(size)
+                                                         : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        if (p == nullptr) throw std::bad_alloc();
+        return p;
+    }
+
+    /*!
+     * Runs a configuration and counts the allocations of every timestep after the warm-up. Timesteps in which agents
+     * enter or leave the site, new interactions begin or fungal cells are ingested are not part of the steady state,
+     * agents and interactions are constructed and destroyed and the events are recorded.
+     * @param config String that contains the path of the main config
+     * @param warm_up Number of timesteps that are not counted
+     */
+    AllocationStatistics count_allocations(const std::string &config, int warm_up) {
+        const auto parameters = abm::util::getMainConfigParameters(config);
+        std::unordered_map<std::string, std::string> input_args;
+        std::unique_ptr<Simulator> simulator;
+        if (parameters.simulator == "SimulatorAlveolus") {
+            simulator = std::make_unique<SimulatorAlveolus>();
+        } else {
+            simulator = std::make_unique<Simulator>();
+        }
+        simulator->setConfigPath(parameters.config_path);
+        simulator->setCmdInputArgs(input_args);
+        // Objects of the run are taken from its arena as in Simulator::executeRuns
+        abm::util::RunArena arena;
+        const abm::util::RunArena::Scope arena_scope(&arena);
+        const auto analyser = std::make_unique<Analyser>();
+        const auto random_generator = std::make_unique<Randomizer>(parameters.system_seed);
+        const auto site = simulator->createSites(parameters.system_seed, random_generator.get(), analyser.get());
+        SimulationTime time{site->getTimeStepping(), site->getMaxTime()};
+
+        AllocationStatistics statistics{};
+        int step = 0;
+        for (time.updateTimestep(0); !time.endReached(); ++time, ++step) {
+            const auto ids_before = site->getAgentManager()->getIdHandling();
+            const auto agents_before = site->getAgentManager()->getAllAgents().size();
+            const auto interactions_before = site->getInteractionFactory()->getNextInteractionId();
+            const auto fungal_change_before = site->getAgentManager()->getLastFungalCellChange();
+            allocations = 0;
+            counting = step >= warm_up;
+            site->doAgentDynamics(random_generator.get(), time);
+            counting = false;
+            const auto steady = ids_before == site->getAgentManager()->getIdHandling() &&
+                                agents_before == site->getAgentManager()->getAllAgents().size() &&
+                                interactions_before == site->getInteractionFactory()->getNextInteractionId() &&
+                                fungal_change_before == site->getAgentManager()->getLastFungalCellChange();
+            if (step >= warm_up && steady) {
+                ++statistics.steady_steps;
+                statistics.steady_allocations += allocations;
+                statistics.max_steady_allocations = std::max(statistics.max_steady_allocations, allocations.load());
+            }
+            if (site->checkForStopping(time)) break;
+        }
+        return statistics;
+    }
+}
+
+void *operator new(size_t size) {
+    return allocate(size, alignof(std::max_align_t));
+}
+
+void *operator new(size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+TEST_CASE ("Test Allocations per Timestep") {
+    std::cout << "Start allocation test ...\n";
+    for (const std::string name: {"testSimulator", "testSimulatorAlveolus"}) {
+        path config("../../test/configurations/" + name + "/config.json");
+        CHECK(exists(config) == true);
+        const auto statistics = count_allocations(config.string(), 50);
+        INFO(name << ": " << statistics.steady_allocations << " allocations in " << statistics.steady_steps
+                  << " steady timesteps (at most " << statistics.max_steady_allocations << " in one timestep)");
+        CHECK(statistics.steady_steps > 0);
+        CHECK(statistics.steady_allocations == 0);
+    }
+}
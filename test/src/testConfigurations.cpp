@@ -10,13 +10,27 @@
 
 #include "testConfigurations.h"
 
+#include <functional>
+#include <limits>
+#include <map>
 #include <memory>
+#include <optional>
+#include <set>
+#include <sstream>
+
+#include <omp.h>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "core/analyser/Analyser.h"
+#include "core/simulation/Cell.h"
+#include "core/simulation/Interaction.h"
+#include "core/simulation/Interactions.h"
 #include "core/simulation/Simulator.h"
+#include "core/simulation/neighbourhood/BalloonListNHLocator.h"
 #include "core/simulation/Site.h"
+#include "core/simulation/states/CellState.h"
 #include "external/doctest/doctest.h"
+#include "apps/alveolus/AlveoleSite.h"
 #include "apps/alveolus/SimulatorAlveolus.h"
 
 using boost::filesystem::path;
@@ -34,13 +48,15 @@ std::unique_ptr<Simulator> createSimulator(const std::string simulator) {
     }
 }
 
-std::string abm::test::test_simulation(const std::string &config) {
+// after_step returns true to stop the run, input_args override parameters of the site as command line inputs
+void run_simulation(const std::string &config, std::optional<int> seed, const std::function<void(Site &, double)> &at_end,
+                    const std::function<bool(Site &, double)> &after_step = {},
+                    const std::unordered_map<std::string, std::string> &input_args = {}) {
     const auto parameters = abm::util::getMainConfigParameters(config);
-    std::unordered_map<std::string, std::string> input_args;
     const auto simulator = createSimulator(parameters.simulator);
     simulator->setConfigPath(parameters.config_path);
     simulator->setCmdInputArgs(input_args);
-    const auto run_seed = parameters.system_seed;
+    const auto run_seed = seed.value_or(parameters.system_seed);
     const auto analyser = std::make_unique<Analyser>();
     const auto random_generator = std::make_unique<Randomizer>(run_seed);
     const auto sites = simulator->createSites(run_seed, random_generator.get(), analyser.get());
@@ -48,11 +64,156 @@ std::string abm::test::test_simulation(const std::string &config) {
     SimulationTime time{site->getTimeStepping(), site->getMaxTime()};
     for (time.updateTimestep(0); !time.endReached(); ++time) {    //inner loop: t -> t + dt
         site->doAgentDynamics(random_generator.get(), time);
+        if (after_step && after_step(*site, time.getCurrentTime())) {
+            break;
+        }
         if (site->checkForStopping(time)) {
           break;
         }
     }
-    return abm::util::generateHashFromAgents(time.getCurrentTime(), site->getAgentManager()->getAllAgents());
+    at_end(*site, time.getCurrentTime());
+}
+
+std::string abm::test::test_simulation(const std::string &config) {
+    std::string hash{};
+    run_simulation(config, std::nullopt, [&hash](Site &site, double current_time) {
+        hash = abm::util::generateHashFromAgents(current_time, site.getAgentManager()->getAllAgents());
+    });
+    return hash;
+}
+
+std::string abm::test::test_simulation(const std::string &config, int number_of_threads,
+                                      const std::unordered_map<std::string, std::string> &input_args) {
+    const auto previous_threads = omp_get_max_threads();
+    omp_set_num_threads(number_of_threads);
+    std::string hash{};
+    run_simulation(config, std::nullopt, [&hash](Site &site, double current_time) {
+        hash = abm::util::generateHashFromAgents(current_time, site.getAgentManager()->getAllAgents());
+    }, {}, input_args);
+    omp_set_num_threads(previous_threads);
+    return hash;
+}
+
+std::string abm::test::test_molecule_field(const std::string &config,
+                                          const std::unordered_map<std::string, std::string> &input_args) {
+    std::ostringstream result;
+    run_simulation(config, std::nullopt, [&result](Site &site, double current_time) {
+        auto &particle_manager = *dynamic_cast<AlveoleSite &>(site).particle_manager_;
+        particle_manager.synchronizeConcentrations();
+        double sum = 0;
+        for (const auto &particle: particle_manager.getAllParticles()) sum += particle->getConcentration();
+        result << abm::util::generateHashFromAgents(current_time, site.getAgentManager()->getAllAgents()) << " "
+               << std::hexfloat << sum;
+    }, {}, input_args);
+    return result.str();
+}
+
+std::pair<int, int> abm::test::test_boundary_placement(const std::string &config) {
+    // Boundary placement is checked with the bounding radius of the AMs first, many AMs enter the site
+    const std::unordered_map<std::string, std::string> input_args{{"precheck", "1"}, {"icInput", "2"}};
+    const auto overlaps = [](Agent &a, Agent &b) {
+        for (auto *sphere: a.getMorphology()->getAllSpheresOfThis()) {
+            for (auto *other: b.getMorphology()->getAllSpheresOfThis()) {
+                if (sphere->getPosition().calculateEuclidianDistance(other->getPosition()) <
+                    sphere->getRadius() + other->getRadius()) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+    // Agents are inserted at the end of a step, i.e. new agents did not move yet. Agents that exist after the first
+    // step are not checked, they contain the initial distribution.
+    std::optional<std::set<int>> known_ids{};
+    int inserted = 0, colliding = 0;
+    const auto check = [&](Site &site, double) {
+        const auto &agents = site.getAgentManager()->getAllAgents();
+        const bool first_step = !known_ids.has_value();
+        if (first_step) known_ids.emplace();
+        for (const auto &agent: agents) {
+            if (agent == nullptr || agent->isDeleted() || !known_ids->insert(agent->getId()).second || first_step) continue;
+            ++inserted;
+            for (const auto &other: agents) {
+                if (other != nullptr && other != agent && !other->isDeleted() && overlaps(*agent, *other)) {
+                    ++colliding;
+                    break;
+                }
+            }
+        }
+        return false;
+    };
+    run_simulation(config, std::nullopt, [](Site &, double) {}, check, input_args);
+    return {inserted, colliding};
+}
+
+int abm::test::test_collision_reach(const std::string &config) {
+    // Spheres of existing agents are searched from points more than one grid constant away, only candidates whose
+    // radius reaches the sphere have to collide
+    int missed = 0;
+    run_simulation(config, std::nullopt, [&missed](Site &site, double) {
+        auto *locator = dynamic_cast<BalloonListNHLocator *>(site.getNeighbourhoodLocator());
+        REQUIRE(locator != nullptr);
+        const double distance = 2.5 * locator->getGridConstant();
+        for (const auto &agent: site.getAgentManager()->getAllAgents()) {
+            if (agent == nullptr || agent->isDeleted()) continue;
+            auto *sphere = agent->getMorphology()->getBasicSphereOfThis();
+            // Towards the center of the site, i.e. inside of the grid
+            auto direction = sphere->getPosition() * -1.0;
+            direction.setMagnitude(1.0);
+            const auto position = sphere->getPosition() + direction * distance;
+            if (!locator->hasCollision(position, distance - sphere->getRadius() + 1e-6)) ++missed;
+        }
+    }, [](Site &, double current_time) { return current_time > 0; });
+    return missed;
+}
+
+bool abm::test::test_quiescent_cell(const std::string &config, const std::function<void(Cell &, Site &, double)> &check) {
+    // Event driven transitions and quiescent agents are switched on as command line inputs of the site, conidia swell
+    // slowly (rate 0.02) to rest on the AECs for many steps
+    const std::unordered_map<std::string, std::string> input_args{{"eventDriven", "1"}, {"quiescent", "1"}, {"swell", "0.02"}};
+    bool checked = false;
+    const auto find_cell = [&check, &checked](Site &site, double current_time) {
+        for (const auto &agent: site.getAgentManager()->getAllAgents()) {
+            auto *cell = dynamic_cast<Cell *>(agent.get());
+            const auto trials = cell->getCurrentCellState()->getTrialsUntilTransition();
+            if (cell->isQuiescent() && trials >= 2 && trials != std::numeric_limits<unsigned long>::max()) {
+                check(*cell, site, current_time);
+                checked = true;
+                return true;
+            }
+        }
+        return false;
+    };
+    // The sampled steps of the transitions depend on the seed
+    for (int seed = 1; seed <= 20 && !checked; ++seed) {
+        run_simulation(config, seed, [](Site &, double) {}, find_cell, input_args);
+    }
+    return checked;
+}
+
+int abm::test::test_agent_quantities(const std::string &config) {
+    int differing_steps = 0;
+    // Types that left the list completely are still compared
+    std::set<std::string> types{};
+    const auto compare = [&differing_steps, &types](Site &site, double) {
+        auto *agent_manager = site.getAgentManager();
+        std::map<std::string, int> scanned{};
+        for (const auto &agent: agent_manager->getAllAgents()) {
+            types.insert(agent->getTypeName());
+            if (agent->getCurrentCellState()->getStateName() != "Death") ++scanned[agent->getTypeName()];
+        }
+        for (const auto &type: types) {
+            if (agent_manager->getAgentQuantity(type) != scanned[type]) {
+                ++differing_steps;
+                break;
+            }
+        }
+    };
+    run_simulation(config, std::nullopt, compare, [&compare](Site &site, double current_time) {
+        compare(site, current_time);
+        return false;
+    });
+    return differing_steps;
 }
 
 TEST_CASE ("Test Simulator Configuration") {
@@ -68,5 +229,94 @@ TEST_CASE ("Test Simulator Alveolus Configuration") {
     path config("../../test/configurations/testSimulatorAlveolus/config.json");
     CHECK(exists(config) == true);
     const auto string_return = abm::test::test_simulation(config.string());
-    CHECK(string_return == "17733938994651597134");
-}
\ No newline at end of file
+    CHECK(string_return == "17239350451186276927");
+}
+
+TEST_CASE ("Test Agent Quantities") {
+    std::cout << "Start agent quantities test ...\n";
+    // Counters of the component store have to match the agent list while agents are spawned, replaced and removed
+    for (const auto &config: {path("../../test/configurations/testSimulator/config.json"),
+                              path("../../test/configurations/testSimulatorAlveolus/config.json")}) {
+        CHECK(exists(config) == true);
+        CHECK(abm::test::test_agent_quantities(config.string()) == 0);
+    }
+}
+
+TEST_CASE ("Test Quiescent Agents Countdown") {
+    std::cout << "Start quiescent agents countdown test ...\n";
+    // A static cell without interactions is skipped until the sampled step of its next transition, then it is woken
+    path config("../../test/configurations/testSimulatorAlveolus/config.json");
+    CHECK(exists(config) == true);
+    const auto checked = abm::test::test_quiescent_cell(config.string(), [](Cell &cell, Site &site, double current_time) {
+        const auto timestep = site.getTimeStepping();
+        const auto trials = cell.getCurrentCellState()->getTrialsUntilTransition();
+        const auto state = cell.getCurrentCellState()->getStateId();
+        const auto position = cell.getPosition();
+        auto time = current_time;
+        for (unsigned long step = 1; step < trials; ++step) {
+            time += timestep;
+            cell.doAllActionsForTimestep(timestep, time);
+            CHECK(cell.isQuiescent());
+            CHECK(cell.getCurrentCellState()->getStateId() == state);
+            CHECK(cell.getCurrentCellState()->getTrialsUntilTransition() == trials - step);
+        }
+        CHECK(cell.getPosition().calculateEuclidianDistance(position) == 0.0);
+        time += timestep;
+        cell.doAllActionsForTimestep(timestep, time);
+        CHECK(cell.getCurrentCellState()->getStateId() != state);
+    });
+    CHECK(checked);
+}
+
+TEST_CASE ("Test Quiescent Agents Interaction") {
+    std::cout << "Start quiescent agents interaction test ...\n";
+    // A new interaction wakes a quiescent cell before its sampled transition
+    path config("../../test/configurations/testSimulatorAlveolus/config.json");
+    CHECK(exists(config) == true);
+    const auto checked = abm::test::test_quiescent_cell(config.string(), [](Cell &cell, Site &site, double current_time) {
+        Cell *other = nullptr;
+        for (const auto &agent: site.getAgentManager()->getAllAgents()) {
+            if (agent.get() != &cell) other = dynamic_cast<Cell *>(agent.get());
+        }
+        REQUIRE(other != nullptr);
+        const auto timestep = site.getTimeStepping();
+        cell.getInteractions()->addInteraction(
+                std::make_shared<Interaction>("TestInteraction", &cell, other, timestep, current_time));
+        CHECK(!cell.isQuiescent());
+    });
+    CHECK(checked);
+}
+
+TEST_CASE ("Test Parallel Agent Updates with ODE Engine") {
+    std::cout << "Start parallel ODE engine test ...\n";
+    // The intracellular models of the agents must not depend on the threads that update the tiles
+    path config("../../test/configurations/testSimulatorAlveolus/config.json");
+    CHECK(exists(config) == true);
+    const std::unordered_map<std::string, std::string> input_args{{"odeEngine", "1"}, {"parallel", "1"}};
+    const auto serial_hash = abm::test::test_simulation(config.string(), 1, input_args);
+    CHECK(abm::test::test_simulation(config.string(), 3, input_args) == serial_hash);
+    CHECK(abm::test::test_simulation(config.string(), 4, input_args) == serial_hash);
+}
+
+TEST_CASE ("Test Demand Driven Diffusion") {
+    std::cout << "Start demand driven diffusion test ...\n";
+    // Without AMs the steps of the field are deferred, AMs that enter later have to see and change the same field as
+    // if every step was applied
+    path config("../../test/configurations/testSimulatorAlveolus/config.json");
+    CHECK(exists(config) == true);
+    std::unordered_map<std::string, std::string> input_args{{"icNum", "0"}, {"icInput", "0.2"}, {"demandDriven", "1"}};
+    const auto deferred = abm::test::test_molecule_field(config.string(), input_args);
+    input_args["demandDriven"] = "0";
+    CHECK(abm::test::test_molecule_field(config.string(), input_args) == deferred);
+}
+
+TEST_CASE ("Test Boundary Placement Precheck") {
+    std::cout << "Start boundary placement precheck test ...\n";
+    path config("../../test/configurations/testSimulatorAlveolus/config.json");
+    CHECK(exists(config) == true);
+    const auto [inserted, colliding] = abm::test::test_boundary_placement(config.string());
+    CHECK(inserted > 0);
+    CHECK(colliding == 0);
+    // The grid neighbourhood of the precheck grows with the radius of the candidate
+    CHECK(abm::test::test_collision_reach(config.string()) == 0);
+}
@@ -11,8 +11,27 @@
 #ifndef TESTCONFIGURATIONS_H
 #define TESTCONFIGURATIONS_H
 
+#include <functional>
 #include <string>
+#include <unordered_map>
+#include <utility>
+
+class Cell;
+class Site;
 namespace abm::test {
 std::string test_simulation(const std::string &config);
+/// Runs a configuration with a number of threads and command line inputs of the site, returns the hash of the agents
+std::string test_simulation(const std::string &config, int number_of_threads,
+                            const std::unordered_map<std::string, std::string> &input_args);
+/// Runs a configuration with command line inputs of the site, returns the hash of the agents and the molecule field
+std::string test_molecule_field(const std::string &config, const std::unordered_map<std::string, std::string> &input_args);
+/// Runs a configuration with the boundary placement precheck, returns the inserted agents and the ones that collide
+std::pair<int, int> test_boundary_placement(const std::string &config);
+/// Number of agents that hasCollision does not find from a candidate position 2.5 grid constants away
+int test_collision_reach(const std::string &config);
+/// Runs a configuration with quiescent agents until a cell sleeps for at least 2 steps and checks it, false if none did
+bool test_quiescent_cell(const std::string &config, const std::function<void(Cell &, Site &, double)> &check);
+/// Runs a configuration, returns the number of steps in which the agent quantities differ from a scan of the agent list
+int test_agent_quantities(const std::string &config);
 }
 #endif /* TESTCONFIGURATIONS_H */